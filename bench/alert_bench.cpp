@@ -0,0 +1,150 @@
+// ================================================================================
+// ================================================================================
+// - File:    alert_bench.cpp
+// - Purpose: AlertEngine at planner scale: seeding the timing wheel from
+//            the table, schedule and cancel throughput with every task's
+//            alerts pending, and firing over a stretch of simulated time.
+//            Jitter is how long after its tick starts each alert reaches
+//            the callback; every alert is also checked to fire on its own
+//            minute.
+//
+// Usage: alert_bench [rows] [lead_minutes,...] [days]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/alert_engine.hpp"
+#include "bench_util.hpp"
+#include "generator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static double elapsed_seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+// --------------------------------------------------------------------------------
+
+static std::vector<int> parse_leads(const std::string& text)
+{
+    std::vector<int> leads;
+    std::stringstream fields(text);
+    std::string field;
+    while (std::getline(fields, field, ',')) {
+        leads.push_back(std::stoi(field));
+    }
+    return leads;
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    size_t rows = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    std::vector<int> leads = parse_leads(argc > 2 ? argv[2] : "0,60,1440");
+    int days = argc > 3 ? std::stoi(argv[3]) : 30;
+
+    DBOptions db_options;
+    db_options.quiet = true;
+
+    std::string filename{"alert_bench.db"};
+    std::remove(filename.c_str());
+
+    DB db(filename, db_options);
+    db.createPlanner();
+    PlannerGenerator generator;
+    if (generator.fill(db, rows) != 0) {
+        std::cerr << "Error generating " << rows << " rows" << std::endl;
+        return 1;
+    }
+
+    // The generator's "today" is 2026-10-18; start the clock just before it
+    int64_t start_minute = due_key_to_minutes(parse_due_key("2026-10-18")) - 1;
+    int64_t expected_minute = start_minute;
+    size_t fired = 0, wrong_minute = 0;
+    LatencyRecorder jitter;
+    std::chrono::steady_clock::time_point tick_start;
+    auto on_alert = [&](const Alert& alert) {
+        jitter.record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tick_start).count());
+        fired++;
+        if (alert.minute != expected_minute || due_key_to_minutes(alert.due_key) - alert.lead_minutes != alert.minute)
+            wrong_minute++;
+    };
+
+    AlertOptions options;
+    options.lead_minutes = leads;
+    auto seed_start = std::chrono::steady_clock::now();
+    AlertEngine engine(db, on_alert, start_minute, options);
+    double seed_seconds = elapsed_seconds(seed_start);
+    size_t pending = engine.pending();
+    std::printf("rows: %zu, leads: %zu, pending alerts: %zu, seeded in %.3f s (%.0f tasks/sec), peak RSS %ld KiB\n",
+                rows, leads.size(), pending, seed_seconds, static_cast<double>(rows) / seed_seconds, peak_rss_kb());
+
+    // Reschedule random tasks anywhere in the next year: cancel plus one
+    // schedule per lead
+    SplitMix64 rng(7);
+    size_t operations = rows;
+    std::vector<int> ids(operations);
+    std::vector<DueKey> keys(operations);
+    int64_t today_days = (start_minute + 1) / 1440;
+    for (size_t i = 0; i < operations; i++) {
+        ids[i] = 1 + static_cast<int>(rng.below(rows));
+        keys[i] = due_key_from_days(today_days + static_cast<int64_t>(rng.below(365)),
+                                    static_cast<int>(rng.below(24)), static_cast<int>(rng.below(60)));
+    }
+    auto schedule_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; i++) {
+        engine.schedule(ids[i], keys[i]);
+    }
+    double schedule_seconds = elapsed_seconds(schedule_start);
+
+    auto cancel_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations / 2; i++) {
+        engine.cancel(ids[i]);
+    }
+    double cancel_seconds = elapsed_seconds(cancel_start);
+    for (size_t i = 0; i < operations / 2; i++) {
+        engine.schedule(ids[i], keys[i]);
+    }
+    std::printf("schedule: %.0f tasks/sec (%.0f ns each), cancel: %.0f tasks/sec (%.0f ns each), pending %zu\n",
+                static_cast<double>(operations) / schedule_seconds, schedule_seconds * 1e9 / static_cast<double>(operations),
+                static_cast<double>(operations / 2) / cancel_seconds,
+                cancel_seconds * 1e9 / static_cast<double>(operations / 2), engine.pending());
+
+    // One advance per simulated minute, as a watcher polling the clock would
+    LatencyRecorder ticks;
+    int64_t end_minute = start_minute + static_cast<int64_t>(days) * 1440;
+    auto fire_start = std::chrono::steady_clock::now();
+    while (expected_minute < end_minute) {
+        expected_minute++;
+        tick_start = std::chrono::steady_clock::now();
+        engine.advance(expected_minute);
+        ticks.record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tick_start).count());
+    }
+    double fire_seconds = elapsed_seconds(fire_start);
+    std::printf("fired %zu alerts over %d days in %.3f s (%.0f alerts/sec), %zu on the wrong minute, %zu still pending\n",
+                fired, days, fire_seconds, static_cast<double>(fired) / fire_seconds, wrong_minute, engine.pending());
+
+    std::vector<BenchResult> results;
+    results.push_back(make_result("tick", rows, fired, ticks));
+    results.push_back(make_result("alert jitter", rows, 0, jitter));
+    write_results_text(std::cout, results);
+
+    db.closeDB();
+    std::remove(filename.c_str());
+    return wrong_minute == 0 ? 0 : 1;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
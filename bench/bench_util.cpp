@@ -0,0 +1,154 @@
+// ================================================================================
+// ================================================================================
+// - File:    bench_util.cpp
+// - Purpose: Shared helpers for the benchmark suite.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "bench_util.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+// ================================================================================
+// ================================================================================
+
+void LatencyRecorder::start()
+{
+    started = std::chrono::steady_clock::now();
+}
+// --------------------------------------------------------------------------------
+
+void LatencyRecorder::stop()
+{
+    record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count());
+}
+// --------------------------------------------------------------------------------
+
+void LatencyRecorder::record(double microseconds)
+{
+    samples_us.push_back(microseconds);
+}
+// --------------------------------------------------------------------------------
+
+void LatencyRecorder::merge(const LatencyRecorder& other)
+{
+    samples_us.insert(samples_us.end(), other.samples_us.begin(), other.samples_us.end());
+}
+// --------------------------------------------------------------------------------
+
+size_t LatencyRecorder::count() const
+{
+    return samples_us.size();
+}
+// --------------------------------------------------------------------------------
+
+double LatencyRecorder::total_us() const
+{
+    double total = 0.0;
+    for (double sample : samples_us) {
+        total += sample;
+    }
+    return total;
+}
+// --------------------------------------------------------------------------------
+
+double LatencyRecorder::percentile(double p)
+{
+    if (samples_us.empty())
+        return 0.0;
+    std::sort(samples_us.begin(), samples_us.end());
+    size_t index = static_cast<size_t>(p * (samples_us.size() - 1) + 0.5);
+    return samples_us[std::min(index, samples_us.size() - 1)];
+}
+// --------------------------------------------------------------------------------
+
+long peak_rss_kb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+// --------------------------------------------------------------------------------
+
+BenchResult make_result(const std::string& operation, size_t planner_size, uint64_t items,
+                        LatencyRecorder& latencies)
+{
+    BenchResult result;
+    result.operation = operation;
+    result.planner_size = planner_size;
+    result.operations = latencies.count();
+    result.items = items;
+    result.seconds = latencies.total_us() / 1e6;
+    result.p50_us = latencies.percentile(0.50);
+    result.p90_us = latencies.percentile(0.90);
+    result.p99_us = latencies.percentile(0.99);
+    result.p999_us = latencies.percentile(0.999);
+    result.max_us = latencies.percentile(1.0);
+    result.peak_rss_kb = peak_rss_kb();
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+static double throughput(const BenchResult& result)
+{
+    return result.seconds > 0.0 ? result.items / result.seconds : 0.0;
+}
+// --------------------------------------------------------------------------------
+
+void write_results_json(std::ostream& out, const std::string& version, uint64_t seed,
+                        const std::vector<BenchResult>& results)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"version\": \"" << version << "\",\n  \"seed\": " << seed << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"operation\": \"" << r.operation << "\", \"planner_size\": " << r.planner_size
+            << ", \"operations\": " << r.operations << ", \"items\": " << r.items
+            << ", \"seconds\": " << r.seconds << ", \"items_per_sec\": " << throughput(r)
+            << ", \"p50_us\": " << r.p50_us << ", \"p90_us\": " << r.p90_us
+            << ", \"p99_us\": " << r.p99_us << ", \"p999_us\": " << r.p999_us
+            << ", \"max_us\": " << r.max_us << ", \"peak_rss_kb\": " << r.peak_rss_kb << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+// --------------------------------------------------------------------------------
+
+void write_results_csv(std::ostream& out, const std::vector<BenchResult>& results)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "operation,planner_size,operations,items,seconds,items_per_sec,"
+           "p50_us,p90_us,p99_us,p999_us,max_us,peak_rss_kb\n";
+    for (const BenchResult& r : results) {
+        out << r.operation << ',' << r.planner_size << ',' << r.operations << ',' << r.items << ','
+            << r.seconds << ',' << throughput(r) << ',' << r.p50_us << ',' << r.p90_us << ','
+            << r.p99_us << ',' << r.p999_us << ',' << r.max_us << ',' << r.peak_rss_kb << '\n';
+    }
+}
+// --------------------------------------------------------------------------------
+
+void write_results_text(std::ostream& out, const std::vector<BenchResult>& results)
+{
+    out << std::fixed << std::setprecision(1);
+    out << std::left << std::setw(18) << "operation" << std::right << std::setw(10) << "size"
+        << std::setw(14) << "items/s" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+        << std::setw(12) << "p99.9 us" << std::setw(12) << "rss MiB" << '\n';
+    for (const BenchResult& r : results) {
+        out << std::left << std::setw(18) << r.operation << std::right << std::setw(10) << r.planner_size
+            << std::setw(14) << throughput(r) << std::setw(12) << r.p50_us << std::setw(12) << r.p99_us
+            << std::setw(12) << r.p999_us << std::setw(12) << r.peak_rss_kb / 1024.0 << '\n';
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
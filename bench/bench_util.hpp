@@ -0,0 +1,82 @@
+// ================================================================================
+// ================================================================================
+// - File:    bench_util.hpp
+// - Purpose: Shared helpers for the benchmark suite: latency recording with
+//            percentiles, peak RSS, and JSON/CSV/text result output.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef BENCH_UTIL_HPP
+#define BENCH_UTIL_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+// --------------------------------------------------------------------------------
+
+class LatencyRecorder
+{
+    private:
+
+        std::vector<double> samples_us;
+        std::chrono::steady_clock::time_point started;
+// ================================================================================
+
+    public:
+
+        void start();
+        void stop();
+        void record(double microseconds);
+        void merge(const LatencyRecorder& other);
+        size_t count() const;
+        double total_us() const;
+
+        // p in [0, 1]; sorts the samples on first use.
+        double percentile(double p);
+};
+// --------------------------------------------------------------------------------
+
+struct BenchResult {
+    std::string operation;
+    size_t planner_size;
+    uint64_t operations;        // calls measured
+    uint64_t items;             // rows touched across all calls
+    double seconds;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+    long peak_rss_kb;
+};
+// --------------------------------------------------------------------------------
+
+// Process high-water mark of resident memory, in KiB.
+long peak_rss_kb();
+// --------------------------------------------------------------------------------
+
+BenchResult make_result(const std::string& operation, size_t planner_size, uint64_t items,
+                        LatencyRecorder& latencies);
+// --------------------------------------------------------------------------------
+
+void write_results_json(std::ostream& out, const std::string& version, uint64_t seed,
+                        const std::vector<BenchResult>& results);
+// --------------------------------------------------------------------------------
+
+void write_results_csv(std::ostream& out, const std::vector<BenchResult>& results);
+// --------------------------------------------------------------------------------
+
+void write_results_text(std::ostream& out, const std::vector<BenchResult>& results);
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
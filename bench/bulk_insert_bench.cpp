@@ -0,0 +1,100 @@
+// ================================================================================
+// ================================================================================
+// - File:    bulk_insert_bench.cpp
+// - Purpose: Compares the per-row insert path against the transactional
+//            DB::bulkInsertTasks path and reports rows/sec for each.
+//
+// Usage: bulk_insert_bench [rows] [legacy_rows] [batch_size]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/db.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static std::vector<Task> make_tasks(int count)
+{
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    for (int i = 0; i < count; i++) {
+        char due_date[11];
+        std::snprintf(due_date, sizeof(due_date), "%04d-%02d-%02d",
+                      2024 + (i % 5), 1 + (i % 12), 1 + (i % 28));
+        tasks.push_back(Task{"Benchmark task " + std::to_string(i), due_date});
+    }
+    return tasks;
+}
+// --------------------------------------------------------------------------------
+
+static double rows_per_second(int rows, std::chrono::steady_clock::duration elapsed)
+{
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? rows / seconds : 0.0;
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    int rows = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int legacy_rows = argc > 2 ? std::stoi(argv[2]) : 2000;
+    int batch_size = argc > 3 ? std::stoi(argv[3]) : 0;
+
+    std::string legacy_file{"bulk_insert_bench_legacy.db"};
+    std::string bulk_file{"bulk_insert_bench_bulk.db"};
+    std::remove(legacy_file.c_str());
+    std::remove(bulk_file.c_str());
+
+    // The per-row path prints for every insert, keep that off the terminal
+    std::ostringstream sink;
+    std::streambuf* cout_buf = std::cout.rdbuf(sink.rdbuf());
+
+    double legacy_rate = 0.0;
+    double bulk_rate = 0.0;
+    {
+        DB db(legacy_file);
+        db.createPlanner();
+        std::vector<Task> tasks = make_tasks(legacy_rows);
+        auto start = std::chrono::steady_clock::now();
+        for (auto& task : tasks) {
+            db.insertTask(task.task, task.due_date);
+        }
+        legacy_rate = rows_per_second(legacy_rows, std::chrono::steady_clock::now() - start);
+    }
+    {
+        DB db(bulk_file);
+        db.createPlanner();
+        std::vector<Task> tasks = make_tasks(rows);
+        auto start = std::chrono::steady_clock::now();
+        db.bulkInsertTasks(tasks, batch_size);
+        bulk_rate = rows_per_second(rows, std::chrono::steady_clock::now() - start);
+    }
+
+    std::cout.rdbuf(cout_buf);
+    std::remove(legacy_file.c_str());
+    std::remove(bulk_file.c_str());
+
+    std::cout << "per-row insertTask : " << legacy_rows << " rows, "
+              << static_cast<long>(legacy_rate) << " rows/sec\n";
+    std::cout << "bulkInsertTasks    : " << rows << " rows (batch size "
+              << batch_size << "), " << static_cast<long>(bulk_rate) << " rows/sec\n";
+    if (legacy_rate > 0.0) {
+        std::cout << "speedup            : " << bulk_rate / legacy_rate << "x\n";
+    }
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
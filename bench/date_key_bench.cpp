@@ -0,0 +1,128 @@
+// ================================================================================
+// ================================================================================
+// - File:    date_key_bench.cpp
+// - Purpose: Microbenchmark of the previous std::get_time + std::tm compare
+//            path against parse_due_key + a single integer compare.
+//
+// Usage: date_key_bench [dates]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/date_key.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// The parse and comparison PriorityQueue used before DUE_KEY existed
+static std::tm legacy_parse(const std::string& due_date)
+{
+    std::tm datetime{};
+    std::stringstream ss(due_date);
+    ss >> std::get_time(&datetime, "%Y-%m-%d");
+    return datetime;
+}
+// --------------------------------------------------------------------------------
+
+static bool legacy_less(const std::tm& tm1, const std::tm& tm2)
+{
+    if (tm1.tm_year < tm2.tm_year)
+        return true;
+    else if (tm1.tm_year > tm2.tm_year)
+        return false;
+
+    if (tm1.tm_mon < tm2.tm_mon)
+        return true;
+    else if (tm1.tm_mon > tm2.tm_mon)
+        return false;
+
+    if (tm1.tm_mday < tm2.tm_mday)
+        return true;
+    else if (tm1.tm_mday > tm2.tm_mday)
+        return false;
+
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    int count = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    std::vector<std::string> dates;
+    dates.reserve(count);
+    unsigned seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        char buffer[11];
+        std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u",
+                      1990 + (seed >> 8) % 60, 1 + (seed >> 16) % 12, 1 + (seed >> 4) % 28);
+        dates.emplace_back(buffer);
+    }
+
+    // Parse
+    std::vector<std::tm> legacy(count);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        legacy[i] = legacy_parse(dates[i]);
+    }
+    double legacy_parse_s = seconds_since(start);
+
+    std::vector<DueKey> keys(count);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++) {
+        keys[i] = parse_due_key(dates[i]);
+    }
+    double key_parse_s = seconds_since(start);
+
+    std::vector<std::string_view> texts(dates.begin(), dates.end());
+    std::vector<DateError> errors;
+    start = std::chrono::steady_clock::now();
+    parse_due_keys(texts.data(), texts.size(), keys.data(), errors);
+    double batch_parse_s = seconds_since(start);
+
+    // Compare, through a full sort so both paths do the same comparisons
+    start = std::chrono::steady_clock::now();
+    std::sort(legacy.begin(), legacy.end(), legacy_less);
+    double legacy_sort_s = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    std::sort(keys.begin(), keys.end());
+    double key_sort_s = seconds_since(start);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "dates: " << count << "\n";
+    std::cout << "parse  std::get_time  : " << legacy_parse_s * 1e9 / count << " ns/date\n";
+    std::cout << "parse  parse_due_key  : " << key_parse_s * 1e9 / count << " ns/date\n";
+    std::cout << "parse  parse_due_keys : " << batch_parse_s * 1e9 / count << " ns/date ("
+              << std::thread::hardware_concurrency() << " threads)\n";
+    std::cout << "sort   std::tm fields : " << legacy_sort_s * 1e3 << " ms\n";
+    std::cout << "sort   DueKey         : " << key_sort_s * 1e3 << " ms\n";
+    std::cout << "entry  size           : " << sizeof(std::tm) << " -> " << sizeof(DueKey) << " bytes\n";
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
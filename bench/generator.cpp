@@ -0,0 +1,140 @@
+// ================================================================================
+// ================================================================================
+// - File:    generator.cpp
+// - Purpose: Seeded synthetic planner generator.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "generator.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+
+// ================================================================================
+// ================================================================================
+
+static const char* const VERBS[] = {
+    "Call", "Email", "Review", "Draft", "Pay", "Schedule", "Renew", "Pick up",
+    "Clean", "Fix", "Update", "Submit", "Book", "Order", "Plan", "Finish"
+};
+static const char* const OBJECTS[] = {
+    "dentist", "quarterly report", "electric bill", "car insurance", "groceries",
+    "team notes", "passport", "garden hose", "budget", "library books",
+    "tax return", "birthday gift", "gym membership", "kitchen sink", "slides",
+    "lease", "vet appointment", "expense claim", "blog post", "flight"
+};
+static const char* const QUALIFIERS[] = {
+    "", "", "", " before noon", " for Sam", " again", " (urgent)", " with Alex",
+    " online", " at the office"
+};
+
+template <typename T, size_t N>
+static constexpr uint64_t count_of(T (&)[N]) { return N; }
+
+// ================================================================================
+// ================================================================================
+//   SplitMix64
+// ================================================================================
+
+uint64_t SplitMix64::next()
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+// --------------------------------------------------------------------------------
+
+uint64_t SplitMix64::below(uint64_t bound)
+{
+    // Multiply-shift; the bias is far below anything a benchmark can observe
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+}
+
+// ================================================================================
+// ================================================================================
+//   PlannerGenerator
+// ================================================================================
+
+PlannerGenerator::PlannerGenerator(const GeneratorOptions& options)
+    : options(options), rng(options.seed)
+{
+    DueKey day = options.as_of / 10000;
+    as_of_days = days_from_civil(static_cast<int>(day / 10000), static_cast<int>(day / 100 % 100),
+                                 static_cast<int>(day % 100));
+}
+// --------------------------------------------------------------------------------
+
+DueKey PlannerGenerator::dueKey()
+{
+    uint64_t bucket = rng.below(100);
+    int64_t offset;
+    if (bucket < 15)
+        offset = -1 - static_cast<int64_t>(rng.below(90));
+    else if (bucket < 20)
+        offset = 0;
+    else if (bucket < 65)
+        offset = 1 + static_cast<int64_t>(rng.below(30));
+    else if (bucket < 90)
+        offset = 31 + static_cast<int64_t>(rng.below(335));
+    else
+        offset = 366 + static_cast<int64_t>(rng.below(4 * 365));
+
+    int64_t days = as_of_days + offset;
+    // 1970-01-01 was a Thursday: 0 = Monday ... 6 = Sunday
+    int64_t weekday = ((days % 7) + 7 + 3) % 7;
+    if (weekday >= 5 && rng.below(4) != 0)
+        days += 7 - weekday;
+
+    if (rng.below(5) == 0) {
+        int hour = 8 + static_cast<int>(rng.below(10));
+        int minute = static_cast<int>(rng.below(4)) * 15;
+        return due_key_from_days(days, hour, minute);
+    }
+    return due_key_from_days(days);
+}
+// --------------------------------------------------------------------------------
+
+Task PlannerGenerator::next()
+{
+    std::string text = VERBS[rng.below(count_of(VERBS))];
+    text += ' ';
+    text += OBJECTS[rng.below(count_of(OBJECTS))];
+    text += QUALIFIERS[rng.below(count_of(QUALIFIERS))];
+    return Task{text, format_due_key(dueKey())};
+}
+// --------------------------------------------------------------------------------
+
+std::vector<Task> PlannerGenerator::generate(size_t count)
+{
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        tasks.push_back(next());
+    }
+    return tasks;
+}
+// --------------------------------------------------------------------------------
+
+int PlannerGenerator::fill(DB& db, size_t count)
+{
+    size_t chunk = options.chunk_size > 0 ? static_cast<size_t>(options.chunk_size) : count;
+    for (size_t done = 0; done < count; ) {
+        std::vector<Task> tasks = generate(std::min(chunk, count - done));
+        int rc = db.bulkInsertTasks(tasks);
+        if (rc != SQLITE_OK)
+            return rc;
+        done += tasks.size();
+    }
+    return SQLITE_OK;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
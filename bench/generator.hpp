@@ -0,0 +1,85 @@
+// ================================================================================
+// ================================================================================
+// - File:    generator.hpp
+// - Purpose: Seeded synthetic planner generator. The same seed, size and
+//            reference date always produce the same tasks, on any platform.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include "../src/include/db.hpp"
+#include "../src/include/date_key.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+// --------------------------------------------------------------------------------
+
+// splitmix64; std distributions are implementation defined, so the
+// generator draws from this directly to stay reproducible across libraries.
+class SplitMix64
+{
+    private:
+
+        uint64_t state;
+// ================================================================================
+
+    public:
+
+        explicit SplitMix64(uint64_t seed) : state(seed) {}
+        uint64_t next();
+
+        // Uniform in [0, bound); bound must be non-zero.
+        uint64_t below(uint64_t bound);
+};
+// --------------------------------------------------------------------------------
+
+struct GeneratorOptions {
+    uint64_t seed = 42;
+    DueKey as_of = 202610180000;    // fixed "today", not the wall clock
+    int chunk_size = 50000;         // tasks held in memory per bulk insert
+};
+// --------------------------------------------------------------------------------
+
+class PlannerGenerator
+{
+    private:
+
+        GeneratorOptions options;
+        SplitMix64 rng;
+        int64_t as_of_days;
+// ================================================================================
+
+        DueKey dueKey();
+// ================================================================================
+
+    public:
+
+        explicit PlannerGenerator(const GeneratorOptions& options = GeneratorOptions());
+// --------------------------------------------------------------------------------
+
+        // Due dates are a mixture: ~15% overdue (up to 90 days), ~45% within
+        // 30 days, ~25% within a year, ~10% one to five years out and ~5% on
+        // the reference day itself. Weekend dates mostly slide to Monday and
+        // about a fifth of tasks carry a time of day.
+        Task next();
+// --------------------------------------------------------------------------------
+
+        std::vector<Task> generate(size_t count);
+// --------------------------------------------------------------------------------
+
+        // Streams count tasks into db in chunk_size batches via bulkInsertTasks.
+        int fill(DB& db, size_t count);
+};
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,117 @@
+// ================================================================================
+// ================================================================================
+// - File:    group_commit_bench.cpp
+// - Purpose: Measures write throughput of the group-commit WritePipeline as
+//            the number of concurrent writers grows, against one commit per
+//            mutation (max_batch_size = 1), and prints the batch and commit
+//            latency metrics.
+//
+// Usage: group_commit_bench [writers] [mutations_per_writer] [full|normal|none]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/write_pipeline.hpp"
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static double run(int writers, int per_writer, size_t max_batch_size, Durability durability,
+                  WritePipelineMetrics& metrics)
+{
+    std::string filename{"group_commit_bench.db"};
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((filename + suffix).c_str());
+    }
+
+    DBOptions db_options;
+    db_options.wal = true;
+    db_options.quiet = true;
+    DB db(filename, db_options);
+    db.createPlanner();
+
+    WritePipelineOptions options;
+    options.max_batch_size = max_batch_size;
+    options.durability = durability;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        WritePipeline pipeline(db, options);
+        std::vector<std::thread> threads;
+        for (int w = 0; w < writers; w++) {
+            threads.emplace_back([&pipeline, w, per_writer] {
+                for (int i = 0; i < per_writer; i++) {
+                    // Each writer waits for its own commit, like a request handler
+                    pipeline.insertTask("Writer " + std::to_string(w), "2025-01-01").get();
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        metrics = pipeline.metrics();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    db.closeDB();
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((filename + suffix).c_str());
+    }
+    return writers * per_writer / seconds;
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    int max_writers = argc > 1 ? std::stoi(argv[1]) : 16;
+    int per_writer = argc > 2 ? std::stoi(argv[2]) : 200;
+    std::string level = argc > 3 ? argv[3] : "full";
+    Durability durability = level == "none" ? Durability::None
+                          : level == "normal" ? Durability::Normal : Durability::Full;
+
+    std::ostringstream sink;
+    std::streambuf* cout_buf = std::cout.rdbuf(sink.rdbuf());
+    std::vector<std::string> lines;
+
+    for (int writers = 1; writers <= max_writers; writers *= 2) {
+        WritePipelineMetrics single{};
+        WritePipelineMetrics grouped{};
+        double single_rate = run(writers, per_writer, 1, durability, single);
+        double grouped_rate = run(writers, per_writer, 256, durability, grouped);
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1)
+             << std::setw(7) << writers
+             << std::setw(14) << single_rate
+             << std::setw(14) << grouped_rate
+             << std::setw(12) << static_cast<double>(grouped.mutations) / grouped.batches
+             << std::setw(14) << grouped.total_commit_us / grouped.batches
+             << std::setw(14) << grouped.max_commit_us;
+        lines.push_back(line.str());
+    }
+
+    std::cout.rdbuf(cout_buf);
+    std::cout << "durability: " << level << ", mutations per writer: " << per_writer << "\n";
+    std::cout << "writers  1/commit ops/s  grouped ops/s  avg batch  avg commit us  max commit us\n";
+    for (const std::string& line : lines) {
+        std::cout << line << "\n";
+    }
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
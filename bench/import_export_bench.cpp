@@ -0,0 +1,109 @@
+// ================================================================================
+// ================================================================================
+// - File:    import_export_bench.cpp
+// - Purpose: Exports a seeded planner in each data format and imports it
+//            back into an empty one, reporting rows/sec and MB/sec for both
+//            directions.
+//
+// Usage: import_export_bench [rows] [seed] [batch_size]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/db.hpp"
+#include "../src/include/import_export.hpp"
+#include "generator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+// ================================================================================
+// ================================================================================
+
+static double per_second(double amount, std::chrono::steady_clock::duration elapsed)
+{
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? amount / seconds : 0.0;
+}
+// --------------------------------------------------------------------------------
+
+static double file_megabytes(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<double>(info.st_size) / (1024.0 * 1024.0) : 0.0;
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    size_t rows = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    uint64_t seed = argc > 2 ? std::stoull(argv[2]) : 42;
+    size_t batch_size = argc > 3 ? std::stoull(argv[3]) : ImportOptions().batch_size;
+
+    DBOptions db_options;
+    db_options.quiet = true;
+
+    std::string source_file{"import_export_bench_source.db"};
+    std::string target_file{"import_export_bench_target.db"};
+    std::remove(source_file.c_str());
+
+    DB source(source_file, db_options);
+    source.createPlanner();
+    GeneratorOptions generator_options;
+    generator_options.seed = seed;
+    PlannerGenerator generator(generator_options);
+    if (generator.fill(source, rows) != 0) {
+        std::cerr << "Error generating " << rows << " rows" << std::endl;
+        return 1;
+    }
+
+    std::printf("%-8s %-8s %14s %10s %10s\n", "format", "stage", "rows/sec", "MB/sec", "MB");
+    const char* names[] = {"tsv", "csv", "ndjson"};
+    for (const char* name : names) {
+        DataFormat format;
+        parse_data_format(name, format);
+        std::string data_file = std::string("import_export_bench.") + name;
+
+        uint64_t exported = 0;
+        auto start = std::chrono::steady_clock::now();
+        if (export_tasks(source, data_file, format, &exported) != 0)
+            return 1;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double megabytes = file_megabytes(data_file);
+        std::printf("%-8s %-8s %14.0f %10.1f %10.1f\n", name, "export",
+                    per_second(static_cast<double>(exported), elapsed), per_second(megabytes, elapsed), megabytes);
+
+        std::remove(target_file.c_str());
+        DB target(target_file, db_options);
+        target.createPlanner();
+        ImportOptions options;
+        options.format = format;
+        options.batch_size = batch_size;
+        ImportResult result;
+        start = std::chrono::steady_clock::now();
+        if (import_tasks(target, data_file, options, result) != 0) {
+            std::cerr << "Error importing " << data_file << " (line " << result.error_line << "): "
+                      << result.error << std::endl;
+            return 1;
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("%-8s %-8s %14.0f %10.1f %10.1f\n", name, "import",
+                    per_second(static_cast<double>(result.rows), elapsed), per_second(megabytes, elapsed), megabytes);
+
+        std::remove(data_file.c_str());
+    }
+
+    std::remove(target_file.c_str());
+    std::remove(source_file.c_str());
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,237 @@
+// ================================================================================
+// ================================================================================
+// - File:    planner_bench.cpp
+// - Purpose: Reproducible benchmark suite. Builds seeded synthetic planners of
+//            each requested size and measures bulkInsertTasks, db_to_vector,
+//            both next_task variants, printPlanner and completeTask, reporting
+//            throughput, latency percentiles and peak RSS.
+//
+// Usage: planner_bench [--sizes 1000,100000,...] [--seed N] [--label NAME]
+//                      [--format json|csv|text] [--out FILE] [--db FILE]
+//
+// Peak RSS is the process high-water mark, so run one size per process when
+// comparing memory between versions.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/db.hpp"
+#include "../src/include/min_heap.hpp"
+#include "bench_util.hpp"
+#include "generator.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Swallows everything; stands in for the terminal under printPlanner.
+class NullBuffer : public std::streambuf
+{
+    protected:
+
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+// --------------------------------------------------------------------------------
+
+struct SuiteOptions {
+    std::vector<size_t> sizes{1000, 10000, 100000};
+    uint64_t seed = 42;
+    std::string label = "dev";
+    std::string format = "text";
+    std::string out;
+    std::string db_file = "planner_bench.db";
+};
+// --------------------------------------------------------------------------------
+
+static std::vector<size_t> parse_sizes(const std::string& list)
+{
+    std::vector<size_t> sizes;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty())
+            sizes.push_back(std::stoull(item));
+    }
+    return sizes;
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_args(int argc, char** argv, SuiteOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--sizes")
+            options.sizes = parse_sizes(value);
+        else if (arg == "--seed")
+            options.seed = std::stoull(value);
+        else if (arg == "--label")
+            options.label = value;
+        else if (arg == "--format")
+            options.format = value;
+        else if (arg == "--out")
+            options.out = value;
+        else if (arg == "--db")
+            options.db_file = value;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.format != "json" && options.format != "csv" && options.format != "text") {
+        std::cerr << "Unknown format " << options.format << std::endl;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+// Enough repetitions of a whole-table operation to smooth out small planners
+// without making the 10M run take all day.
+static int repetitions(size_t size)
+{
+    return static_cast<int>(std::clamp<size_t>(2000000 / std::max<size_t>(size, 1), 3, 200));
+}
+// --------------------------------------------------------------------------------
+
+static void run_size(const SuiteOptions& options, size_t size, std::vector<BenchResult>& results)
+{
+    std::remove(options.db_file.c_str());
+    DB db(options.db_file);
+    db.createPlanner();
+
+    GeneratorOptions generator_options;
+    generator_options.seed = options.seed;
+    PlannerGenerator generator(generator_options);
+    size_t chunk = static_cast<size_t>(generator_options.chunk_size);
+
+    LatencyRecorder insert;
+    for (size_t done = 0; done < size; ) {
+        std::vector<Task> tasks = generator.generate(std::min(chunk, size - done));
+        insert.start();
+        db.bulkInsertTasks(tasks);
+        insert.stop();
+        done += tasks.size();
+    }
+    results.push_back(make_result("bulkInsertTasks", size, size, insert));
+
+    int reps = repetitions(size);
+    std::vector<PriorityQueue> vec;
+    LatencyRecorder load;
+    for (int i = 0; i < reps; i++) {
+        load.start();
+        vec = db_to_vector(db);
+        load.stop();
+    }
+    results.push_back(make_result("db_to_vector", size, size * reps, load));
+
+    LatencyRecorder next_vector;
+    volatile int next_id = 0;   // keeps the search from being optimised away
+    for (int i = 0; i < reps; i++) {
+        next_vector.start();
+        next_id = next_task(vec).id;
+        next_vector.stop();
+    }
+    (void)next_id;
+    results.push_back(make_result("next_task(vector)", size, size * reps, next_vector));
+
+    LatencyRecorder next_db;
+    TaskRow row;
+    for (int i = 0; i < reps; i++) {
+        next_db.start();
+        next_task(db, row);
+        next_db.stop();
+    }
+    results.push_back(make_result("next_task(DB)", size, size * reps, next_db));
+
+    NullBuffer null_buffer;
+    std::streambuf* cout_buf = std::cout.rdbuf(&null_buffer);
+    LatencyRecorder print;
+    int print_reps = std::max(1, reps / 10);
+    for (int i = 0; i < print_reps; i++) {
+        print.start();
+        db.printPlanner();
+        print.stop();
+    }
+    std::cout.rdbuf(cout_buf);
+    results.push_back(make_result("printPlanner", size, size * print_reps, print));
+
+    // Completes a seeded sample of IDs, spread across the table
+    size_t sample = std::min<size_t>(1000, std::max<size_t>(size / 10, 1));
+    std::vector<int> ids;
+    ids.reserve(vec.size());
+    for (const PriorityQueue& task : vec) {
+        ids.push_back(task.id);
+    }
+    SplitMix64 pick(options.seed ^ size);
+    for (size_t i = 0; i < sample && i < ids.size(); i++) {
+        std::swap(ids[i], ids[i + pick.below(ids.size() - i)]);
+    }
+    ids.resize(std::min(sample, ids.size()));
+
+    cout_buf = std::cout.rdbuf(&null_buffer);
+    LatencyRecorder complete;
+    for (int id : ids) {
+        complete.start();
+        db.completeTask(id);
+        complete.stop();
+    }
+    std::cout.rdbuf(cout_buf);
+    results.push_back(make_result("completeTask", size, ids.size(), complete));
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    SuiteOptions options;
+    if (!parse_args(argc, argv, options))
+        return 1;
+
+    // DB reports progress on std::cout; keep it out of the results
+    NullBuffer null_buffer;
+    std::streambuf* cout_buf = std::cout.rdbuf(&null_buffer);
+
+    std::vector<BenchResult> results;
+    for (size_t size : options.sizes) {
+        run_size(options, size, results);
+        std::remove(options.db_file.c_str());
+    }
+    std::cout.rdbuf(cout_buf);
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out);
+        if (!file) {
+            std::cerr << "Error opening " << options.out << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.out.empty() ? std::cout : file;
+    if (options.format == "json")
+        write_results_json(out, options.label, options.seed, results);
+    else if (options.format == "csv")
+        write_results_csv(out, results);
+    else
+        write_results_text(out, results);
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
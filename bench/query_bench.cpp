@@ -0,0 +1,141 @@
+// ================================================================================
+// ================================================================================
+// - File:    query_bench.cpp
+// - Purpose: Compares indexed DB queries (next-N, due range, overdue) against
+//            reading the full table with db_to_vector and filtering in memory.
+//
+// Usage: query_bench [rows] [repeats]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/db.hpp"
+#include "../src/include/min_heap.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static double average_ms(int repeats, const std::function<void()>& body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        body();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+// --------------------------------------------------------------------------------
+
+static void report(const std::string& name, double scan_ms, double indexed_ms)
+{
+    std::cout << std::left << std::setw(12) << name << std::right
+              << " scan+heap " << std::setw(10) << scan_ms << " ms"
+              << "   indexed " << std::setw(10) << indexed_ms << " ms"
+              << "   " << (indexed_ms > 0.0 ? scan_ms / indexed_ms : 0.0) << "x\n";
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    int rows = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    std::string filename{"query_bench.db"};
+    std::remove(filename.c_str());
+
+    std::ostringstream sink;
+    std::streambuf* cout_buf = std::cout.rdbuf(sink.rdbuf());
+
+    DB db(filename);
+    db.createPlanner();
+    {
+        std::vector<Task> tasks;
+        tasks.reserve(rows);
+        unsigned seed = 42;
+        for (int i = 0; i < rows; i++) {
+            seed = seed * 1103515245u + 12345u;
+            char due_date[11];
+            std::snprintf(due_date, sizeof(due_date), "%04u-%02u-%02u",
+                          2020 + (seed >> 8) % 10, 1 + (seed >> 16) % 12, 1 + (seed >> 4) % 28);
+            tasks.push_back(Task{"Task " + std::to_string(i), due_date});
+        }
+        db.bulkInsertTasks(tasks);
+    }
+    std::cout.rdbuf(cout_buf);
+
+    DueKey month_start = parse_due_key("2025-03-01");
+    DueKey month_end = parse_due_key("2025-04-01");
+    DueKey today = parse_due_key("2020-06-01");
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "rows: " << rows << ", repeats: " << repeats << "\n";
+
+    double scan_ms = average_ms(repeats, [&] {
+        std::vector<PriorityQueue> vec = db_to_vector(db);
+        volatile int id = next_task(vec).id;
+        (void)id;
+    });
+    double indexed_ms = average_ms(repeats, [&] {
+        std::vector<TaskRow> result;
+        db.nextTasks(1, result);
+    });
+    report("next", scan_ms, indexed_ms);
+
+    scan_ms = average_ms(repeats, [&] {
+        std::vector<PriorityQueue> vec = db_to_vector(db);
+        std::partial_sort(vec.begin(), vec.begin() + std::min<size_t>(10, vec.size()), vec.end());
+    });
+    indexed_ms = average_ms(repeats, [&] {
+        std::vector<TaskRow> result;
+        db.nextTasks(10, result);
+    });
+    report("next 10", scan_ms, indexed_ms);
+
+    scan_ms = average_ms(repeats, [&] {
+        std::vector<PriorityQueue> result;
+        for (PriorityQueue& item : db_to_vector(db)) {
+            if (item.due_key >= month_start && item.due_key < month_end)
+                result.push_back(std::move(item));
+        }
+        std::sort(result.begin(), result.end());
+    });
+    indexed_ms = average_ms(repeats, [&] {
+        std::vector<TaskRow> result;
+        db.tasksDueBetween(month_start, month_end, result);
+    });
+    report("month range", scan_ms, indexed_ms);
+
+    scan_ms = average_ms(repeats, [&] {
+        std::vector<PriorityQueue> result;
+        for (PriorityQueue& item : db_to_vector(db)) {
+            if (item.due_key < today)
+                result.push_back(std::move(item));
+        }
+        std::sort(result.begin(), result.end());
+    });
+    indexed_ms = average_ms(repeats, [&] {
+        std::vector<TaskRow> result;
+        db.overdueTasks(today, result);
+    });
+    report("overdue", scan_ms, indexed_ms);
+
+    db.closeDB();
+    std::remove(filename.c_str());
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
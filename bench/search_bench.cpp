@@ -0,0 +1,135 @@
+// ================================================================================
+// ================================================================================
+// - File:    search_bench.cpp
+// - Purpose: Compares DB::searchTasks (FTS5 index, bm25 ranking) against the
+//            old approach of reading every task with db_to_vector and
+//            scanning the descriptions for substrings, for word, phrase,
+//            prefix, multi-word and date-filtered queries.
+//
+// Usage: search_bench [rows] [repeats] [limit]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/db.hpp"
+#include "../src/include/min_heap.hpp"
+#include "generator.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+struct SearchCase {
+    const char* name;
+    const char* query;                  // DB::searchTasks syntax
+    std::vector<std::string> needles;   // lowercase substrings the scan looks for
+    bool ranged;
+};
+// --------------------------------------------------------------------------------
+
+static double average_ms(int repeats, const std::function<void()>& body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        body();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeats;
+}
+// --------------------------------------------------------------------------------
+
+static bool contains_all(const std::string& task, const std::vector<std::string>& needles)
+{
+    std::string lower(task);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const std::string& needle : needles) {
+        if (lower.find(needle) == std::string::npos)
+            return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    size_t rows = argc > 1 ? std::stoull(argv[1]) : 2000000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 5;
+    int limit = argc > 3 ? std::stoi(argv[3]) : 20;
+
+    DBOptions db_options;
+    db_options.quiet = true;
+
+    std::string filename{"search_bench.db"};
+    std::remove(filename.c_str());
+
+    DB db(filename, db_options);
+    db.createPlanner();
+    PlannerGenerator generator;
+    auto load_start = std::chrono::steady_clock::now();
+    if (generator.fill(db, rows) != 0) {
+        std::cerr << "Error generating " << rows << " rows" << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> load_seconds = std::chrono::steady_clock::now() - load_start;
+
+    // The generator's "today" is 2026-10-18; the filter covers the month ahead
+    DueKey from = parse_due_key("2026-10-18");
+    DueKey to = parse_due_key("2026-11-18");
+    std::vector<SearchCase> cases = {
+        {"word", "passport", {"passport"}, false},
+        {"phrase", "\"tax return\"", {"tax return"}, false},
+        {"prefix", "lib*", {"lib"}, false},
+        {"two words", "dentist sam", {"dentist", "sam"}, false},
+        {"word+month", "budget", {"budget"}, true},
+    };
+
+    std::printf("rows: %zu, repeats: %d, limit: %d, load with index: %.0f rows/sec\n",
+                rows, repeats, limit, static_cast<double>(rows) / load_seconds.count());
+    std::printf("%-12s %10s %14s %14s %10s\n", "query", "matches", "scan ms", "fts5 ms", "speedup");
+    for (const SearchCase& search : cases) {
+        size_t matches = 0;
+        double scan_ms = average_ms(repeats, [&] {
+            // No relevance to rank by, so the scan keeps due order
+            std::vector<PriorityQueue> found;
+            for (PriorityQueue& item : db_to_vector(db)) {
+                if (search.ranged && (item.due_key < from || item.due_key >= to))
+                    continue;
+                if (contains_all(item.task, search.needles))
+                    found.push_back(std::move(item));
+            }
+            matches = found.size();
+            size_t keep = std::min<size_t>(static_cast<size_t>(limit), found.size());
+            std::partial_sort(found.begin(), found.begin() + keep, found.end());
+        });
+
+        double fts_ms = average_ms(repeats, [&] {
+            std::vector<TaskRow> result;
+            if (search.ranged)
+                db.searchTasks(search.query, limit, from, to, result);
+            else
+                db.searchTasks(search.query, limit, result);
+        });
+        std::printf("%-12s %10zu %14.3f %14.3f %9.1fx\n", search.name, matches, scan_ms, fts_ms,
+                    fts_ms > 0.0 ? scan_ms / fts_ms : 0.0);
+    }
+
+    db.closeDB();
+    std::remove(filename.c_str());
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,252 @@
+// ================================================================================
+// ================================================================================
+// - File:    server_load_bench.cpp
+// - Purpose: Load generator for the planner server.  Each client keeps a
+//            pipeline of requests in flight against a seeded mix of NEXT,
+//            FIND, RANGE and writes, and the run reports QPS and latency
+//            percentiles per request type.
+//
+// Usage: server_load_bench [--tasks N] [--clients C] [--depth D] [--seconds S]
+//                          [--write-pct P] [--workers W] [--socket PATH]
+//                          [--format text|json|csv]
+//
+// Without --socket a server is started in-process over a fresh planner of
+// N generated tasks; with it, an already running server is measured.
+// Latency is from writing a pipelined batch to reading each answer.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/client.hpp"
+#include "../src/include/date_key.hpp"
+#include "../src/include/server.hpp"
+#include "bench_util.hpp"
+#include "generator.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// ================================================================================
+// ================================================================================
+
+enum RequestKind { NEXT, FIND, RANGE, WRITE, KINDS };
+static const char* const KIND_NAMES[KINDS] = {"NEXT", "FIND", "RANGE", "ADD/COMPLETE"};
+// --------------------------------------------------------------------------------
+
+struct LoadOptions {
+    size_t tasks = 100000;
+    int clients = 8;
+    int depth = 16;
+    double seconds = 5.0;
+    int write_pct = 5;
+    int workers = 4;
+    std::string socket;
+    std::string format = "text";
+};
+// --------------------------------------------------------------------------------
+
+struct ClientResult {
+    LatencyRecorder latencies[KINDS];
+    uint64_t errors = 0;
+};
+// --------------------------------------------------------------------------------
+
+static bool parse_args(int argc, char** argv, LoadOptions& options)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--tasks")
+            options.tasks = std::stoull(value);
+        else if (arg == "--clients")
+            options.clients = std::stoi(value);
+        else if (arg == "--depth")
+            options.depth = std::stoi(value);
+        else if (arg == "--seconds")
+            options.seconds = std::stod(value);
+        else if (arg == "--write-pct")
+            options.write_pct = std::stoi(value);
+        else if (arg == "--workers")
+            options.workers = std::stoi(value);
+        else if (arg == "--socket")
+            options.socket = value;
+        else if (arg == "--format")
+            options.format = value;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return argc % 2 == 1;
+}
+// --------------------------------------------------------------------------------
+
+static void run_client(const LoadOptions& options, int index,
+                       std::chrono::steady_clock::time_point deadline, ClientResult& result)
+{
+    PlannerClient client;
+    if (client.connectTo(options.socket) != 0) {
+        result.errors++;
+        return;
+    }
+
+    SplitMix64 rng(0x5EED0000ULL + static_cast<uint64_t>(index));
+    GeneratorOptions defaults;
+    DueKey as_of_day = defaults.as_of / 10000;
+    int64_t as_of_days = days_from_civil(static_cast<int>(as_of_day / 10000),
+                                         static_cast<int>(as_of_day / 100 % 100),
+                                         static_cast<int>(as_of_day % 100));
+    uint64_t id_bound = options.tasks > 0 ? options.tasks : 1;
+
+    std::vector<RequestKind> kinds(static_cast<size_t>(options.depth));
+    ServerResponse response;
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (RequestKind& kind : kinds) {
+            uint64_t roll = rng.below(100);
+            std::string id = std::to_string(1 + rng.below(id_bound));
+            if (roll < static_cast<uint64_t>(options.write_pct)) {
+                kind = WRITE;
+                if (rng.below(2) == 0)
+                    client.send({"ADD", "Load test task", format_due_key(due_key_from_days(as_of_days + rng.below(60)))});
+                else
+                    client.send({"COMPLETE", id});
+            }
+            else if (roll < 70) {
+                kind = NEXT;
+                client.send({"NEXT"});
+            }
+            else if (roll < 90) {
+                kind = FIND;
+                client.send({"FIND", id});
+            }
+            else {
+                kind = RANGE;
+                int64_t from = as_of_days + static_cast<int64_t>(rng.below(365));
+                client.send({"RANGE", format_due_key(due_key_from_days(from)),
+                             format_due_key(due_key_from_days(from + 1))});
+            }
+        }
+
+        auto sent = std::chrono::steady_clock::now();
+        if (!client.flush()) {
+            result.errors++;
+            return;
+        }
+        for (RequestKind kind : kinds) {
+            if (!client.receive(response)) {
+                result.errors++;
+                return;
+            }
+            // COMPLETE of an already completed ID is an expected answer
+            if (!response.ok && kind != WRITE)
+                result.errors++;
+            result.latencies[kind].record(std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - sent).count());
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    LoadOptions options;
+    if (!parse_args(argc, argv, options))
+        return 1;
+
+    std::string db_file = "server_load_bench.db";
+    std::unique_ptr<DB> db;
+    std::unique_ptr<PlannerServer> server;
+    std::thread server_thread;
+
+    if (options.socket.empty()) {
+        options.socket = "/tmp/planner_load_bench." + std::to_string(getpid()) + ".sock";
+        std::remove(db_file.c_str());
+
+        DBOptions db_options;
+        db_options.quiet = true;
+        db_options.wal = true;
+        db_options.synchronous = "NORMAL";
+        db = std::make_unique<DB>(db_file, db_options);
+        db->createPlanner();
+        PlannerGenerator generator;
+        generator.fill(*db, options.tasks);
+
+        ServerOptions server_options;
+        server_options.workers = options.workers;
+        server = std::make_unique<PlannerServer>(*db, server_options);
+        if (server->listen(options.socket) != 0)
+            return 1;
+        server_thread = std::thread([&server] { server->run(); });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(options.seconds));
+    std::vector<ClientResult> results(static_cast<size_t>(options.clients));
+    std::vector<std::thread> clients;
+    for (int i = 0; i < options.clients; i++) {
+        clients.emplace_back(run_client, std::cref(options), i, deadline, std::ref(results[i]));
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (server) {
+        server->requestStop();
+        server_thread.join();
+        server.reset();
+        db.reset();
+        std::remove(db_file.c_str());
+        std::remove((db_file + "-wal").c_str());
+        std::remove((db_file + "-shm").c_str());
+    }
+
+    LatencyRecorder all;
+    uint64_t errors = 0;
+    std::vector<BenchResult> report;
+    for (int kind = 0; kind < KINDS; kind++) {
+        LatencyRecorder merged;
+        for (ClientResult& result : results) {
+            merged.merge(result.latencies[kind]);
+        }
+        all.merge(merged);
+        if (merged.count() == 0)
+            continue;
+        BenchResult row = make_result(KIND_NAMES[kind], options.tasks, merged.count(), merged);
+        row.seconds = wall_seconds;
+        report.push_back(row);
+    }
+    for (ClientResult& result : results) {
+        errors += result.errors;
+    }
+    BenchResult total = make_result("all", options.tasks, all.count(), all);
+    total.seconds = wall_seconds;
+    report.push_back(total);
+
+    if (options.format == "json")
+        write_results_json(std::cout, "server_load", 0, report);
+    else if (options.format == "csv")
+        write_results_csv(std::cout, report);
+    else {
+        std::cout << options.clients << " clients x " << options.depth << " in flight, "
+                  << options.write_pct << "% writes, " << wall_seconds << " s, "
+                  << errors << " errors\n";
+        write_results_text(std::cout, report);
+    }
+    return errors == 0 ? 0 : 1;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
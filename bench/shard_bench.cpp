@@ -0,0 +1,142 @@
+// ================================================================================
+// ================================================================================
+// - File:    shard_bench.cpp
+// - Purpose: Read and write throughput of ShardedPlanner as the shard count
+//            grows.  For each count the same synthetic planner is spread
+//            over that many files; writer threads then insert for a while
+//            (each waiting for its group commit), and reader threads run
+//            fanned-out next-10 and one-day range queries.
+//
+// Usage: shard_bench [rows] [threads] [seconds] [max_shards] [none|normal|full]
+//
+// Durability full syncs every group commit, so writes wait on the disk the
+// way a production planner's do; that wait overlaps across shards even on
+// a single core.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/sharded_planner.hpp"
+#include "generator.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static std::vector<std::string> shard_files(size_t shards)
+{
+    std::vector<std::string> files;
+    for (size_t i = 0; i < shards; i++) {
+        std::string file = "shard_bench_" + std::to_string(i) + ".db";
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((file + suffix).c_str());
+        }
+        files.push_back(file);
+    }
+    return files;
+}
+// --------------------------------------------------------------------------------
+
+// Runs body(thread, iteration) on threads threads for seconds; returns calls per second.
+template <typename Body>
+static double throughput(int threads, int seconds, Body body)
+{
+    std::atomic<bool> running{true};
+    std::atomic<long> calls{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            long done = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                body(t, done++);
+            }
+            calls += done;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    return calls.load() / static_cast<double>(seconds);
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    size_t rows = argc > 1 ? std::stoull(argv[1]) : 200000;
+    int threads = argc > 2 ? std::stoi(argv[2]) : 8;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 3;
+    size_t max_shards = argc > 4 ? std::stoull(argv[4]) : 8;
+    std::string durability_name = argc > 5 ? argv[5] : "full";
+    Durability durability = durability_name == "none" ? Durability::None
+                          : durability_name == "normal" ? Durability::Normal : Durability::Full;
+
+    std::printf("rows: %zu, threads: %d, %d s per phase, durability %s, %u hardware threads\n", rows, threads,
+                seconds, durability_name.c_str(), std::thread::hardware_concurrency());
+    std::printf("%-7s %14s %9s %14s %9s\n", "shards", "writes/sec", "scaling", "reads/sec", "scaling");
+
+    double base_writes = 0.0, base_reads = 0.0;
+    for (size_t shards = 1; shards <= max_shards; shards *= 2) {
+        std::vector<std::string> files = shard_files(shards);
+        double writes, reads;
+        {
+            ShardedPlannerOptions options;
+            options.store.readers = static_cast<size_t>(threads);
+            options.store.writes.durability = durability;
+            ShardedPlanner planner(files, options);
+            if (planner.status() != SQLITE_OK) {
+                std::cerr << "Error opening " << shards << " shards" << std::endl;
+                return 1;
+            }
+
+            // Same tasks for every shard count, placed by the planner's own routing
+            PlannerGenerator generator;
+            std::vector<std::vector<Task>> parts(shards);
+            for (Task& task : generator.generate(rows)) {
+                parts[planner.shardFor(task.task)].push_back(std::move(task));
+            }
+            for (size_t i = 0; i < shards; i++) {
+                planner.shard(i).write([&parts, i](DB& db) { return db.bulkInsertTasks(parts[i]); }).get();
+            }
+
+            writes = throughput(threads, seconds, [&](int thread, long i) {
+                std::string task = "Bench task " + std::to_string(thread) + "-" + std::to_string(i);
+                planner.insertTask(task, "2026-11-01").get();
+            });
+
+            DueKey day = parse_due_key("2026-10-25");
+            reads = throughput(threads, seconds, [&](int, long i) {
+                std::vector<ShardTaskRow> result;
+                if (i % 4 == 0)
+                    planner.tasksDueBetween(day, day + 10000, result);
+                else
+                    planner.nextTasks(10, result);
+            });
+        }
+
+        if (shards == 1) {
+            base_writes = writes;
+            base_reads = reads;
+        }
+        std::printf("%-7zu %14.0f %8.2fx %14.0f %8.2fx\n", shards, writes, writes / base_writes, reads,
+                    reads / base_reads);
+        std::fflush(stdout);
+        shard_files(shards);
+    }
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
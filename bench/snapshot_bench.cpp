@@ -0,0 +1,131 @@
+// ================================================================================
+// ================================================================================
+// - File:    snapshot_bench.cpp
+// - Purpose: Loads a synthetic planner into a PlannerSnapshot and reports its
+//            memory footprint per million tasks, load time, next-task latency
+//            against the indexed DB query, write-through cost, and a final
+//            consistency check against the file after a burst of mutations.
+//
+// Usage: snapshot_bench [rows] [mutations]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/planner_snapshot.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static std::string make_due_date(unsigned& seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    char due_date[11];
+    std::snprintf(due_date, sizeof(due_date), "%04u-%02u-%02u",
+                  2020 + (seed >> 8) % 10, 1 + (seed >> 16) % 12, 1 + (seed >> 4) % 28);
+    return due_date;
+}
+// --------------------------------------------------------------------------------
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    int rows = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    int mutations = argc > 2 ? std::stoi(argv[2]) : 2000;
+
+    std::string filename{"snapshot_bench.db"};
+    std::remove(filename.c_str());
+
+    std::ostringstream sink;
+    std::streambuf* cout_buf = std::cout.rdbuf(sink.rdbuf());
+
+    DBOptions options;
+    options.quiet = true;
+    DB db(filename, options);
+    db.createPlanner();
+    unsigned seed = 3;
+    {
+        std::vector<Task> tasks;
+        tasks.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            tasks.push_back(Task{"Synthetic planner task number " + std::to_string(i), make_due_date(seed)});
+        }
+        db.bulkInsertTasks(tasks);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    PlannerSnapshot snapshot(db);
+    double load_ms = elapsed_ms(start);
+    size_t bytes = snapshot.memoryUsage();
+
+    // Next task: the head of the due-order index
+    SnapshotRow next{};
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++) {
+        snapshot.next(next);
+    }
+    double snapshot_next_us = elapsed_ms(start) * 1000.0 / 1000;
+
+    std::vector<TaskRow> db_rows;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++) {
+        db_rows.clear();
+        db.nextTasks(1, db_rows);
+    }
+    double db_next_us = elapsed_ms(start) * 1000.0 / 1000;
+
+    // Write-through mutations, committed together
+    start = std::chrono::steady_clock::now();
+    db.beginTransaction();
+    for (int i = 0; i < mutations; i++) {
+        std::string task = "Mutation " + std::to_string(i);
+        std::string due_date = make_due_date(seed);
+        snapshot.insertTask(task, due_date);
+        snapshot.next(next);
+        snapshot.completeTask(next.id);
+        UpdateRow update{"DUE_DATE", make_due_date(seed), "ID", std::to_string(1 + (seed % rows))};
+        snapshot.updatePlanner(update);
+        snapshot.next(next);
+    }
+    db.commitTransaction();
+    double mutation_us = elapsed_ms(start) * 1000.0 / (mutations * 3.0);
+
+    start = std::chrono::steady_clock::now();
+    size_t differences = snapshot.verify(db);
+    double verify_ms = elapsed_ms(start);
+
+    std::cout.rdbuf(cout_buf);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "tasks                : " << snapshot.size() << "\n";
+    std::cout << "load                 : " << load_ms << " ms\n";
+    std::cout << "memory               : " << bytes / (1024.0 * 1024.0) << " MiB, "
+              << static_cast<double>(bytes) / rows << " bytes/task, "
+              << bytes / (1024.0 * 1024.0) * 1e6 / rows << " MiB per million tasks\n";
+    std::cout << "next (snapshot)      : " << snapshot_next_us << " us\n";
+    std::cout << "next (DB index)      : " << db_next_us << " us\n";
+    std::cout << "write-through        : " << mutation_us << " us/mutation (incl. due-order upkeep)\n";
+    std::cout << "verify vs disk       : " << verify_ms << " ms, " << differences << " differences\n";
+
+    db.closeDB();
+    std::remove(filename.c_str());
+    return differences == 0 ? 0 : 1;
+}
+// ================================================================================
+// ================================================================================
+//eof
@@ -0,0 +1,153 @@
+// ================================================================================
+// ================================================================================
+// - File:    store_stress_bench.cpp
+// - Purpose: Multi-threaded stress test of PlannerStore.  Reader threads run
+//            next-task and due-range queries through the connection pool while
+//            one thread keeps inserting, rescheduling and completing tasks.
+//            Reports read QPS, read latency percentiles and write throughput.
+//
+// Usage: store_stress_bench [rows] [reader_threads] [seconds]
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "../src/include/planner_store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static std::string make_due_date(unsigned& seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    char due_date[11];
+    std::snprintf(due_date, sizeof(due_date), "%04u-%02u-%02u",
+                  2020 + (seed >> 8) % 10, 1 + (seed >> 16) % 12, 1 + (seed >> 4) % 28);
+    return due_date;
+}
+// --------------------------------------------------------------------------------
+
+static double percentile(std::vector<double>& samples, double p)
+{
+    if (samples.empty())
+        return 0.0;
+    size_t index = static_cast<size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    int rows = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int reader_threads = argc > 2 ? std::stoi(argv[2]) : 4;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 5;
+
+    std::string filename{"store_stress_bench.db"};
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((filename + suffix).c_str());
+    }
+
+    // The DB layer reports every write on stdout
+    std::ostringstream sink;
+    std::streambuf* cout_buf = std::cout.rdbuf(sink.rdbuf());
+
+    std::vector<std::vector<double>> latencies(reader_threads);
+    std::atomic<long> writes{0};
+    {
+        PlannerStoreOptions options;
+        options.readers = reader_threads;
+        PlannerStore store(filename, options);
+
+        store.write([rows](DB& db) {
+            std::vector<Task> tasks;
+            tasks.reserve(rows);
+            unsigned seed = 7;
+            for (int i = 0; i < rows; i++) {
+                tasks.push_back(Task{"Task " + std::to_string(i), make_due_date(seed)});
+            }
+            return db.bulkInsertTasks(tasks);
+        }).get();
+
+        std::atomic<bool> running{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < reader_threads; t++) {
+            threads.emplace_back([&, t] {
+                unsigned seed = 100 + t;
+                std::vector<TaskRow> result;
+                for (long i = 0; running.load(std::memory_order_relaxed); i++) {
+                    auto start = std::chrono::steady_clock::now();
+                    {
+                        PlannerStore::ReadLease lease = store.reader();
+                        result.clear();
+                        if (i % 4 == 0) {
+                            DueKey from = parse_due_key(make_due_date(seed));
+                            lease->tasksDueBetween(from, from + 10000, result);
+                        }
+                        else {
+                            lease->nextTasks(10, result);
+                        }
+                    }
+                    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                    latencies[t].push_back(elapsed.count());
+                }
+            });
+        }
+
+        // One writer cycling through the three mutation kinds
+        threads.emplace_back([&] {
+            unsigned seed = 99;
+            int next_complete = 1;
+            while (running.load(std::memory_order_relaxed)) {
+                store.insertTask("Stress task", make_due_date(seed)).get();
+                store.updatePlanner(UpdateRow{"DUE_DATE", make_due_date(seed), "ID",
+                                              std::to_string(next_complete + 1)}).get();
+                store.completeTask(next_complete++).get();
+                writes += 3;
+            }
+        });
+
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        running = false;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+    std::cout.rdbuf(cout_buf);
+
+    std::vector<double> all;
+    for (auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "rows: " << rows << ", reader threads: " << reader_threads
+              << ", duration: " << seconds << " s\n";
+    std::cout << "read QPS      : " << all.size() / static_cast<double>(seconds) << "\n";
+    std::cout << "read p50      : " << percentile(all, 0.50) << " us\n";
+    std::cout << "read p99      : " << percentile(all, 0.99) << " us\n";
+    std::cout << "read p99.9    : " << percentile(all, 0.999) << " us\n";
+    std::cout << "writes/sec    : " << writes.load() / static_cast<double>(seconds) << "\n";
+
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((filename + suffix).c_str());
+    }
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
@@ -0,0 +1,377 @@
+// ================================================================================
+// ================================================================================
+// - File:    alert_engine.cpp
+// - Purpose: Hierarchical timing wheel for due-date alerts; see alert_engine.hpp.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/alert_engine.hpp"
+#include <algorithm>
+#include <bit>
+#include <ctime>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+
+// ================================================================================
+// ================================================================================
+
+int64_t local_minute_now()
+{
+    std::time_t seconds = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    return days_from_civil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * 1440 +
+           local.tm_hour * 60 + local.tm_min;
+}
+
+// ================================================================================
+// ================================================================================
+
+
+ //   private:
+
+uint32_t AlertEngine::allocate()
+{
+    if (free_timers == NIL) {
+        timers.emplace_back();
+        return static_cast<uint32_t>(timers.size() - 1);
+    }
+    uint32_t timer = free_timers;
+    free_timers = timers[timer].next;
+    return timer;
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::release(uint32_t timer)
+{
+    timers[timer].next = free_timers;
+    free_timers = timer;
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::place(uint32_t timer)
+{
+    // The level is the first whose slots are wide enough for the distance
+    // to the expiry; within it, the slot comes from the expiry alone, so
+    // it is reached as the clock enters that slot's span
+    Timer& entry = timers[timer];
+    uint64_t delta = static_cast<uint64_t>(std::max<int64_t>(entry.expires - now, 0));
+    int level = 0;
+    if (delta >= static_cast<uint64_t>(SLOTS)) {
+        level = std::min(LEVELS - 1, (static_cast<int>(std::bit_width(delta)) - 1) / SLOT_BITS);
+    }
+    int index = static_cast<int>((entry.expires >> (SLOT_BITS * level)) & (SLOTS - 1));
+    uint16_t slot = static_cast<uint16_t>(level * SLOTS + index);
+
+    entry.slot = slot;
+    entry.prev = NIL;
+    entry.next = heads[slot];
+    if (heads[slot] != NIL) {
+        timers[heads[slot]].prev = timer;
+    }
+    heads[slot] = timer;
+    occupied[level] |= uint64_t(1) << index;
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::unlink(uint32_t timer)
+{
+    Timer& entry = timers[timer];
+    if (entry.prev != NIL) {
+        timers[entry.prev].next = entry.next;
+    }
+    else {
+        heads[entry.slot] = entry.next;
+        if (entry.next == NIL)
+            occupied[entry.slot / SLOTS] &= ~(uint64_t(1) << (entry.slot % SLOTS));
+    }
+    if (entry.next != NIL) {
+        timers[entry.next].prev = entry.prev;
+    }
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::cascade(int level)
+{
+    // Everything here expires within one slot of the level below, so each
+    // timer moves down at least one level
+    int index = static_cast<int>((now >> (SLOT_BITS * level)) & (SLOTS - 1));
+    uint16_t slot = static_cast<uint16_t>(level * SLOTS + index);
+    uint32_t timer = heads[slot];
+    heads[slot] = NIL;
+    occupied[level] &= ~(uint64_t(1) << index);
+    while (timer != NIL) {
+        uint32_t next = timers[timer].next;
+        place(timer);
+        timer = next;
+    }
+}
+// --------------------------------------------------------------------------------
+
+size_t AlertEngine::fireCurrent()
+{
+    // One alert at a time off the head: fire may complete or reschedule
+    // tasks, which unlinks other timers in this very list
+    uint16_t slot = static_cast<uint16_t>(now & (SLOTS - 1));
+    size_t fired = 0;
+    while (heads[slot] != NIL) {
+        uint32_t timer = heads[slot];
+        unlink(timer);
+        const Timer& entry = timers[timer];
+        int lead = lead_minutes[entry.lead];
+        Alert alert{entry.id, due_key_from_minutes(entry.expires + lead), lead, entry.expires};
+        detachFromTask(timer);
+        release(timer);
+        pending_count--;
+        fire(alert);
+        fired++;
+    }
+    return fired;
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::detachFromTask(uint32_t timer)
+{
+    auto it = by_task.find(timers[timer].id);
+    if (it == by_task.end())
+        return;
+
+    uint32_t* link = &it->second;
+    while (*link != NIL && *link != timer) {
+        link = &timers[*link].task_next;
+    }
+    if (*link == timer) {
+        *link = timers[timer].task_next;
+    }
+    if (it->second == NIL) {
+        by_task.erase(it);
+    }
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+AlertEngine::AlertEngine(DB& db, std::function<void(const Alert&)> fire, int64_t now_minute,
+                         const AlertOptions& options) :
+    db(&db),
+    fire(std::move(fire)),
+    lead_minutes(options.lead_minutes),
+    now(now_minute),
+    free_timers(NIL),
+    pending_count(0),
+    change_sequence(0),
+    catch_up_failed(false)
+{
+    lead_minutes.erase(std::remove_if(lead_minutes.begin(), lead_minutes.end(), [](int lead) { return lead < 0; }),
+                       lead_minutes.end());
+    std::sort(lead_minutes.begin(), lead_minutes.end());
+    lead_minutes.erase(std::unique(lead_minutes.begin(), lead_minutes.end()), lead_minutes.end());
+    reload();
+    db.addObserver(this);
+}
+// --------------------------------------------------------------------------------
+
+AlertEngine::~AlertEngine()
+{
+    db->removeObserver(this);
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::reload()
+{
+    timers.clear();
+    free_timers = NIL;
+    std::fill(std::begin(heads), std::end(heads), NIL);
+    std::fill(std::begin(occupied), std::end(occupied), 0);
+    by_task.clear();
+    pending_count = 0;
+
+    // Same read transaction for the rows and their change sequence
+    db->changedElsewhere();
+    db->beginTransaction();
+    change_sequence = db->changeSequence();
+    for (const RowView& row : db->scanTasks()) {
+        schedule(row.id, row.due_key);
+    }
+    db->commitTransaction();
+}
+// --------------------------------------------------------------------------------
+
+int AlertEngine::catchUp()
+{
+    // A failed catch-up has already consumed the data_version change
+    if (!db->changedElsewhere() && !catch_up_failed) {
+        return SQLITE_OK;
+    }
+    catch_up_failed = true;
+
+    int rc = db->beginTransaction();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    ChangeSet changes;
+    std::vector<TaskRow> rows;
+    rc = db->changesSince(change_sequence, changes);
+    if (rc == SQLITE_OK && changes.complete) {
+        rc = db->tasksById(changes.inserted, rows);
+    }
+    if (rc == SQLITE_OK && changes.complete) {
+        rc = db->tasksById(changes.updated, rows);
+    }
+    if (rc != SQLITE_OK) {
+        db->rollbackTransaction();
+        return rc;
+    }
+    if (!changes.complete) {
+        db->commitTransaction();
+        reload();
+        catch_up_failed = false;
+        return SQLITE_OK;
+    }
+    rc = db->commitTransaction();
+    catch_up_failed = false;
+
+    for (int id : changes.completed) {
+        cancel(id);
+    }
+    for (const TaskRow& row : rows) {
+        schedule(row.id, row.due_key);
+    }
+    change_sequence = changes.sequence;
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::schedule(int id, DueKey due_key)
+{
+    cancel(id);
+    if (due_key == INVALID_DUE_KEY) {
+        return;
+    }
+
+    int64_t due = due_key_to_minutes(due_key);
+    uint32_t first = NIL;
+    for (size_t i = 0; i < lead_minutes.size(); i++) {
+        int64_t expires = due - lead_minutes[i];
+        if (expires <= now)
+            continue;
+        uint32_t timer = allocate();
+        timers[timer] = Timer{expires, id, NIL, NIL, first, 0, static_cast<uint16_t>(i)};
+        place(timer);
+        first = timer;
+        pending_count++;
+    }
+    if (first != NIL) {
+        by_task[id] = first;
+    }
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::cancel(int id)
+{
+    auto it = by_task.find(id);
+    if (it == by_task.end())
+        return;
+
+    uint32_t timer = it->second;
+    while (timer != NIL) {
+        uint32_t next = timers[timer].task_next;
+        unlink(timer);
+        release(timer);
+        pending_count--;
+        timer = next;
+    }
+    by_task.erase(it);
+}
+// --------------------------------------------------------------------------------
+
+size_t AlertEngine::advance(int64_t minute)
+{
+    size_t fired = 0;
+    while (now < minute) {
+        // While the levels below k are empty nothing happens before level
+        // k's next cascade, so the clock can jump straight there
+        int64_t next = now + 1;
+        if (pending_count == 0) {
+            next = minute;
+        }
+        else {
+            for (int level = 0; level < LEVELS - 1 && occupied[level] == 0; level++) {
+                int64_t span = int64_t(1) << (SLOT_BITS * (level + 1));
+                next = (now & ~(span - 1)) + span;
+            }
+        }
+        now = std::min(next, minute);
+
+        // Higher levels first, so a timer can fall through several levels
+        // in one tick
+        for (int level = LEVELS - 1; level > 0; level--) {
+            if ((now & ((int64_t(1) << (SLOT_BITS * level)) - 1)) == 0)
+                cascade(level);
+        }
+        fired += fireCurrent();
+    }
+    return fired;
+}
+// --------------------------------------------------------------------------------
+
+int64_t AlertEngine::currentMinute() const
+{
+    return now;
+}
+// --------------------------------------------------------------------------------
+
+size_t AlertEngine::pending() const
+{
+    return pending_count;
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::taskInserted(int id, const std::string&, const std::string& due_date, int)
+{
+    schedule(id, parse_due_key(due_date));
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::taskCompleted(int id)
+{
+    cancel(id);
+}
+// --------------------------------------------------------------------------------
+
+void AlertEngine::plannerUpdated(const UpdateRow& updated_row)
+{
+    int id = 0;
+    bool by_id = sqlite3_stricmp(updated_row.id_column_name.c_str(), "ID") == 0;
+    if (by_id) {
+        try {
+            id = std::stoi(updated_row.id_column_value);
+        } catch (const std::exception&) {
+            by_id = false;
+        }
+    }
+
+    const std::string& column = updated_row.set_column_name;
+    if (by_id && sqlite3_stricmp(column.c_str(), "DUE_DATE") == 0) {
+        schedule(id, parse_due_key(updated_row.set_new_value));
+    }
+    else if (!by_id || (sqlite3_stricmp(column.c_str(), "TASK") != 0 &&
+                        sqlite3_stricmp(column.c_str(), "PRIORITY") != 0)) {
+        // Not addressed by ID, or a column that may move the due date: re-read
+        reload();
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
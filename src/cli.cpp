@@ -0,0 +1,787 @@
+// ================================================================================
+// ================================================================================
+// - File:    cli.cpp
+// - Purpose: Subcommands, batch mode and buffered output for the planner CLI.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/cli.hpp"
+#include "include/date_key.hpp"
+#include "include/import_export.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+
+// ================================================================================
+// ================================================================================
+
+static const size_t FLUSH_SIZE = 1 << 16;
+// --------------------------------------------------------------------------------
+
+static bool parse_int(const std::string& text, int& value)
+{
+    char* end = nullptr;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || parsed < 0 || parsed > INT32_MAX)
+        return false;
+    value = static_cast<int>(parsed);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_sequence(const std::string& text, int64_t& value)
+{
+    char* end = nullptr;
+    long long parsed = std::strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || parsed < 0)
+        return false;
+    value = parsed;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_date_arg(const std::string& text, DueKey& key)
+{
+    if (!parse_due_key(text.data(), text.size(), key)) {
+        std::cerr << "Error: invalid date \"" << text << "\" (expected YYYY-MM-DD[THH:MM])" << std::endl;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_priority_arg(const std::string& text, int& priority)
+{
+    if (!parse_int(text, priority) || priority < MIN_PRIORITY || priority > MAX_PRIORITY) {
+        std::cerr << "Error: invalid priority \"" << text << "\" (expected " << MIN_PRIORITY << "-" << MAX_PRIORITY << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static int usage_error(const std::string& usage)
+{
+    std::cerr << "Usage: " << usage << std::endl;
+    return 2;
+}
+
+// ================================================================================
+// ================================================================================
+//   RowWriter
+// ================================================================================
+
+bool parse_output_format(const std::string& name, OutputFormat& format)
+{
+    if (name == "text")
+        format = OutputFormat::Text;
+    else if (name == "tsv")
+        format = OutputFormat::Tsv;
+    else if (name == "json")
+        format = OutputFormat::Json;
+    else
+        return false;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+RowWriter::RowWriter(std::ostream& out, OutputFormat format, bool quiet) :
+    out(out),
+    format(format),
+    quiet(quiet),
+    held(false)
+{
+    buffer.reserve(FLUSH_SIZE + 256);
+}
+// --------------------------------------------------------------------------------
+
+RowWriter::~RowWriter()
+{
+    flush();
+}
+// --------------------------------------------------------------------------------
+
+OutputFormat RowWriter::outputFormat() const
+{
+    return format;
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::appendEscaped(std::string_view text)
+{
+    for (char c : text) {
+        if (format == OutputFormat::Json) {
+            switch (c) {
+                case '"':  buffer.append("\\\""); break;
+                case '\\': buffer.append("\\\\"); break;
+                case '\n': buffer.append("\\n"); break;
+                case '\r': buffer.append("\\r"); break;
+                case '\t': buffer.append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escape[8];
+                        std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                        buffer.append(escape);
+                    }
+                    else {
+                        buffer.push_back(c);
+                    }
+            }
+        }
+        else if (format == OutputFormat::Tsv) {
+            switch (c) {
+                case '\\': buffer.append("\\\\"); break;
+                case '\t': buffer.append("\\t"); break;
+                case '\n': buffer.append("\\n"); break;
+                case '\r': buffer.append("\\r"); break;
+                default:   buffer.push_back(c);
+            }
+        }
+        else {
+            buffer.push_back(c);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::flushIfFull()
+{
+    if (!held && buffer.size() >= FLUSH_SIZE)
+        flush();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::row(int id, std::string_view task, DueKey due_key, std::string_view due_date, int priority)
+{
+    // The parsed key is canonical; the stored text only shows for rows
+    // whose date never parsed.
+    std::string formatted = due_key != INVALID_DUE_KEY ? format_due_key(due_key) : std::string(due_date);
+    std::string id_text = std::to_string(id);
+
+    switch (format) {
+        case OutputFormat::Text:
+            buffer.append("ID: ").append(id_text).append(", Task: ");
+            appendEscaped(task);
+            buffer.append(", Due Date: ").append(formatted);
+            if (priority != MIN_PRIORITY)
+                buffer.append(", Priority: ").append(std::to_string(priority));
+            buffer.push_back('\n');
+            break;
+        case OutputFormat::Tsv:
+            buffer.append(id_text).push_back('\t');
+            appendEscaped(task);
+            buffer.push_back('\t');
+            appendEscaped(formatted);
+            buffer.push_back('\t');
+            buffer.append(std::to_string(priority)).push_back('\n');
+            break;
+        case OutputFormat::Json:
+            buffer.append("{\"id\": ").append(id_text).append(", \"task\": \"");
+            appendEscaped(task);
+            buffer.append("\", \"due_date\": \"");
+            appendEscaped(formatted);
+            buffer.append("\", \"priority\": ").append(std::to_string(priority)).append("}\n");
+            break;
+    }
+    flushIfFull();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::row(const TaskRow& task_row)
+{
+    row(task_row.id, task_row.task, task_row.due_key, {}, task_row.priority);
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::recurrence(const RecurrenceRule& rule)
+{
+    std::string id_text = std::to_string(rule.id);
+    std::string pending_id = std::to_string(rule.pending_id);
+    std::string next = format_due_key(rule.pending_key);
+    std::string until = rule.until != INVALID_DUE_KEY ? format_due_key(rule.until) : std::string();
+
+    switch (format) {
+        case OutputFormat::Text:
+            buffer.append("Rule ").append(id_text).append(", Task: ");
+            appendEscaped(rule.task);
+            buffer.append(", Repeats: ").append(describe_recurrence(rule));
+            buffer.append(", Next: ").append(next).append(" (ID ").append(pending_id).append(")\n");
+            break;
+        case OutputFormat::Tsv:
+            buffer.append(id_text).push_back('\t');
+            appendEscaped(rule.task);
+            buffer.append("\t").append(format_due_key(rule.start));
+            buffer.append("\t").append(frequency_name(rule.frequency));
+            buffer.append("\t").append(std::to_string(rule.interval));
+            buffer.append("\t").append(until);
+            buffer.append("\t").append(pending_id);
+            buffer.append("\t").append(next).push_back('\n');
+            break;
+        case OutputFormat::Json:
+            buffer.append("{\"id\": ").append(id_text).append(", \"task\": \"");
+            appendEscaped(rule.task);
+            buffer.append("\", \"start\": \"").append(format_due_key(rule.start));
+            buffer.append("\", \"frequency\": \"").append(frequency_name(rule.frequency));
+            buffer.append("\", \"interval\": ").append(std::to_string(rule.interval));
+            buffer.append(", \"until\": ");
+            if (until.empty())
+                buffer.append("null");
+            else
+                buffer.append("\"").append(until).append("\"");
+            buffer.append(", \"next_id\": ").append(pending_id);
+            buffer.append(", \"next_due_date\": \"").append(next).append("\"}\n");
+            break;
+    }
+    flushIfFull();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::alert(const Alert& alert, std::string_view task)
+{
+    std::string id_text = std::to_string(alert.id);
+    std::string due_date = format_due_key(alert.due_key);
+    std::string lead = std::to_string(alert.lead_minutes);
+
+    switch (format) {
+        case OutputFormat::Text:
+            if (alert.lead_minutes == 0)
+                buffer.append("Due now: ");
+            else
+                buffer.append("Due in ").append(lead).append(" minutes: ");
+            buffer.append("ID: ").append(id_text).append(", Task: ");
+            appendEscaped(task);
+            buffer.append(", Due Date: ").append(due_date).push_back('\n');
+            break;
+        case OutputFormat::Tsv:
+            buffer.append(id_text).push_back('\t');
+            appendEscaped(task);
+            buffer.append("\t").append(due_date).append("\t").append(lead).push_back('\n');
+            break;
+        case OutputFormat::Json:
+            buffer.append("{\"id\": ").append(id_text).append(", \"task\": \"");
+            appendEscaped(task);
+            buffer.append("\", \"due_date\": \"").append(due_date);
+            buffer.append("\", \"lead_minutes\": ").append(lead).append("}\n");
+            break;
+    }
+    flushIfFull();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::result(std::string_view name, long long value)
+{
+    if (quiet)
+        return;
+
+    std::string value_text = std::to_string(value);
+    switch (format) {
+        case OutputFormat::Text:
+            buffer.append(name).append(": ").append(value_text).push_back('\n');
+            break;
+        case OutputFormat::Tsv:
+            buffer.append(value_text).push_back('\n');
+            break;
+        case OutputFormat::Json:
+            buffer.append("{\"").append(name).append("\": ").append(value_text).append("}\n");
+            break;
+    }
+    flushIfFull();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::flush()
+{
+    if (!buffer.empty()) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    out.flush();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::hold()
+{
+    held = true;
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::release()
+{
+    held = false;
+    flush();
+}
+// --------------------------------------------------------------------------------
+
+void RowWriter::discard()
+{
+    held = false;
+    buffer.clear();
+}
+
+// ================================================================================
+// ================================================================================
+//   Commands
+// ================================================================================
+
+std::vector<std::string> split_command_line(const std::string& line)
+{
+    std::vector<std::string> words;
+    std::string word;
+    bool in_word = false;
+    bool quoted = false;
+
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '\\' && i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\'))
+                word.push_back(line[++i]);
+            else if (c == '"')
+                quoted = false;
+            else
+                word.push_back(c);
+        }
+        else if (c == '"') {
+            quoted = true;
+            in_word = true;
+        }
+        else if (c == ' ' || c == '\t' || c == '\r') {
+            if (in_word) {
+                words.push_back(std::move(word));
+                word.clear();
+                in_word = false;
+            }
+        }
+        else if (c == '#' && !in_word) {
+            break;
+        }
+        else {
+            word.push_back(c);
+            in_word = true;
+        }
+    }
+    if (in_word)
+        words.push_back(std::move(word));
+    return words;
+}
+// --------------------------------------------------------------------------------
+
+static int command_add(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() != 3 && args.size() != 4)
+        return usage_error("add TASK DUE_DATE [PRIORITY]");
+    DueKey key;
+    if (!parse_date_arg(args[2], key))
+        return 1;
+    int priority = MIN_PRIORITY;
+    if (args.size() == 4 && !parse_priority_arg(args[3], priority))
+        return 1;
+
+    std::string task = args[1];
+    std::string due_date = args[2];
+    if (priority == MIN_PRIORITY) {
+        if (db.insertTask(task, due_date) != SQLITE_OK)
+            return 1;
+        out.result("id", sqlite3_last_insert_rowid(db.db));
+        return 0;
+    }
+
+    // Insert and prioritize together so the task never shows unprioritized
+    if (db.beginTransaction() != SQLITE_OK)
+        return 1;
+    if (db.insertTask(task, due_date) != SQLITE_OK) {
+        db.rollbackTransaction();
+        return 1;
+    }
+    sqlite3_int64 id = sqlite3_last_insert_rowid(db.db);
+    if (db.setPriority(static_cast<int>(id), priority) != SQLITE_OK) {
+        db.rollbackTransaction();
+        return 1;
+    }
+    if (db.commitTransaction() != SQLITE_OK)
+        return 1;
+    out.result("id", id);
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_complete(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() < 2)
+        return usage_error("complete ID...");
+    std::vector<int> ids;
+    for (size_t i = 1; i < args.size(); i++) {
+        int id;
+        if (!parse_int(args[i], id)) {
+            std::cerr << "Error: invalid task ID \"" << args[i] << "\"" << std::endl;
+            return 1;
+        }
+        ids.push_back(id);
+    }
+
+    int completed = 0;
+    if (db.completeTasks(ids, &completed) != SQLITE_OK)
+        return 1;
+    out.result("completed", completed);
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_update(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() != 4)
+        return usage_error("update ID task|due_date|priority VALUE");
+    int id;
+    if (!parse_int(args[1], id)) {
+        std::cerr << "Error: invalid task ID \"" << args[1] << "\"" << std::endl;
+        return 1;
+    }
+
+    if (args[2] == "priority" || args[2] == "PRIORITY") {
+        int priority;
+        if (!parse_priority_arg(args[3], priority) || db.setPriority(id, priority) != SQLITE_OK)
+            return 1;
+        out.result("updated", sqlite3_changes(db.db));
+        return 0;
+    }
+
+    // Only these two columns are exposed; the name goes into the SQL text
+    std::string column;
+    if (args[2] == "task" || args[2] == "TASK") {
+        column = "TASK";
+    }
+    else if (args[2] == "due_date" || args[2] == "DUE_DATE") {
+        DueKey key;
+        if (!parse_date_arg(args[3], key))
+            return 1;
+        column = "DUE_DATE";
+    }
+    else {
+        return usage_error("update ID task|due_date|priority VALUE");
+    }
+
+    UpdateRow update{column, args[3], "ID", std::to_string(id)};
+    if (db.updatePlanner(update) != SQLITE_OK)
+        return 1;
+    out.result("updated", sqlite3_changes(db.db));
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_next(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    int count = 1;
+    if (args.size() > 2 || (args.size() == 2 && !parse_int(args[1], count)))
+        return usage_error("next [N]");
+
+    std::vector<TaskRow> rows;
+    if (db.nextTasks(count, rows) != SQLITE_OK)
+        return 1;
+    for (const TaskRow& row : rows) {
+        out.row(row);
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_range(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() != 3)
+        return usage_error("range FROM TO   (FROM <= due date < TO)");
+    DueKey from, to;
+    if (!parse_date_arg(args[1], from) || !parse_date_arg(args[2], to))
+        return 1;
+
+    std::vector<TaskRow> rows;
+    if (db.tasksDueBetween(from, to, rows) != SQLITE_OK)
+        return 1;
+    for (const TaskRow& row : rows) {
+        out.row(row);
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_search(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    // QUERY [N] [FROM TO]: four or more arguments end in the two dates
+    if (args.size() < 2 || args.size() > 5)
+        return usage_error("search QUERY [N] [FROM TO]");
+    size_t dates = args.size() >= 4 ? 2 : 0;
+    int limit = 20;
+    if (args.size() - dates == 3 && (!parse_int(args[2], limit) || limit <= 0)) {
+        std::cerr << "Error: invalid result count \"" << args[2] << "\"" << std::endl;
+        return 1;
+    }
+
+    std::vector<TaskRow> rows;
+    if (dates) {
+        DueKey from, to;
+        if (!parse_date_arg(args[args.size() - 2], from) || !parse_date_arg(args.back(), to))
+            return 1;
+        if (db.searchTasks(args[1], limit, from, to, rows) != SQLITE_OK)
+            return 1;
+    }
+    else if (db.searchTasks(args[1], limit, rows) != SQLITE_OK) {
+        return 1;
+    }
+    for (const TaskRow& row : rows) {
+        out.row(row);
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_list(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() != 1)
+        return usage_error("list");
+    TaskCursor cursor = db.scanTasks();
+    for (const RowView& row : cursor) {
+        out.row(row.id, row.task, row.due_key, row.due_date, row.priority);
+    }
+    return cursor.status() == SQLITE_OK ? 0 : 1;
+}
+// --------------------------------------------------------------------------------
+
+static int command_recur(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() < 4 || args.size() > 6)
+        return usage_error("recur TASK START daily|weekly|monthly [INTERVAL] [UNTIL]");
+
+    RecurrenceRule rule;
+    rule.task = args[1];
+    if (!parse_date_arg(args[2], rule.start))
+        return 1;
+    if (!parse_frequency(args[3], rule.frequency)) {
+        std::cerr << "Error: unknown frequency \"" << args[3] << "\" (expected daily, weekly or monthly)" << std::endl;
+        return 1;
+    }
+
+    // The interval is a number, the end a date, so either may be left out
+    for (size_t i = 4; i < args.size(); i++) {
+        int interval;
+        if (parse_int(args[i], interval) && interval > 0)
+            rule.interval = interval;
+        else if (!parse_date_arg(args[i], rule.until))
+            return 1;
+    }
+
+    if (db.addRecurrence(rule) != SQLITE_OK)
+        return 1;
+    out.result("id", rule.id);
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_recurrences(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() != 1)
+        return usage_error("recurrences");
+    std::vector<RecurrenceRule> rules;
+    if (db.listRecurrences(rules) != SQLITE_OK)
+        return 1;
+    for (const RecurrenceRule& rule : rules) {
+        out.recurrence(rule);
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_unrecur(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    int id;
+    if (args.size() != 2 || !parse_int(args[1], id))
+        return usage_error("unrecur ID");
+    if (db.removeRecurrence(id) != SQLITE_OK)
+        return 1;
+    out.result("removed", 1);
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_changes(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    int64_t since = 0;
+    if (args.size() > 2 || (args.size() == 2 && !parse_sequence(args[1], since)))
+        return usage_error("changes [SEQ]");
+
+    // Without a sequence, just where the log stands
+    if (args.size() == 1) {
+        int64_t sequence = db.changeSequence();
+        if (sequence < 0)
+            return 1;
+        out.result("sequence", sequence);
+        return 0;
+    }
+
+    ChangeSet changes;
+    if (db.changesSince(since, changes) != SQLITE_OK)
+        return 1;
+    if (!changes.complete) {
+        std::cerr << "Error: the change log no longer goes back to sequence " << since
+                  << "; reload and continue from " << changes.sequence << std::endl;
+        return 1;
+    }
+    for (int id : changes.inserted) {
+        out.result("inserted", id);
+    }
+    for (int id : changes.updated) {
+        out.result("updated", id);
+    }
+    for (int id : changes.completed) {
+        out.result("completed", id);
+    }
+    out.result("sequence", changes.sequence);
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_prune_changes(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    int64_t through;
+    if (args.size() != 2 || !parse_sequence(args[1], through))
+        return usage_error("prune-changes SEQ");
+    int pruned = 0;
+    if (db.pruneChanges(through, &pruned) != SQLITE_OK)
+        return 1;
+    out.result("pruned", pruned);
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+// Format named by the optional argument, else by the file extension.  Pipes
+// default to NDJSON under --format json and to TSV otherwise.
+static bool data_format_arg(const std::vector<std::string>& args, const RowWriter& out, DataFormat& format)
+{
+    DataFormat fallback = out.outputFormat() == OutputFormat::Json ? DataFormat::Ndjson : DataFormat::Tsv;
+    std::string path = args.size() > 1 ? args[1] : "-";
+    format = path == "-" ? fallback : data_format_for_path(path, fallback);
+    if (args.size() > 2 && !parse_data_format(args[2], format)) {
+        std::cerr << "Error: unknown data format \"" << args[2] << "\" (expected tsv, csv or ndjson)" << std::endl;
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static int command_import(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() < 2 || args.size() > 3)
+        return usage_error("import FILE|- [tsv|csv|ndjson]");
+    ImportOptions options;
+    if (!data_format_arg(args, out, options.format))
+        return 2;
+
+    ImportResult result;
+    if (import_tasks(db, args[1], options, result) != SQLITE_OK) {
+        if (result.error_line > 0)
+            std::cerr << "Error on import line " << result.error_line << ": " << result.error << std::endl;
+        else
+            std::cerr << "Error importing " << args[1] << ": " << result.error << std::endl;
+        return 1;
+    }
+    out.result("imported", static_cast<long long>(result.rows));
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+static int command_export(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.size() > 3)
+        return usage_error("export [FILE|-] [tsv|csv|ndjson]");
+    DataFormat format;
+    if (!data_format_arg(args, out, format))
+        return 2;
+
+    // Keep anything already buffered ahead of an export to stdout
+    out.flush();
+    return export_tasks(db, args.size() > 1 ? args[1] : "-", format) == SQLITE_OK ? 0 : 1;
+}
+// --------------------------------------------------------------------------------
+
+int run_command(DB& db, const std::vector<std::string>& args, RowWriter& out)
+{
+    if (args.empty())
+        return 0;
+
+    const std::string& name = args[0];
+    if (name == "add")
+        return command_add(db, args, out);
+    if (name == "complete")
+        return command_complete(db, args, out);
+    if (name == "update")
+        return command_update(db, args, out);
+    if (name == "next")
+        return command_next(db, args, out);
+    if (name == "range")
+        return command_range(db, args, out);
+    if (name == "list")
+        return command_list(db, args, out);
+    if (name == "search")
+        return command_search(db, args, out);
+    if (name == "import")
+        return command_import(db, args, out);
+    if (name == "export")
+        return command_export(db, args, out);
+    if (name == "recur")
+        return command_recur(db, args, out);
+    if (name == "recurrences")
+        return command_recurrences(db, args, out);
+    if (name == "unrecur")
+        return command_unrecur(db, args, out);
+    if (name == "changes")
+        return command_changes(db, args, out);
+    if (name == "prune-changes")
+        return command_prune_changes(db, args, out);
+
+    std::cerr << "Error: unknown command \"" << name << "\"" << std::endl;
+    return 2;
+}
+// --------------------------------------------------------------------------------
+
+int run_batch(DB& db, std::istream& in, RowWriter& out)
+{
+    if (db.beginTransaction() != SQLITE_OK)
+        return 1;
+
+    // Nothing is shown for lines that end up rolled back
+    out.flush();
+    out.hold();
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        std::vector<std::string> args = split_command_line(line);
+        if (args.empty())
+            continue;
+
+        int result = args[0] == "batch" ? usage_error("batch cannot be nested") : run_command(db, args, out);
+        if (result != 0) {
+            std::cerr << "Error on line " << line_number << "; no changes were made" << std::endl;
+            out.discard();
+            db.rollbackTransaction();
+            return result;
+        }
+    }
+
+    if (db.commitTransaction() != SQLITE_OK) {
+        out.discard();
+        db.rollbackTransaction();
+        return 1;
+    }
+    out.release();
+    return 0;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
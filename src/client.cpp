@@ -0,0 +1,145 @@
+// ================================================================================
+// ================================================================================
+// - File:    client.cpp
+// - Purpose: Blocking client for the planner server.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/client.hpp"
+#include "include/protocol.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ================================================================================
+// ================================================================================
+
+PlannerClient::PlannerClient() : fd(-1), input_start(0)
+{
+}
+// --------------------------------------------------------------------------------
+
+PlannerClient::~PlannerClient()
+{
+    if (fd >= 0)
+        close(fd);
+}
+// --------------------------------------------------------------------------------
+
+int PlannerClient::connectTo(const std::string& path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: socket path too long: " << path << std::endl;
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Error connecting to " << path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+        return -1;
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+void PlannerClient::send(const std::vector<std::string>& fields)
+{
+    append_line(output, fields);
+}
+// --------------------------------------------------------------------------------
+
+bool PlannerClient::flush()
+{
+    size_t sent = 0;
+    while (sent < output.size()) {
+        ssize_t count = ::send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        sent += static_cast<size_t>(count);
+    }
+    output.clear();
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool PlannerClient::readLine(std::string& line)
+{
+    while (true) {
+        size_t end = input.find('\n', input_start);
+        if (end != std::string::npos) {
+            line.assign(input, input_start, end - input_start);
+            input_start = end + 1;
+            return true;
+        }
+
+        // Keep the buffer from growing with consumed lines
+        input.erase(0, input_start);
+        input_start = 0;
+
+        char buffer[64 * 1024];
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        input.append(buffer, static_cast<size_t>(count));
+    }
+}
+// --------------------------------------------------------------------------------
+
+bool PlannerClient::receive(ServerResponse& response)
+{
+    response.ok = false;
+    response.error.clear();
+    response.rows.clear();
+
+    std::string line;
+    if (!readLine(line))
+        return false;
+    if (line.compare(0, 4, "ERR ") == 0) {
+        response.error = line.substr(4);
+        return true;
+    }
+    if (line.compare(0, 3, "OK ") != 0)
+        return false;
+
+    size_t rows = std::strtoul(line.c_str() + 3, nullptr, 10);
+    response.rows.resize(rows);
+    for (size_t i = 0; i < rows; i++) {
+        if (!readLine(line))
+            return false;
+        split_line(line, response.rows[i]);
+    }
+    response.ok = true;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool PlannerClient::call(const std::vector<std::string>& fields, ServerResponse& response)
+{
+    send(fields);
+    return flush() && receive(response);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,101 @@
+// ================================================================================
+// ================================================================================
+// - File:    client_main.cpp
+// - Purpose: Thin command-line client for the planner server.
+//
+// Usage: planner_client SOCKET REQUEST [ARGS...]
+//        planner_client SOCKET < requests
+//
+// With a request on the command line it is sent as is.  Otherwise every
+// stdin line is a request with TAB-separated fields, pipelined in windows
+// of 1024 requests per round trip.  Rows print as TSV, errors go to stderr.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/client.hpp"
+#include "include/protocol.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static bool print_response(const ServerResponse& response, std::string& out)
+{
+    if (!response.ok) {
+        std::cerr << "Error: " << response.error << std::endl;
+        return false;
+    }
+    for (const std::vector<std::string>& row : response.rows) {
+        append_line(out, row);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: planner_client SOCKET [REQUEST [ARGS...]]" << std::endl;
+        return 2;
+    }
+
+    PlannerClient client;
+    if (client.connectTo(argv[1]) != 0)
+        return 1;
+
+    int result = 0;
+    std::string out;
+    size_t pending = 0;
+
+    // Answers are read back every WINDOW requests so neither side's
+    // buffers grow without bound on a long input.
+    const size_t WINDOW = 1024;
+    auto drain = [&]() {
+        if (!client.flush())
+            return false;
+        ServerResponse response;
+        for (; pending > 0; pending--) {
+            if (!client.receive(response))
+                return false;
+            if (!print_response(response, out))
+                result = 1;
+        }
+        return true;
+    };
+
+    bool connected = true;
+    if (argc > 2) {
+        client.send(std::vector<std::string>(argv + 2, argv + argc));
+        pending = 1;
+    }
+    else {
+        std::string line;
+        std::vector<std::string> fields;
+        while (connected && std::getline(std::cin, line)) {
+            if (line.empty())
+                continue;
+            split_line(line, fields);
+            client.send(fields);
+            if (++pending == WINDOW)
+                connected = drain();
+        }
+    }
+    if (!connected || !drain()) {
+        std::cout.write(out.data(), out.size());
+        std::cerr << "Error: connection lost" << std::endl;
+        return 1;
+    }
+    std::cout.write(out.data(), out.size());
+    return result;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,263 @@
+// ================================================================================
+// ================================================================================
+// - File:    date_key.cpp
+// - Purpose: Allocation-free parsing and formatting of integer due-date keys.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/date_key.hpp"
+#include "include/metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Rows per parse_due_keys chunk; big enough to amortise a thread hand-off.
+static const size_t PARSE_CHUNK = 1 << 16;
+// --------------------------------------------------------------------------------
+
+static inline bool read_digits(const char* text, int count, int& value)
+{
+    value = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+        if (digit > 9)
+            return false;
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static inline int days_in_month(int year, int month)
+{
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)))
+        return 29;
+    return days[month - 1];
+}
+// --------------------------------------------------------------------------------
+
+// Checks and decodes "YYYY-MM-DD" eight bytes at a time: one load covers
+// "YYYY-MM-", the dashes are swapped for '0' so every byte is tested as a
+// digit in the same word, and only the last two bytes are handled alone.
+static inline bool read_date_swar(const char* text, int& year, int& month, int& day)
+{
+    uint64_t word;
+    std::memcpy(&word, text, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+
+    // Lane i holds text[i]; lanes 4 and 7 must be '-'
+    const uint64_t dash_lanes = 0xFF0000FF00000000ull;
+    if ((word & dash_lanes) != 0x2D00002D00000000ull)
+        return false;
+    uint64_t digits = (word & ~dash_lanes) | 0x3000003000000000ull;
+
+    // A lane holds an ASCII digit iff its high nibble is 3 both before and
+    // after adding 6; carries out of a bad lane only ever break that lane
+    if (((digits & 0xF0F0F0F0F0F0F0F0ull) |
+         (((digits + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) != 0x3333333333333333ull)
+        return false;
+    unsigned day_tens = static_cast<unsigned char>(text[8]) - '0';
+    unsigned day_ones = static_cast<unsigned char>(text[9]) - '0';
+    if (day_tens > 9 || day_ones > 9)
+        return false;
+
+    digits -= 0x3030303030303030ull;
+    auto lane = [digits](int i) { return static_cast<int>((digits >> (8 * i)) & 0xFF); };
+    year = lane(0) * 1000 + lane(1) * 100 + lane(2) * 10 + lane(3);
+    month = lane(5) * 10 + lane(6);
+    day = static_cast<int>(day_tens * 10 + day_ones);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_fields(const char* text, size_t length, DueKey& key)
+{
+    // YYYY-MM-DD is fixed width, so every field sits at a known offset
+    if (length != 10 && length != 16)
+        return false;
+
+    int year, month, day;
+    if (!read_date_swar(text, year, month, day))
+        return false;
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month))
+        return false;
+
+    int hour = 0, minute = 0;
+    if (length == 16) {
+        if ((text[10] != 'T' && text[10] != ' ') || text[13] != ':')
+            return false;
+        if (!read_digits(text + 11, 2, hour) || !read_digits(text + 14, 2, minute))
+            return false;
+        if (hour > 23 || minute > 59)
+            return false;
+    }
+
+    key = (((static_cast<DueKey>(year) * 100 + month) * 100 + day) * 100 + hour) * 100 + minute;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool parse_due_key(const char* text, size_t length, DueKey& key)
+{
+    PLANNER_COUNT(DateParses, 1);
+    if (!parse_fields(text, length, key)) {
+        PLANNER_COUNT(DateParseErrors, 1);
+        return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+DueKey parse_due_key(std::string_view text)
+{
+    DueKey key = INVALID_DUE_KEY;
+    parse_due_key(text.data(), text.size(), key);
+    return key;
+}
+// --------------------------------------------------------------------------------
+
+// Parses one chunk; the metrics are counted once per chunk rather than per
+// date so the threads do not contend on the counters.
+static void parse_chunk(const std::string_view* texts, size_t count, DueKey* keys,
+                        std::vector<DateError>& errors)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (!parse_fields(texts[i].data(), texts[i].size(), keys[i])) {
+            keys[i] = INVALID_DUE_KEY;
+            errors.push_back(DateError{i, std::string(texts[i])});
+        }
+    }
+    PLANNER_COUNT(DateParses, count);
+    PLANNER_COUNT(DateParseErrors, errors.size());
+}
+// --------------------------------------------------------------------------------
+
+void parse_due_keys(const std::string_view* texts, size_t count, DueKey* keys,
+                    std::vector<DateError>& errors, unsigned threads)
+{
+    size_t chunks = (count + PARSE_CHUNK - 1) / PARSE_CHUNK;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, chunks));
+
+    if (threads <= 1) {
+        std::vector<DateError> found;
+        parse_chunk(texts, count, keys, found);
+        errors.insert(errors.end(), found.begin(), found.end());
+        return;
+    }
+
+    // Workers claim chunks round-robin and keep their errors per chunk so
+    // they can be merged back in input order
+    std::vector<std::vector<DateError>> chunk_errors(chunks);
+    auto work = [&](unsigned worker) {
+        for (size_t chunk = worker; chunk < chunks; chunk += threads) {
+            size_t start = chunk * PARSE_CHUNK;
+            size_t length = std::min(PARSE_CHUNK, count - start);
+            parse_chunk(texts + start, length, keys + start, chunk_errors[chunk]);
+            for (DateError& error : chunk_errors[chunk]) {
+                error.index += start;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned worker = 1; worker < threads; worker++) {
+        workers.emplace_back(work, worker);
+    }
+    work(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (std::vector<DateError>& found : chunk_errors) {
+        errors.insert(errors.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+    }
+}
+// --------------------------------------------------------------------------------
+
+std::string format_due_key(DueKey key)
+{
+    if (key == INVALID_DUE_KEY || key < 0)
+        return "invalid";
+
+    int minute = static_cast<int>(key % 100);
+    int hour = static_cast<int>(key / 100 % 100);
+    int day = static_cast<int>(key / 10000 % 100);
+    int month = static_cast<int>(key / 1000000 % 100);
+    int year = static_cast<int>(key / 100000000);
+
+    char buffer[32];
+    if (hour == 0 && minute == 0)
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+    else
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02dT%02d:%02d", year, month, day, hour, minute);
+    return buffer;
+}
+// --------------------------------------------------------------------------------
+
+int64_t days_from_civil(int year, int month, int day)
+{
+    // Howard Hinnant's days_from_civil: shift the year to start in March so
+    // the leap day falls at the end
+    int64_t y = year - (month <= 2 ? 1 : 0);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t year_of_era = y - era * 400;
+    int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+// --------------------------------------------------------------------------------
+
+DueKey due_key_from_days(int64_t days, int hour, int minute)
+{
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t day_of_era = days - era * 146097;
+    int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int64_t mp = (5 * day_of_year + 2) / 153;
+    int64_t day = day_of_year - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+    return (((year * 100 + month) * 100 + day) * 100 + hour) * 100 + minute;
+}
+// --------------------------------------------------------------------------------
+
+int64_t due_key_to_minutes(DueKey key)
+{
+    int minute = static_cast<int>(key % 100);
+    int hour = static_cast<int>(key / 100 % 100);
+    int day = static_cast<int>(key / 10000 % 100);
+    int month = static_cast<int>(key / 1000000 % 100);
+    int year = static_cast<int>(key / 100000000);
+    return days_from_civil(year, month, day) * 1440 + hour * 60 + minute;
+}
+// --------------------------------------------------------------------------------
+
+DueKey due_key_from_minutes(int64_t minutes)
+{
+    int64_t days = minutes >= 0 ? minutes / 1440 : -((-minutes + 1439) / 1440);
+    int64_t minute_of_day = minutes - days * 1440;
+    return due_key_from_days(days, static_cast<int>(minute_of_day / 60), static_cast<int>(minute_of_day % 60));
+}
+// ================================================================================
+// ================================================================================
+//eof
@@ -12,17 +12,97 @@
 // ================================================================================
 
 #include "include/db.hpp"
+#include "include/date_key.hpp"
+#include "include/metrics.hpp"
+#include "include/schema.hpp"
 #include <stdio.h>
+#include <cstdio>
 #include <iostream>
-#include "/usr/include/sqlite3.h"
+#include <sqlite3.h>
 #include <exception>
-#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 // ================================================================================
 // ================================================================================
 
+// sqlite3_step for statements that write; times the step and counts the
+// rows it changed.
+static int step_write(sqlite3_stmt* stmt)
+{
+    PLANNER_TIMED(Step);
+    int step_rc = sqlite3_step(stmt);
+    if (step_rc == SQLITE_DONE)
+        PLANNER_COUNT(RowsWritten, sqlite3_changes(sqlite3_db_handle(stmt)));
+    return step_rc;
+}
+// --------------------------------------------------------------------------------
+
+// Turns a user's search text into an FTS5 MATCH expression.  Every word or
+// "quoted phrase" becomes an FTS5 string, so punctuation and FTS5 keywords
+// (AND, NEAR, column filters) in the text match literally; a trailing * asks
+// for a prefix.  The terms are ANDed.  False if nothing searchable is left.
+static bool build_match_expression(std::string_view query, std::string& match)
+{
+    match.clear();
+    size_t i = 0;
+    while (i < query.size()) {
+        if (query[i] == ' ' || query[i] == '\t') {
+            i++;
+            continue;
+        }
+
+        std::string_view term;
+        if (query[i] == '"') {
+            size_t close = std::min(query.find('"', i + 1), query.size());
+            term = query.substr(i + 1, close - i - 1);
+            i = std::min(close + 1, query.size());
+        }
+        else {
+            size_t end = std::min(query.find_first_of(" \t\"", i), query.size());
+            term = query.substr(i, end - i);
+            i = end;
+        }
+
+        bool prefix = false;
+        if (i < query.size() && query[i] == '*') {
+            prefix = true;
+            i++;
+        }
+        while (!term.empty() && term.back() == '*') {
+            prefix = true;
+            term.remove_suffix(1);
+        }
+
+        // A term of nothing but ASCII punctuation has no tokens to match
+        bool searchable = std::any_of(term.begin(), term.end(), [](char c) {
+            return static_cast<unsigned char>(c) >= 0x80 || std::isalnum(static_cast<unsigned char>(c));
+        });
+        if (!searchable)
+            continue;
+
+        if (!match.empty())
+            match += ' ';
+        match += '"';
+        for (char c : term) {
+            if (c == '"')
+                match += '"';
+            match += c;
+        }
+        match += '"';
+        if (prefix)
+            match += " *";
+    }
+    return !match.empty();
+}
+// --------------------------------------------------------------------------------
+
 void DB::checkDBErrors() {
     if( rc ){
+        PLANNER_COUNT(DBErrors, 1);
         // Show error message
         std::cout << "DB Error: " << sqlite3_errmsg(db) << std::endl;
         closeDB();
@@ -30,33 +110,199 @@ void DB::checkDBErrors() {
 }
 // --------------------------------------------------------------------------------
 
-int DB::callback(void* not_used, int argc, char** argv, char** azColName)
+TaskRow RowView::materialize() const
 {
-     // Print column headers
-    static bool headersPrinted = false;
+    return TaskRow{id, std::string(task), due_key, priority};
+}
+// --------------------------------------------------------------------------------
 
-    // Print column headers and separator only once
-    if (!headersPrinted) {
-        for (int i = 0; i < argc; i++) {
-            std::cout << std::setw(20) << azColName[i] << " | ";
-        }
-        std::cout << std::endl;
+TaskCursor::TaskCursor(Statement statement, int error_rc) :
+    statement(std::move(statement)),
+    rc(error_rc),
+    current{0, {}, {}, INVALID_DUE_KEY, MIN_PRIORITY},
+    rows_read(0),
+    parse_dates(true)
+{
+}
+// --------------------------------------------------------------------------------
 
-        for (int i = 0; i < argc; i++) {
-            std::cout << std::setw(20) << std::setfill('-') << "" << " | ";
+void TaskCursor::setParseDates(bool parse)
+{
+    parse_dates = parse;
+}
+// --------------------------------------------------------------------------------
+
+bool TaskCursor::next()
+{
+    if (!statement)
+        return false;
+
+    sqlite3_stmt* stmt = statement.get();
+    int step_rc = sqlite3_step(stmt);
+    if (step_rc != SQLITE_ROW) {
+        if (step_rc != SQLITE_DONE) {
+            rc = step_rc;
+            PLANNER_COUNT(DBErrors, 1);
+            std::cerr << "Error reading planner: " << sqlite3_errmsg(sqlite3_db_handle(stmt)) << std::endl;
         }
-        std::cout << std::endl;
+        PLANNER_COUNT(RowsScanned, rows_read);
+        statement.release();
+        return false;
+    }
+    rows_read++;
+
+    // Views straight into the statement's column buffers, nothing is copied
+    const char* task = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    const char* due_date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+    current.id = sqlite3_column_int(stmt, 0);
+    current.task = task ? std::string_view(task, sqlite3_column_bytes(stmt, 1)) : std::string_view();
+    current.due_date = due_date ? std::string_view(due_date, sqlite3_column_bytes(stmt, 2)) : std::string_view();
+    if (sqlite3_column_type(stmt, 3) == SQLITE_INTEGER)
+        current.due_key = static_cast<DueKey>(sqlite3_column_int64(stmt, 3));
+    else
+        current.due_key = parse_dates ? parse_due_key(current.due_date) : INVALID_DUE_KEY;
+    current.priority = sqlite3_column_int(stmt, 4);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+const RowView& TaskCursor::row() const
+{
+    return current;
+}
+// --------------------------------------------------------------------------------
+
+int TaskCursor::status() const
+{
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+TaskCursor::iterator TaskCursor::begin()
+{
+    return next() ? iterator(this) : end();
+}
+// --------------------------------------------------------------------------------
+
+TaskCursor::iterator TaskCursor::end()
+{
+    return iterator(nullptr);
+}
+// --------------------------------------------------------------------------------
+
+TaskCursor::iterator& TaskCursor::iterator::operator++()
+{
+    if (!cursor->next())
+        cursor = nullptr;
+    return *this;
+}
+// ================================================================================
+// ================================================================================
+
+int DB::execSQL(const std::string& sql)
+{
+    PLANNER_TIMED(Exec);
+    rc = sqlite3_exec(db, sql.c_str(), NULL, 0, &error_msg);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error executing \"" << sql << "\": "
+                  << (error_msg ? error_msg : sqlite3_errmsg(db)) << std::endl;
+        sqlite3_free(error_msg);
+        error_msg = nullptr;
+    }
+    return rc;
+}
+// --------------------------------------------------------------------------------
 
-        headersPrinted = true;
+int DB::applyOptions()
+{
+    if (options.busy_timeout_ms > 0) {
+        sqlite3_busy_timeout(db, options.busy_timeout_ms);
     }
 
-    // Print rows
-    for (int i = 0; i < argc; i++) {
-        std::cout << std::setw(20) << std::setfill(' ') << (argv[i] ? argv[i] : "NULL") << " | ";
+    // The journal mode is stored in the file, only a writer can change it
+    if (options.wal && !options.read_only) {
+        rc = execSQL("PRAGMA journal_mode=WAL;");
+        if (rc != SQLITE_OK)
+            return rc;
+    }
+    if (!options.synchronous.empty()) {
+        rc = execSQL("PRAGMA synchronous=" + options.synchronous + ";");
+        if (rc != SQLITE_OK)
+            return rc;
+    }
+    if (options.mmap_size >= 0) {
+        rc = execSQL("PRAGMA mmap_size=" + std::to_string(options.mmap_size) + ";");
+        if (rc != SQLITE_OK)
+            return rc;
+    }
+    if (options.cache_size != 0) {
+        rc = execSQL("PRAGMA cache_size=" + std::to_string(options.cache_size) + ";");
+        if (rc != SQLITE_OK)
+            return rc;
     }
-    std::cout << std::endl;
+    return rc = SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
 
-    return 0;
+int DB::prepare(const std::string& sql, Statement& statement)
+{
+    return rc = statements.acquire(db, sql, statement);
+}
+// --------------------------------------------------------------------------------
+
+int DB::bindDueKey(sqlite3_stmt* stmt, int index, const std::string& due_date)
+{
+    DueKey due_key = parse_due_key(due_date);
+    if (due_key == INVALID_DUE_KEY) {
+        return sqlite3_bind_null(stmt, index);
+    }
+    return sqlite3_bind_int64(stmt, index, due_key);
+}
+// --------------------------------------------------------------------------------
+
+int DB::runSearch(const std::string& query, int limit, bool ranged, DueKey from, DueKey to,
+                  std::vector<TaskRow>& rows)
+{
+    std::string match;
+    if (!build_match_expression(query, match)) {
+        std::cerr << "Error: nothing to search for in \"" << query << "\"" << std::endl;
+        return rc = SQLITE_MISUSE;
+    }
+
+    // bm25 first; equally good matches fall back on the planner's own order
+    // (invalid due dates last)
+    std::string sql = "SELECT PLANNER.ID, PLANNER.TASK, PLANNER.DUE_DATE, PLANNER.DUE_KEY, PLANNER.PRIORITY "
+                      "FROM PLANNER_FTS JOIN PLANNER ON PLANNER.ID = PLANNER_FTS.rowid "
+                      "WHERE PLANNER_FTS MATCH ? ";
+    if (ranged) {
+        sql += "AND PLANNER.ORDER_KEY >= ? AND PLANNER.ORDER_KEY < ? ";
+    }
+    sql += "ORDER BY PLANNER_FTS.rank, PLANNER.ORDER_KEY IS NULL, PLANNER.ORDER_KEY, PLANNER.ID LIMIT ?;";
+
+    Statement stmt;
+    rc = prepare(sql, stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing search query: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+
+    int index = 1;
+    sqlite3_bind_text(stmt.get(), index++, match.c_str(), static_cast<int>(match.size()), SQLITE_TRANSIENT);
+    if (ranged) {
+        sqlite3_bind_int64(stmt.get(), index++, make_order_key(from, MAX_PRIORITY));
+        sqlite3_bind_int64(stmt.get(), index++, make_order_key(to, MAX_PRIORITY));
+    }
+    sqlite3_bind_int(stmt.get(), index, limit);
+    return collectTasks(TaskCursor(std::move(stmt)), rows);
+}
+// --------------------------------------------------------------------------------
+
+int DB::collectTasks(TaskCursor cursor, std::vector<TaskRow>& rows)
+{
+    for (const RowView& row : cursor) {
+        rows.push_back(row.materialize());
+    }
+    return rc = cursor.status();
 }
 // --------------------------------------------------------------------------------
 // --------------------------------------------------------------------------------
@@ -64,24 +310,40 @@ int DB::callback(void* not_used, int argc, char** argv, char** azColName)
 
  //   public:
 
-DB::DB(std::string filename) : 
-    filename(filename),
+DB::DB(std::string filename) : DB(filename, DBOptions())
+{
+}
+// --------------------------------------------------------------------------------
+
+DB::DB(std::string filename, const DBOptions& options) : 
     error_msg(nullptr),
-    rc(0) 
+    rc(0),
+    filename(filename),
+    options(options),
+    data_version(-1)
 {
-    rc = sqlite3_open(filename.c_str(), &db);
+    int flags = options.read_only ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    rc = sqlite3_open_v2(filename.c_str(), &db, flags, NULL);
     checkDBErrors();
+    if (db) {
+        rc = applyOptions();
+        checkDBErrors();
+    }
 }
 // --------------------------------------------------------------------------------
 DB::~DB()
 {
     DB::closeDB();
-    std::cout << "Planner has been successfully closed.\n";
+    if (!options.quiet) {
+        std::cout << "Planner has been successfully closed.\n";
+    }
 }
 // --------------------------------------------------------------------------------
 
 void DB::closeDB(){
     if (db) {
+        // Cached statements would keep the connection from closing
+        statements.clear();
         sqlite3_close(db);
         db = nullptr;
     }
@@ -90,19 +352,21 @@ void DB::closeDB(){
 
 int DB::createPlanner() 
 {
-    std::string sql = "CREATE TABLE IF NOT EXISTS PLANNER("
-                        "ID INTEGER PRIMARY KEY, "
-                        "TASK TEXT NOT NULL, "
-                        "DUE_DATE VARCHAR(10) );";
+    return migrate(MigrationOptions());
+}
+// --------------------------------------------------------------------------------
 
-rc = sqlite3_exec(db, sql.c_str(), NULL, 0, &error_msg);
-if (rc != SQLITE_OK) {
-        std::cerr << "Error creating table: " << sqlite3_errmsg(db) << std::endl;
-        closeDB(); 
-        return rc; 
+int DB::migrate(const MigrationOptions& migration)
+{
+    SchemaMigrator migrator(*this, migration);
+    rc = migrator.migrate();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    if (!options.quiet) {
+        std::cout << "Table created successfully" << std::endl;
     }
-std::cout << "Table created successfully" << std::endl;
-return SQLITE_OK;
+    return SQLITE_OK;
 }
 // --------------------------------------------------------------------------------
 
@@ -110,9 +374,9 @@ return SQLITE_OK;
 int DB::insertTask(std::string& task, std::string& due_date)
 {
     // Prepare SQL Statement with Placeholders
-    std::string sql = "INSERT INTO PLANNER (ID, TASK, DUE_DATE) VALUES (NULL, ?, ?);";
-    sqlite3_stmt* stmt;
-    rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL);
+    std::string sql = "INSERT INTO PLANNER (ID, TASK, DUE_DATE, DUE_KEY) VALUES (NULL, ?, ?, ?);";
+    Statement stmt;
+    rc = prepare(sql, stmt);
     if (rc != SQLITE_OK) {
         // Handle error
         std::cerr << "Error preparing SQL statement: " << sqlite3_errmsg(db) << std::endl;
@@ -120,162 +384,1042 @@ int DB::insertTask(std::string& task, std::string& due_date)
     }
 
     // Bind Parameters
-    rc = sqlite3_bind_text(stmt, 1, task.c_str(), -1, SQLITE_STATIC);
+    rc = sqlite3_bind_text(stmt.get(), 1, task.c_str(), -1, SQLITE_STATIC);
     if (rc != SQLITE_OK) {
         // Handle error
         std::cerr << "Error binding parameter 1: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt); // Clean up resources
         return rc; // Return error code
     }
 
-    rc = sqlite3_bind_text(stmt, 2, due_date.c_str(), -1, SQLITE_STATIC);
+    rc = sqlite3_bind_text(stmt.get(), 2, due_date.c_str(), -1, SQLITE_STATIC);
     if (rc != SQLITE_OK) {
         // Handle error
         std::cerr << "Error binding parameter 1: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt); // Clean up resources
+        return rc; // Return error code
+    }
+
+    rc = bindDueKey(stmt.get(), 3, due_date);
+    if (rc != SQLITE_OK) {
+        // Handle error
+        std::cerr << "Error binding parameter 3: " << sqlite3_errmsg(db) << std::endl;
         return rc; // Return error code
     }
 
     // Execute the statement
-    rc = sqlite3_step(stmt);
+    rc = step_write(stmt.get());
     if (rc != SQLITE_DONE) {
         // Handle error
         std::cerr << "Error executing SQL statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt); // Clean up resources
         return rc; // Return error code
     }
 
-    //Finalize the statement
-    sqlite3_finalize(stmt);
-    std::cout << "Row inserted successfully\n";
+    if (!options.quiet) {
+        std::cout << "Row inserted successfully\n";
+    }
+
+    notifyInserted(static_cast<int>(sqlite3_last_insert_rowid(db)), task, due_date, MIN_PRIORITY);
     return SQLITE_OK;
 }   
 // --------------------------------------------------------------------------------
 
-int DB::completeTask(int row_num)
+int DB::completeTask(int id)
 {
+    // A plain task is a single primary-key delete; only the occurrence of a
+    // recurring task needs a transaction around the delete and the insert
+    RecurrenceRule rule;
+    int found = findRecurrence(id, rule);
+    if (found != SQLITE_ROW && found != SQLITE_DONE) {
+        return rc = found;
+    }
+    bool recurring = (found == SQLITE_ROW);
+    if (recurring) {
+        rc = beginTransaction();
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+
+        // Another connection may have completed this occurrence since the
+        // look above, so the rule that is advanced is read in the transaction
+        found = findRecurrence(id, rule);
+        if (found != SQLITE_ROW && found != SQLITE_DONE) {
+            rollbackTransaction();
+            return rc = found;
+        }
+    }
+
+    // IDs are stable: completing a task is a single primary-key delete and
+    // never touches the rows after it.
     std::string sql_delete = "DELETE FROM PLANNER WHERE ID = (?);";
-    sqlite3_stmt* stmt_delete;
-    rc = sqlite3_prepare_v2(db, sql_delete.c_str(), -1, &stmt_delete, NULL);
+    Statement stmt_delete;
+    rc = prepare(sql_delete, stmt_delete);
     if (rc != SQLITE_OK) {
         std::cerr << "Error preparing delete statement: " << sqlite3_errmsg(db) << std::endl;
-        return rc;
     }
 
-    rc = sqlite3_bind_int(stmt_delete, 1, row_num);
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_bind_int(stmt_delete.get(), 1, id);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Error binding parameter for delete statement: " << sqlite3_errmsg(db) << std::endl;
+        }
+    }
+
+    bool deleted = false;
+    if (rc == SQLITE_OK) {
+        rc = step_write(stmt_delete.get());
+        if (rc != SQLITE_DONE) {
+            std::cerr << "Error executing delete statement: " << sqlite3_errmsg(db) << std::endl;
+        }
+        else {
+            rc = SQLITE_OK;
+            deleted = sqlite3_changes(db) > 0;
+        }
+    }
+
+    // Only the connection whose delete removed the occurrence schedules the
+    // next one; any other would leave a second "next" row behind
+    std::vector<std::pair<int, Task>> inserted;
+    if (rc == SQLITE_OK && deleted && found == SQLITE_ROW) {
+        rc = advanceRecurrence(rule, inserted);
+    }
+    if (rc == SQLITE_OK && recurring) {
+        rc = commitTransaction();
+    }
     if (rc != SQLITE_OK) {
-        std::cerr << "Error binding parameter for delete statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt_delete);
-        return rc;
+        int complete_rc = rc;
+        if (recurring) {
+            rollbackTransaction();
+        }
+        return rc = complete_rc;
     }
 
-    rc = sqlite3_step(stmt_delete);
-    if (rc != SQLITE_DONE) {
-        std::cerr << "Error executing delete statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt_delete);
-        return rc;
+    if (!options.quiet) {
+        std::cout << "Delete successful.\n";
     }
 
-    sqlite3_finalize(stmt_delete);
+    // An ID that was not there changed nothing the observers hold
+    if (deleted) {
+        notifyCompleted(id);
+    }
+    for (auto& [next_id, next] : inserted) {
+        notifyInserted(next_id, next.task, next.due_date, next.priority);
+    }
 
-    // Update the IDs of remaining rows
-    std::string sql_update = "UPDATE PLANNER SET ID = ID - 1 WHERE ID > ?;";
-    sqlite3_stmt* stmt_update;
-    rc = sqlite3_prepare_v2(db, sql_update.c_str(), -1, &stmt_update, NULL);
+    return rc = SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int DB::completeTasks(const std::vector<int>& ids, int* completed)
+{
+    if (ids.empty()) {
+        return SQLITE_OK;
+    }
+
+    std::string sql_delete = "DELETE FROM PLANNER WHERE ID = (?);";
+    Statement stmt_delete;
+    rc = prepare(sql_delete, stmt_delete);
     if (rc != SQLITE_OK) {
-        std::cerr << "Error preparing update statement: " << sqlite3_errmsg(db) << std::endl;
+        std::cerr << "Error preparing delete statement: " << sqlite3_errmsg(db) << std::endl;
         return rc;
     }
 
-    rc = sqlite3_bind_int(stmt_update, 1, row_num);
+    rc = beginTransaction();
     if (rc != SQLITE_OK) {
-        std::cerr << "Error binding parameter for update statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt_update);
         return rc;
     }
 
-    rc = sqlite3_step(stmt_update);
-    if (rc != SQLITE_DONE) {
-        std::cerr << "Error executing update statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt_update);
-        return rc;
+    std::vector<std::pair<int, Task>> inserted;
+    std::vector<int> deleted_ids;
+    for (int id : ids) {
+        RecurrenceRule rule;
+        int found = findRecurrence(id, rule);
+        rc = (found == SQLITE_ROW || found == SQLITE_DONE) ? SQLITE_OK : found;
+        if (rc == SQLITE_OK) {
+            sqlite3_reset(stmt_delete.get());
+            rc = sqlite3_bind_int(stmt_delete.get(), 1, id);
+        }
+        bool deleted = false;
+        if (rc == SQLITE_OK) {
+            rc = step_write(stmt_delete.get());
+            rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+            deleted = rc == SQLITE_OK && sqlite3_changes(db) > 0;
+        }
+        if (deleted) {
+            deleted_ids.push_back(id);
+        }
+        if (rc == SQLITE_OK && deleted && found == SQLITE_ROW) {
+            rc = advanceRecurrence(rule, inserted);
+        }
+        if (rc != SQLITE_OK) {
+            int delete_rc = rc;
+            std::cerr << "Error executing delete statement: " << sqlite3_errmsg(db) << std::endl;
+            rollbackTransaction();
+            return rc = delete_rc;
+        }
     }
 
-    sqlite3_finalize(stmt_update);
-    std::cout << "Delete successful.\n";
+    for (int id : deleted_ids) {
+        notifyCompleted(id);
+    }
+    for (auto& [next_id, next] : inserted) {
+        notifyInserted(next_id, next.task, next.due_date, next.priority);
+    }
 
+    rc = commitTransaction();
+    if (rc != SQLITE_OK) {
+        int commit_rc = rc;
+        rollbackTransaction();
+        return rc = commit_rc;
+    }
+
+    if (completed) {
+        *completed = static_cast<int>(deleted_ids.size());
+    }
+    if (!options.quiet) {
+        std::cout << "Delete successful.\n";
+    }
     return SQLITE_OK;
 }
 // --------------------------------------------------------------------------------
 
 int DB::printPlanner()
 { 
-    std::string sql = "SELECT * FROM PLANNER;";
+    TaskCursor cursor = scanTasks();
 
-    sqlite3_exec(db, sql.c_str(), callback, NULL, NULL);
+    // Cells are padded by hand into one buffer that is flushed in large
+    // chunks instead of formatting every cell through the stream.
+    const size_t width = 20;
+    const size_t flush_size = 1 << 16;
+    std::string out;
+    out.reserve(flush_size + 256);
+
+    auto append_cell = [&out, width](std::string_view value) {
+        if (value.size() < width)
+            out.append(width - value.size(), ' ');
+        out.append(value);
+        out.append(" | ");
+    };
+
+    // "#" is the display position, computed while streaming so nothing has
+    // to be renumbered when a task is completed.  ID is the stable key.
+    append_cell("#");
+    append_cell("ID");
+    append_cell("TASK");
+    append_cell("DUE_DATE");
+    out.push_back('\n');
+    for (int i = 0; i < 4; i++) {
+        out.append(width, '-');
+        out.append(" | ");
+    }
+    out.push_back('\n');
 
-    return 0;
+    char number_buffer[16];
+    int ordinal = 0;
+    for (const RowView& row : cursor) {
+        int length = std::snprintf(number_buffer, sizeof(number_buffer), "%d", ++ordinal);
+        append_cell(std::string_view(number_buffer, length));
+        length = std::snprintf(number_buffer, sizeof(number_buffer), "%d", row.id);
+        append_cell(std::string_view(number_buffer, length));
+        append_cell(row.task);
+        append_cell(row.due_date.data() ? row.due_date : std::string_view("NULL"));
+        out.push_back('\n');
+
+        if (out.size() >= flush_size) {
+            std::cout.write(out.data(), out.size());
+            out.clear();
+        }
+    }
+    std::cout.write(out.data(), out.size());
+    std::cout.flush();
+
+    return rc = cursor.status();
 }
 // --------------------------------------------------------------------------------
 
 int DB::updatePlanner(UpdateRow& updated_row)
 {
- std::string sql = "UPDATE PLANNER SET " + updated_row.set_column_name + " = ? WHERE " +
-                      updated_row.id_column_name + " = ?;";
+ std::string sql = "UPDATE PLANNER SET " + updated_row.set_column_name + " = ?1 WHERE " +
+                      updated_row.id_column_name + " = ?2;";
+
+    // A new due date also refreshes its integer key
+    bool sets_due_date = sqlite3_stricmp(updated_row.set_column_name.c_str(), "DUE_DATE") == 0;
+    if (sets_due_date) {
+        sql = "UPDATE PLANNER SET DUE_DATE = ?1, DUE_KEY = ?3 WHERE " +
+              updated_row.id_column_name + " = ?2;";
+    }
 
     // Prepare SQL Statement with Placeholders
-    sqlite3_stmt* stmt;
-    rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL);
+    Statement stmt;
+    rc = prepare(sql, stmt);
     if (rc != SQLITE_OK) {
         std::cerr << "Error preparing update statement: " << sqlite3_errmsg(db) << std::endl;
         return rc;
     }
 
     // Bind Parameters
-    rc = sqlite3_bind_text(stmt, 1, updated_row.set_new_value.c_str(), -1, SQLITE_STATIC);
+    rc = sqlite3_bind_text(stmt.get(), 1, updated_row.set_new_value.c_str(), -1, SQLITE_STATIC);
     if (rc != SQLITE_OK) {
         std::cerr << "Error binding parameter for update statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt);
         return rc;
     }
 
-    rc = sqlite3_bind_text(stmt, 2, updated_row.id_column_value.c_str(), -1, SQLITE_STATIC);
+    rc = sqlite3_bind_text(stmt.get(), 2, updated_row.id_column_value.c_str(), -1, SQLITE_STATIC);
     if (rc != SQLITE_OK) {
         std::cerr << "Error binding parameter for update statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt);
         return rc;
     }
 
+    if (sets_due_date) {
+        rc = bindDueKey(stmt.get(), 3, updated_row.set_new_value);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Error binding parameter for update statement: " << sqlite3_errmsg(db) << std::endl;
+            return rc;
+        }
+    }
+
     // Execute the statement
-    rc = sqlite3_step(stmt);
+    rc = step_write(stmt.get());
     if (rc != SQLITE_DONE) {
         std::cerr << "Error executing update statement: " << sqlite3_errmsg(db) << std::endl;
-        sqlite3_finalize(stmt);
         return rc;
     }
 
-    //Finalize the statement and close db
-    sqlite3_finalize(stmt);
-    std::cout << "Update successful\n";
+    if (!options.quiet) {
+        std::cout << "Update successful\n";
+    }
+
+    notifyUpdated(updated_row);
 
     return SQLITE_OK;       
 }
 // --------------------------------------------------------------------------------
 
-int DB::bulkInsertTasks(std::vector<Task>& tasks)
+int DB::setPriority(int id, int priority)
 {
-    for(auto& task : tasks)
+    if (priority < MIN_PRIORITY || priority > MAX_PRIORITY) {
+        std::cerr << "Error: priority must be between " << MIN_PRIORITY << " and " << MAX_PRIORITY << std::endl;
+        return rc = SQLITE_RANGE;
+    }
+    UpdateRow update{"PRIORITY", std::to_string(priority), "ID", std::to_string(id)};
+    return updatePlanner(update);
+}
+// --------------------------------------------------------------------------------
+
+int DB::bulkInsertTasks(std::vector<Task>& tasks, int batch_size)
+{
+    if (tasks.empty()) {
+        return SQLITE_OK;
+    }
+    for (const Task& task : tasks) {
+        if (task.priority < MIN_PRIORITY || task.priority > MAX_PRIORITY) {
+            std::cerr << "Error: priority must be between " << MIN_PRIORITY << " and " << MAX_PRIORITY << std::endl;
+            return rc = SQLITE_RANGE;
+        }
+    }
+
+    // Full chunks go through one multi-row INSERT, the rest row by row.  Each
+    // statement that fires the search index triggers costs a fixed FTS5
+    // flush (at its statement savepoint), so loading INSERT_CHUNK rows per
+    // statement keeps bulk loads near their unindexed speed.
+    const size_t INSERT_CHUNK = 256;
+    std::string single_sql = "INSERT INTO PLANNER (ID, TASK, DUE_DATE, DUE_KEY, PRIORITY) VALUES (NULL, ?, ?, ?, ?);";
+    std::string chunk_sql = "INSERT INTO PLANNER (ID, TASK, DUE_DATE, DUE_KEY, PRIORITY) VALUES (NULL, ?, ?, ?, ?)";
+    for (size_t i = 1; i < INSERT_CHUNK; i++) {
+        chunk_sql += ", (NULL, ?, ?, ?, ?)";
+    }
+    chunk_sql += ";";
+
+    Statement single, chunk;
+    rc = prepare(single_sql, single);
+    if (rc == SQLITE_OK) {
+        rc = prepare(chunk_sql, chunk);
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing SQL statement: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+
+    size_t batch = batch_size > 0 ? static_cast<size_t>(batch_size) : tasks.size();
+
+    for (size_t batch_start = 0; batch_start < tasks.size(); batch_start += batch)
     {
-        rc = insertTask(task.task, task.due_date);
-        // checkDBErrors();
-        if(rc != SQLITE_OK) {
-            std::cerr << "Error inserting task: " << sqlite3_errmsg(db) << std::endl;
-            return rc; // Return the error code
+        size_t batch_end = std::min(tasks.size(), batch_start + batch);
+        rc = beginTransaction();
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+
+        for (size_t i = batch_start; i < batch_end; ) {
+            size_t rows = batch_end - i >= INSERT_CHUNK ? INSERT_CHUNK : 1;
+            sqlite3_stmt* stmt = rows == INSERT_CHUNK ? chunk.get() : single.get();
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+
+            int param = 1;
+            for (size_t row = i; row < i + rows && rc == SQLITE_OK; row++) {
+                rc = sqlite3_bind_text(stmt, param++, tasks[row].task.c_str(), -1, SQLITE_STATIC);
+                if (rc == SQLITE_OK) {
+                    rc = sqlite3_bind_text(stmt, param++, tasks[row].due_date.c_str(), -1, SQLITE_STATIC);
+                }
+                if (rc == SQLITE_OK) {
+                    rc = bindDueKey(stmt, param++, tasks[row].due_date);
+                }
+                if (rc == SQLITE_OK) {
+                    rc = sqlite3_bind_int(stmt, param++, tasks[row].priority);
+                }
+            }
+            if (rc == SQLITE_OK) {
+                rc = step_write(stmt);
+                rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+            }
+            if (rc != SQLITE_OK) {
+                int insert_rc = rc;
+                std::cerr << "Error inserting task: " << sqlite3_errmsg(db) << std::endl;
+                rollbackTransaction();
+                return rc = insert_rc; // Return the error code
+            }
+
+            // Rows inserted with a NULL ID take consecutive IDs after the
+            // largest one ever used, so the last ID gives away the whole
+            // chunk's.  The
+            // observers hear about them once the batch is committed.
+            if (!observers.empty()) {
+                int last_id = static_cast<int>(sqlite3_last_insert_rowid(db));
+                for (size_t row = 0; row < rows; row++) {
+                    notifyInserted(last_id - static_cast<int>(rows - 1 - row), tasks[i + row].task,
+                                   tasks[i + row].due_date, tasks[i + row].priority);
+                }
+            }
+            i += rows;
+        }
+
+        rc = commitTransaction();
+        if (rc != SQLITE_OK) {
+            int commit_rc = rc;
+            rollbackTransaction();
+            return rc = commit_rc;
         }
     }
-    std::cout << "Bulk insert successful\n";   
+
+    if (!options.quiet) {
+        std::cout << "Bulk insert successful\n";
+    }
     return SQLITE_OK;
 }
+// --------------------------------------------------------------------------------
+
+int DB::nextTasks(int count, std::vector<TaskRow>& rows)
+{
+    std::string sql = "SELECT ID, TASK, DUE_DATE, DUE_KEY, PRIORITY FROM PLANNER WHERE ORDER_KEY IS NOT NULL "
+                      "ORDER BY ORDER_KEY, ID LIMIT ?;";
+    Statement stmt;
+    rc = prepare(sql, stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing next tasks query: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+
+    sqlite3_bind_int(stmt.get(), 1, count);
+    return collectTasks(TaskCursor(std::move(stmt)), rows);
+}
+// --------------------------------------------------------------------------------
+
+int DB::tasksDueBetween(DueKey from, DueKey to, std::vector<TaskRow>& rows)
+{
+    // Every order key of a due key d lies in [d * 256, (d + 1) * 256)
+    std::string sql = "SELECT ID, TASK, DUE_DATE, DUE_KEY, PRIORITY FROM PLANNER WHERE ORDER_KEY >= ? AND ORDER_KEY < ? "
+                      "ORDER BY ORDER_KEY, ID;";
+    Statement stmt;
+    rc = prepare(sql, stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing due range query: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+
+    sqlite3_bind_int64(stmt.get(), 1, make_order_key(from, MAX_PRIORITY));
+    sqlite3_bind_int64(stmt.get(), 2, make_order_key(to, MAX_PRIORITY));
+    return collectTasks(TaskCursor(std::move(stmt)), rows);
+}
+// --------------------------------------------------------------------------------
+
+int DB::overdueTasks(DueKey as_of, std::vector<TaskRow>& rows)
+{
+    std::string sql = "SELECT ID, TASK, DUE_DATE, DUE_KEY, PRIORITY FROM PLANNER WHERE ORDER_KEY < ? "
+                      "ORDER BY ORDER_KEY, ID;";
+    Statement stmt;
+    rc = prepare(sql, stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing overdue query: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+
+    sqlite3_bind_int64(stmt.get(), 1, make_order_key(as_of, MAX_PRIORITY));
+    return collectTasks(TaskCursor(std::move(stmt)), rows);
+}
+// --------------------------------------------------------------------------------
+
+int DB::searchTasks(const std::string& query, int limit, std::vector<TaskRow>& rows)
+{
+    return runSearch(query, limit, false, INVALID_DUE_KEY, INVALID_DUE_KEY, rows);
+}
+// --------------------------------------------------------------------------------
+
+int DB::searchTasks(const std::string& query, int limit, DueKey from, DueKey to, std::vector<TaskRow>& rows)
+{
+    return runSearch(query, limit, true, from, to, rows);
+}
+// --------------------------------------------------------------------------------
+
+int DB::tasksById(const std::vector<int>& ids, std::vector<TaskRow>& rows)
+{
+    // One primary key lookup per ID through the same cached statement
+    for (int id : ids) {
+        Statement stmt;
+        rc = prepare("SELECT ID, TASK, DUE_DATE, DUE_KEY, PRIORITY FROM PLANNER WHERE ID = ?;", stmt);
+        if (rc != SQLITE_OK) {
+            std::cerr << "Error preparing task lookup: " << sqlite3_errmsg(db) << std::endl;
+            return rc;
+        }
+        sqlite3_bind_int(stmt.get(), 1, id);
+        rc = collectTasks(TaskCursor(std::move(stmt)), rows);
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+    }
+    return rc = SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+TaskCursor DB::scanTasks()
+{
+    // Planners opened without createPlanner may predate PRIORITY or even
+    // DUE_KEY; the missing columns read as defaults (dates are then parsed
+    // row by row)
+    static const char* const scans[] = {
+        "SELECT ID, TASK, DUE_DATE, DUE_KEY, PRIORITY FROM PLANNER ORDER BY ID;",
+        "SELECT ID, TASK, DUE_DATE, DUE_KEY, 0 FROM PLANNER ORDER BY ID;",
+        "SELECT ID, TASK, DUE_DATE, NULL, 0 FROM PLANNER ORDER BY ID;"
+    };
+    Statement stmt;
+    for (const char* sql : scans) {
+        rc = prepare(sql, stmt);
+        if (rc == SQLITE_OK)
+            break;
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing planner scan: " << sqlite3_errmsg(db) << std::endl;
+        return TaskCursor(Statement(), rc);
+    }
+    return TaskCursor(std::move(stmt));
+}
+// --------------------------------------------------------------------------------
+
+TaskCursor DB::scanTasksByDue()
+{
+    std::string sql = "SELECT ID, TASK, DUE_DATE, DUE_KEY, PRIORITY FROM PLANNER ORDER BY ORDER_KEY, ID;";
+    Statement stmt;
+    rc = prepare(sql, stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing planner scan: " << sqlite3_errmsg(db) << std::endl;
+        return TaskCursor(Statement(), rc);
+    }
+    return TaskCursor(std::move(stmt));
+}
+// --------------------------------------------------------------------------------
+
+long long DB::countTasks()
+{
+    Statement stmt;
+    rc = prepare("SELECT COUNT(*) FROM PLANNER;", stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing count: " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
+
+    long long count = -1;
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        count = sqlite3_column_int64(stmt.get(), 0);
+    }
+    return count;
+}
+// --------------------------------------------------------------------------------
+
+int DB::insertRow(const std::string& task, const std::string& due_date, int& id)
+{
+    Statement stmt;
+    rc = prepare("INSERT INTO PLANNER (ID, TASK, DUE_DATE, DUE_KEY) VALUES (NULL, ?, ?, ?);", stmt);
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_bind_text(stmt.get(), 1, task.c_str(), -1, SQLITE_STATIC);
+    }
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_bind_text(stmt.get(), 2, due_date.c_str(), -1, SQLITE_STATIC);
+    }
+    if (rc == SQLITE_OK) {
+        rc = bindDueKey(stmt.get(), 3, due_date);
+    }
+    if (rc == SQLITE_OK) {
+        rc = step_write(stmt.get());
+        rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error inserting task: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+    id = static_cast<int>(sqlite3_last_insert_rowid(db));
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+// Reads ID, TASK, START_KEY, FREQUENCY, EVERY, UNTIL_KEY, PENDING_ID,
+// PENDING_KEY from the current row.
+static void read_rule(sqlite3_stmt* stmt, RecurrenceRule& rule)
+{
+    const unsigned char* task = sqlite3_column_text(stmt, 1);
+    const unsigned char* frequency = sqlite3_column_text(stmt, 3);
+    rule.id = sqlite3_column_int(stmt, 0);
+    rule.task = task ? reinterpret_cast<const char*>(task) : "";
+    rule.start = sqlite3_column_int64(stmt, 2);
+    if (!frequency || !parse_frequency(reinterpret_cast<const char*>(frequency), rule.frequency))
+        rule.frequency = Frequency::Daily;
+    rule.interval = sqlite3_column_int(stmt, 4);
+    rule.until = sqlite3_column_type(stmt, 5) == SQLITE_INTEGER ? sqlite3_column_int64(stmt, 5) : INVALID_DUE_KEY;
+    rule.pending_id = sqlite3_column_int(stmt, 6);
+    rule.pending_key = sqlite3_column_type(stmt, 7) == SQLITE_INTEGER ? sqlite3_column_int64(stmt, 7) : INVALID_DUE_KEY;
+}
+// --------------------------------------------------------------------------------
+
+int DB::findRecurrence(int completed_id, RecurrenceRule& rule)
+{
+    Statement stmt;
+    if (prepare("SELECT ID, TASK, START_KEY, FREQUENCY, EVERY, UNTIL_KEY, PENDING_ID, PENDING_KEY "
+                "FROM RECURRENCE WHERE PENDING_ID = ?;", stmt) != SQLITE_OK) {
+        // Planners not set up by createPlanner have no RECURRENCE table
+        return rc = SQLITE_DONE;
+    }
+    sqlite3_bind_int(stmt.get(), 1, completed_id);
+    int step_rc = sqlite3_step(stmt.get());
+    if (step_rc == SQLITE_ROW) {
+        read_rule(stmt.get(), rule);
+    }
+    else if (step_rc != SQLITE_DONE) {
+        std::cerr << "Error reading recurrence: " << sqlite3_errmsg(db) << std::endl;
+    }
+    return rc = step_rc;
+}
+// --------------------------------------------------------------------------------
+
+int DB::advanceRecurrence(const RecurrenceRule& rule, std::vector<std::pair<int, Task>>& inserted)
+{
+    DueKey next_key = next_occurrence(rule, rule.pending_key);
+    Statement stmt;
+    if (next_key == INVALID_DUE_KEY) {
+        // The rule has run out
+        rc = prepare("DELETE FROM RECURRENCE WHERE ID = ?;", stmt);
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_int(stmt.get(), 1, rule.id);
+            rc = step_write(stmt.get());
+            rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+        }
+        return rc;
+    }
+
+    Task next{rule.task, format_due_key(next_key)};
+    int next_id = 0;
+    rc = insertRow(next.task, next.due_date, next_id);
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    rc = prepare("UPDATE RECURRENCE SET PENDING_ID = ?, PENDING_KEY = ? WHERE ID = ?;", stmt);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_int(stmt.get(), 1, next_id);
+        sqlite3_bind_int64(stmt.get(), 2, next_key);
+        sqlite3_bind_int(stmt.get(), 3, rule.id);
+        rc = step_write(stmt.get());
+        rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error advancing recurrence: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+    inserted.emplace_back(next_id, std::move(next));
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int DB::addRecurrence(RecurrenceRule& rule)
+{
+    if (rule.start == INVALID_DUE_KEY || rule.interval < 1 ||
+        (rule.until != INVALID_DUE_KEY && recurrence_end(rule) < rule.start)) {
+        std::cerr << "Error: a recurrence needs a valid start, an interval of at least 1 "
+                     "and an end date no earlier than the start" << std::endl;
+        return rc = SQLITE_MISUSE;
+    }
+
+    rc = beginTransaction();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+
+    Task first{rule.task, format_due_key(rule.start)};
+    int pending_id = 0;
+    rc = insertRow(first.task, first.due_date, pending_id);
+
+    Statement stmt;
+    if (rc == SQLITE_OK) {
+        rc = prepare("INSERT INTO RECURRENCE (ID, TASK, START_KEY, FREQUENCY, EVERY, UNTIL_KEY, PENDING_ID, PENDING_KEY) "
+                     "VALUES (NULL, ?, ?, ?, ?, ?, ?, ?);", stmt);
+    }
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_text(stmt.get(), 1, rule.task.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt.get(), 2, rule.start);
+        sqlite3_bind_text(stmt.get(), 3, frequency_name(rule.frequency), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt.get(), 4, rule.interval);
+        if (rule.until != INVALID_DUE_KEY)
+            sqlite3_bind_int64(stmt.get(), 5, rule.until);
+        else
+            sqlite3_bind_null(stmt.get(), 5);
+        sqlite3_bind_int(stmt.get(), 6, pending_id);
+        sqlite3_bind_int64(stmt.get(), 7, rule.start);
+        rc = step_write(stmt.get());
+        rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+    }
+    if (rc == SQLITE_OK) {
+        rule.id = static_cast<int>(sqlite3_last_insert_rowid(db));
+        rc = commitTransaction();
+    }
+    if (rc != SQLITE_OK) {
+        int add_rc = rc;
+        std::cerr << "Error adding recurrence: " << sqlite3_errmsg(db) << std::endl;
+        rollbackTransaction();
+        return rc = add_rc;
+    }
+
+    rule.pending_id = pending_id;
+    rule.pending_key = rule.start;
+    if (!options.quiet) {
+        std::cout << "Recurrence added successfully\n";
+    }
+    notifyInserted(pending_id, first.task, first.due_date, first.priority);
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int DB::listRecurrences(std::vector<RecurrenceRule>& rules)
+{
+    Statement stmt;
+    rc = prepare("SELECT ID, TASK, START_KEY, FREQUENCY, EVERY, UNTIL_KEY, PENDING_ID, PENDING_KEY "
+                 "FROM RECURRENCE ORDER BY ID;", stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing recurrence list: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+    int step_rc;
+    while ((step_rc = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+        RecurrenceRule rule;
+        read_rule(stmt.get(), rule);
+        rules.push_back(std::move(rule));
+    }
+    if (step_rc != SQLITE_DONE) {
+        std::cerr << "Error reading recurrences: " << sqlite3_errmsg(db) << std::endl;
+        return rc = step_rc;
+    }
+    return rc = SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int DB::removeRecurrence(int rule_id)
+{
+    Statement stmt;
+    rc = prepare("SELECT PENDING_ID FROM RECURRENCE WHERE ID = ?;", stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing recurrence lookup: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+    sqlite3_bind_int(stmt.get(), 1, rule_id);
+    int step_rc = sqlite3_step(stmt.get());
+    if (step_rc != SQLITE_ROW) {
+        if (step_rc == SQLITE_DONE)
+            std::cerr << "Error: no recurrence with ID " << rule_id << std::endl;
+        return rc = (step_rc == SQLITE_DONE ? SQLITE_NOTFOUND : step_rc);
+    }
+    int pending_id = sqlite3_column_int(stmt.get(), 0);
+    stmt.release();
+
+    rc = beginTransaction();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    const char* statements_sql[] = {"DELETE FROM RECURRENCE WHERE ID = ?;", "DELETE FROM PLANNER WHERE ID = ?;"};
+    int keys[] = {rule_id, pending_id};
+    for (int i = 0; i < 2 && rc == SQLITE_OK; i++) {
+        rc = prepare(statements_sql[i], stmt);
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_int(stmt.get(), 1, keys[i]);
+            rc = step_write(stmt.get());
+            rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+        }
+    }
+    if (rc == SQLITE_OK) {
+        rc = commitTransaction();
+    }
+    if (rc != SQLITE_OK) {
+        int remove_rc = rc;
+        std::cerr << "Error removing recurrence: " << sqlite3_errmsg(db) << std::endl;
+        rollbackTransaction();
+        return rc = remove_rc;
+    }
+
+    if (!options.quiet) {
+        std::cout << "Recurrence removed successfully\n";
+    }
+    notifyCompleted(pending_id);
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int64_t DB::changeSequence()
+{
+    // AUTOINCREMENT keeps the high-water mark here, pruned or not
+    Statement stmt;
+    rc = prepare("SELECT seq FROM sqlite_sequence WHERE name = 'PLANNER_CHANGES';", stmt);
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error preparing change sequence: " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
+    int step_rc = sqlite3_step(stmt.get());
+    if (step_rc == SQLITE_ROW)
+        return sqlite3_column_int64(stmt.get(), 0);
+    if (step_rc == SQLITE_DONE)
+        return 0;
+    std::cerr << "Error reading change sequence: " << sqlite3_errmsg(db) << std::endl;
+    rc = step_rc;
+    return -1;
+}
+// --------------------------------------------------------------------------------
+
+int DB::changesSince(int64_t since, ChangeSet& changes)
+{
+    changes = ChangeSet();
+
+    // One read transaction, so the sequence and the log agree
+    rc = beginTransaction();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    int64_t latest = changeSequence();
+    int64_t oldest = 0;
+    Statement stmt;
+    if (latest >= 0) {
+        rc = prepare("SELECT MIN(SEQ) FROM PLANNER_CHANGES;", stmt);
+    }
+    else {
+        rc = rc == SQLITE_OK ? SQLITE_ERROR : rc;
+    }
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_step(stmt.get()) == SQLITE_ROW ? SQLITE_OK : sqlite3_errcode(db);
+        // An empty log starts after the latest sequence
+        oldest = sqlite3_column_type(stmt.get(), 0) == SQLITE_NULL ? latest + 1 : sqlite3_column_int64(stmt.get(), 0);
+        stmt.release();
+    }
+    changes.sequence = latest;
+    changes.complete = since <= latest && since + 1 >= oldest;
+
+    // Fold each task's changes into where it started (present or not) and
+    // where it ended up
+    struct NetChange {
+        bool existed;
+        bool exists;
+    };
+    std::unordered_map<int, NetChange> net;
+    if (rc == SQLITE_OK && changes.complete && since < latest) {
+        rc = prepare("SELECT TASK_ID, KIND FROM PLANNER_CHANGES WHERE SEQ > ? AND SEQ <= ? ORDER BY SEQ;", stmt);
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_int64(stmt.get(), 1, since);
+            sqlite3_bind_int64(stmt.get(), 2, latest);
+            int step_rc;
+            while ((step_rc = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+                int id = sqlite3_column_int(stmt.get(), 0);
+                int kind = sqlite3_column_int(stmt.get(), 1);
+                auto it = net.try_emplace(id, NetChange{kind != CHANGE_INSERTED, true}).first;
+                it->second.exists = kind != CHANGE_COMPLETED;
+            }
+            rc = step_rc == SQLITE_DONE ? SQLITE_OK : step_rc;
+            stmt.release();
+        }
+    }
+    if (rc != SQLITE_OK) {
+        int changes_rc = rc;
+        std::cerr << "Error reading the change log: " << sqlite3_errmsg(db) << std::endl;
+        rollbackTransaction();
+        return rc = changes_rc;
+    }
+    rc = commitTransaction();
+
+    for (const auto& [id, change] : net) {
+        if (!change.existed && change.exists)
+            changes.inserted.push_back(id);
+        else if (change.existed && change.exists)
+            changes.updated.push_back(id);
+        else if (change.existed)
+            changes.completed.push_back(id);
+    }
+    std::sort(changes.inserted.begin(), changes.inserted.end());
+    std::sort(changes.updated.begin(), changes.updated.end());
+    std::sort(changes.completed.begin(), changes.completed.end());
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+int DB::pruneChanges(int64_t through, int* pruned)
+{
+    Statement stmt;
+    rc = prepare("DELETE FROM PLANNER_CHANGES WHERE SEQ <= ?;", stmt);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_int64(stmt.get(), 1, through);
+        rc = step_write(stmt.get());
+        rc = (rc == SQLITE_DONE) ? SQLITE_OK : rc;
+    }
+    if (rc != SQLITE_OK) {
+        std::cerr << "Error pruning the change log: " << sqlite3_errmsg(db) << std::endl;
+        return rc;
+    }
+    if (pruned)
+        *pruned = sqlite3_changes(db);
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+bool DB::changedElsewhere()
+{
+    Statement stmt;
+    if (prepare("PRAGMA data_version;", stmt) != SQLITE_OK || sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        data_version = -1;
+        return true;
+    }
+    int64_t current = sqlite3_column_int64(stmt.get(), 0);
+    bool changed = current != data_version;
+    data_version = current;
+    return changed;
+}
+// --------------------------------------------------------------------------------
+
+int DB::beginTransaction()
+{
+    // A savepoint starts a transaction when none is open and nests inside
+    // one otherwise, so batched callers can wrap these methods freely.
+    rc = execSQL("SAVEPOINT planner_txn;");
+    if (rc == SQLITE_OK) {
+        savepoints.push_back(pending_notifications.size());
+    }
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+int DB::commitTransaction()
+{
+    rc = execSQL("RELEASE planner_txn;");
+    if (rc != SQLITE_OK || savepoints.empty()) {
+        return rc;
+    }
+
+    // Releasing a nested savepoint commits nothing yet; its changes join
+    // the enclosing one's and wait for the outermost commit
+    savepoints.pop_back();
+    if (savepoints.empty() && !pending_notifications.empty()) {
+        std::vector<Notification> ready;
+        ready.swap(pending_notifications);
+        for (const Notification& notification : ready) {
+            deliver(notification);
+        }
+    }
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int DB::rollbackTransaction()
+{
+    rc = execSQL("ROLLBACK TO planner_txn;");
+    if (rc != SQLITE_OK)
+        return rc;
+    if (!savepoints.empty()) {
+        pending_notifications.resize(savepoints.back());
+        savepoints.pop_back();
+    }
+    return execSQL("RELEASE planner_txn;");
+}
+// --------------------------------------------------------------------------------
+
+StatementCacheStats DB::statementCacheStats() const
+{
+    return statements.stats();
+}
+// --------------------------------------------------------------------------------
+
+void DB::notifyInserted(int id, const std::string& task, const std::string& due_date, int priority)
+{
+    if (observers.empty())
+        return;
+    Notification notification{Notification::Inserted, id, task, due_date, priority, UpdateRow()};
+    if (savepoints.empty())
+        deliver(notification);
+    else
+        pending_notifications.push_back(std::move(notification));
+}
+// --------------------------------------------------------------------------------
+
+void DB::notifyCompleted(int id)
+{
+    if (observers.empty())
+        return;
+    Notification notification{Notification::Completed, id, std::string(), std::string(), MIN_PRIORITY, UpdateRow()};
+    if (savepoints.empty())
+        deliver(notification);
+    else
+        pending_notifications.push_back(std::move(notification));
+}
+// --------------------------------------------------------------------------------
+
+void DB::notifyUpdated(const UpdateRow& updated_row)
+{
+    if (observers.empty())
+        return;
+    Notification notification{Notification::Updated, 0, std::string(), std::string(), MIN_PRIORITY, updated_row};
+    if (savepoints.empty())
+        deliver(notification);
+    else
+        pending_notifications.push_back(std::move(notification));
+}
+// --------------------------------------------------------------------------------
+
+void DB::deliver(const Notification& notification)
+{
+    // Copied, so an observer may add or remove observers while it is told
+    std::vector<PlannerObserver*> listeners = observers;
+    for (PlannerObserver* observer : listeners) {
+        switch (notification.kind) {
+            case Notification::Inserted:
+                observer->taskInserted(notification.id, notification.task, notification.due_date, notification.priority);
+                break;
+            case Notification::Completed:
+                observer->taskCompleted(notification.id);
+                break;
+            case Notification::Updated:
+                observer->plannerUpdated(notification.updated_row);
+                break;
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void DB::addObserver(PlannerObserver* observer)
+{
+    observers.push_back(observer);
+}
+// --------------------------------------------------------------------------------
+
+void DB::removeObserver(PlannerObserver* observer)
+{
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
 // ================================================================================
 // ================================================================================
 //eof
\ No newline at end of file
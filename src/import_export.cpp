@@ -0,0 +1,888 @@
+// ================================================================================
+// ================================================================================
+// - File:    import_export.cpp
+// - Purpose: Streaming task import and export in TSV, CSV and NDJSON.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/import_export.hpp"
+#include "include/date_key.hpp"
+#include "include/protocol.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ================================================================================
+// ================================================================================
+
+static const size_t READ_CHUNK = 1 << 20;
+static const size_t WRITE_BUFFER = 1 << 20;
+// --------------------------------------------------------------------------------
+
+static bool equals_ignore_case(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+// --------------------------------------------------------------------------------
+
+static void append_utf8(std::string& out, uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+// ================================================================================
+// ================================================================================
+//   JSON (just enough for flat NDJSON records)
+// ================================================================================
+
+static void skip_space(std::string_view text, size_t& i)
+{
+    while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\r' || text[i] == '\n')) {
+        i++;
+    }
+}
+// --------------------------------------------------------------------------------
+
+static bool read_hex4(std::string_view text, size_t i, uint32_t& value)
+{
+    if (i + 4 > text.size())
+        return false;
+    value = 0;
+    for (size_t j = i; j < i + 4; j++) {
+        char c = text[j];
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+            value |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            value |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            value |= static_cast<uint32_t>(c - 'A' + 10);
+        else
+            return false;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+// text[i] is the opening quote; leaves i after the closing one.
+static bool read_json_string(std::string_view text, size_t& i, std::string& out)
+{
+    out.clear();
+    for (i++; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"') {
+            i++;
+            return true;
+        }
+        if (c != '\\') {
+            out.push_back(c);
+            continue;
+        }
+        if (++i >= text.size())
+            return false;
+        switch (text[i]) {
+            case '"':  out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/':  out.push_back('/'); break;
+            case 'b':  out.push_back('\b'); break;
+            case 'f':  out.push_back('\f'); break;
+            case 'n':  out.push_back('\n'); break;
+            case 'r':  out.push_back('\r'); break;
+            case 't':  out.push_back('\t'); break;
+            case 'u': {
+                uint32_t code_point;
+                if (!read_hex4(text, i + 1, code_point))
+                    return false;
+                i += 4;
+                // A high surrogate must be followed by its low half
+                if (code_point >= 0xD800 && code_point < 0xDC00) {
+                    uint32_t low;
+                    if (i + 2 >= text.size() || text[i + 1] != '\\' || text[i + 2] != 'u' ||
+                        !read_hex4(text, i + 3, low) || low < 0xDC00 || low > 0xDFFF)
+                        return false;
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                append_utf8(out, code_point);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+// Skips one value of any type, nested ones included.
+static bool skip_json_value(std::string_view text, size_t& i)
+{
+    std::string ignored;
+    if (i < text.size() && text[i] == '"')
+        return read_json_string(text, i, ignored);
+
+    if (i < text.size() && (text[i] == '{' || text[i] == '[')) {
+        int depth = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (c == '"') {
+                if (!read_json_string(text, i, ignored))
+                    return false;
+                continue;
+            }
+            if (c == '{' || c == '[')
+                depth++;
+            else if (c == '}' || c == ']')
+                depth--;
+            i++;
+            if (depth == 0)
+                return true;
+        }
+        return false;
+    }
+
+    size_t start = i;
+    while (i < text.size() && text[i] != ',' && text[i] != '}' && text[i] != ']' &&
+           text[i] != ' ' && text[i] != '\t' && text[i] != '\r' && text[i] != '\n') {
+        i++;
+    }
+    return i > start;
+}
+// --------------------------------------------------------------------------------
+
+// A priority field: a whole number in [MIN_PRIORITY, MAX_PRIORITY], with
+// an empty field meaning the default.
+static bool parse_priority(std::string_view text, int& priority)
+{
+    if (text.empty()) {
+        priority = MIN_PRIORITY;
+        return true;
+    }
+    if (text.size() > 3)
+        return false;
+    int value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9')
+            return false;
+        value = value * 10 + (c - '0');
+    }
+    if (value < MIN_PRIORITY || value > MAX_PRIORITY)
+        return false;
+    priority = value;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_ndjson_record(std::string_view line, Task& task, std::string& error)
+{
+    size_t i = 0;
+    skip_space(line, i);
+    if (i >= line.size() || line[i] != '{') {
+        error = "expected a JSON object";
+        return false;
+    }
+    i++;
+
+    bool have_task = false;
+    bool have_due_date = false;
+    std::string key;
+    while (true) {
+        skip_space(line, i);
+        if (i < line.size() && line[i] == '}')
+            break;
+        if (i >= line.size() || line[i] != '"' || !read_json_string(line, i, key)) {
+            error = "malformed JSON member name";
+            return false;
+        }
+        skip_space(line, i);
+        if (i >= line.size() || line[i] != ':') {
+            error = "expected ':' after \"" + key + "\"";
+            return false;
+        }
+        i++;
+        skip_space(line, i);
+
+        bool is_task = key == "task";
+        bool is_due_date = key == "due_date";
+        if (key == "priority") {
+            size_t start = i;
+            if (!skip_json_value(line, i) || !parse_priority(line.substr(start, i - start), task.priority)) {
+                error = "\"priority\" must be a whole number from " + std::to_string(MIN_PRIORITY) +
+                        " to " + std::to_string(MAX_PRIORITY);
+                return false;
+            }
+        }
+        else if (is_task || is_due_date) {
+            if (i >= line.size() || line[i] != '"' ||
+                !read_json_string(line, i, is_task ? task.task : task.due_date)) {
+                error = "\"" + key + "\" must be a string";
+                return false;
+            }
+            (is_task ? have_task : have_due_date) = true;
+        }
+        else if (!skip_json_value(line, i)) {
+            error = "malformed JSON value for \"" + key + "\"";
+            return false;
+        }
+
+        skip_space(line, i);
+        if (i < line.size() && line[i] == ',') {
+            i++;
+            continue;
+        }
+        if (i < line.size() && line[i] == '}')
+            break;
+        error = "expected ',' or '}'";
+        return false;
+    }
+
+    if (!have_task || !have_due_date) {
+        error = "missing \"task\" or \"due_date\"";
+        return false;
+    }
+    return true;
+}
+
+// ================================================================================
+// ================================================================================
+//   Record parsing
+// ================================================================================
+
+// Turns raw bytes into validated tasks, one record at a time.  The parser
+// only consumes complete records, so a chunked caller re-presents the
+// unconsumed tail with the next chunk.
+class RecordParser
+{
+    private:
+
+        DataFormat format;
+        size_t line;                    // line the next record starts on
+        bool first_record;
+        int id_column;                  // CSV column positions, -1 when absent
+        int task_column;
+        int due_date_column;
+        int priority_column;
+        std::vector<std::string> fields;
+        std::string error_text;
+// ================================================================================
+
+        // End of the record starting at start (position of its newline, or
+        // npos when the data runs out first).
+        size_t recordEnd(std::string_view data, size_t start) const
+        {
+            if (format != DataFormat::Csv)
+                return data.find('\n', start);
+
+            bool quoted = false;
+            for (size_t i = start; i < data.size(); i++) {
+                if (data[i] == '"')
+                    quoted = !quoted;
+                else if (data[i] == '\n' && !quoted)
+                    return i;
+            }
+            return std::string_view::npos;
+        }
+// --------------------------------------------------------------------------------
+
+        bool splitCsv(std::string_view record)
+        {
+            fields.clear();
+            fields.emplace_back();
+            bool quoted = false;
+            for (size_t i = 0; i < record.size(); i++) {
+                char c = record[i];
+                if (quoted) {
+                    if (c == '"' && i + 1 < record.size() && record[i + 1] == '"') {
+                        fields.back().push_back('"');
+                        i++;
+                    }
+                    else if (c == '"') {
+                        quoted = false;
+                    }
+                    else {
+                        fields.back().push_back(c);
+                    }
+                }
+                else if (c == '"' && fields.back().empty()) {
+                    quoted = true;
+                }
+                else if (c == ',') {
+                    fields.emplace_back();
+                }
+                else if (c == '\r' && i + 1 == record.size()) {
+                    // CRLF line ending
+                }
+                else {
+                    fields.back().push_back(c);
+                }
+            }
+            if (quoted) {
+                error_text = "unterminated quoted field";
+                return false;
+            }
+            return true;
+        }
+// --------------------------------------------------------------------------------
+
+        // Reads the CSV header, or works out the columns from the first row.
+        // Returns true when the record was a header.
+        bool mapCsvColumns()
+        {
+            for (size_t i = 0; i < fields.size(); i++) {
+                if (equals_ignore_case(fields[i], "task"))
+                    task_column = static_cast<int>(i);
+                else if (equals_ignore_case(fields[i], "due_date"))
+                    due_date_column = static_cast<int>(i);
+                else if (equals_ignore_case(fields[i], "id"))
+                    id_column = static_cast<int>(i);
+                else if (equals_ignore_case(fields[i], "priority"))
+                    priority_column = static_cast<int>(i);
+            }
+            if (task_column >= 0 || due_date_column >= 0)
+                return true;
+
+            // Headerless rows are [id,]task,due_date or id,task,due_date,priority
+            task_column = fields.size() >= 3 ? 1 : 0;
+            due_date_column = task_column + 1;
+            priority_column = fields.size() >= 4 ? 3 : -1;
+            return false;
+        }
+// --------------------------------------------------------------------------------
+
+        // Fills task from one record.  Returns false for records that hold
+        // no task (blank lines, headers) with error_text left empty.
+        bool parseRecord(std::string_view record, Task& task)
+        {
+            error_text.clear();
+            bool first = first_record;
+            first_record = false;
+
+            if (!record.empty() && record.back() == '\r')
+                record.remove_suffix(1);
+            if (record.empty())
+                return false;
+
+            task.priority = MIN_PRIORITY;
+            switch (format) {
+                case DataFormat::Tsv: {
+                    split_line(record, fields);
+                    if (fields.size() < 2 || fields.size() > 4) {
+                        error_text = "expected [id<TAB>]task<TAB>due_date or id<TAB>task<TAB>due_date<TAB>priority";
+                        return false;
+                    }
+                    size_t offset = fields.size() == 2 ? 0 : 1;
+                    if (first && fields[offset] == "task" && fields[offset + 1] == "due_date")
+                        return false;
+                    if (fields.size() == 4 && !parse_priority(fields[3], task.priority)) {
+                        error_text = "invalid priority \"" + fields[3] + "\"";
+                        return false;
+                    }
+                    task.task = std::move(fields[offset]);
+                    task.due_date = std::move(fields[offset + 1]);
+                    break;
+                }
+                case DataFormat::Csv: {
+                    if (!splitCsv(record))
+                        return false;
+                    if (first && mapCsvColumns())
+                        return false;
+                    if (task_column < 0 || due_date_column < 0) {
+                        error_text = "header has no task or due_date column";
+                        return false;
+                    }
+                    int needed = std::max(task_column, due_date_column);
+                    if (static_cast<int>(fields.size()) <= needed) {
+                        error_text = "expected " + std::to_string(needed + 1) + " columns";
+                        return false;
+                    }
+                    // Short rows leave a trailing priority column at its default
+                    if (priority_column >= 0 && static_cast<int>(fields.size()) > priority_column) {
+                        const std::string& priority = fields[static_cast<size_t>(priority_column)];
+                        if (!parse_priority(priority, task.priority)) {
+                            error_text = "invalid priority \"" + priority + "\"";
+                            return false;
+                        }
+                    }
+                    task.task = std::move(fields[static_cast<size_t>(task_column)]);
+                    task.due_date = std::move(fields[static_cast<size_t>(due_date_column)]);
+                    break;
+                }
+                case DataFormat::Ndjson:
+                    if (!parse_ndjson_record(record, task, error_text))
+                        return false;
+                    break;
+            }
+
+            DueKey key;
+            if (!parse_due_key(task.due_date.data(), task.due_date.size(), key)) {
+                error_text = "invalid date \"" + task.due_date + "\"";
+                return false;
+            }
+            return true;
+        }
+// ================================================================================
+
+    public:
+
+        explicit RecordParser(DataFormat format) :
+            format(format),
+            line(1),
+            first_record(true),
+            id_column(-1),
+            task_column(-1),
+            due_date_column(-1),
+            priority_column(-1)
+        {
+        }
+// --------------------------------------------------------------------------------
+
+        // Parses every complete record in data (all of it when at_eof) into
+        // batch, calling flush whenever batch reaches batch_size.  Returns
+        // the bytes consumed; on a bad record sets result and failed.
+        template <typename Flush>
+        size_t parse(std::string_view data, bool at_eof, std::vector<Task>& batch, size_t batch_size,
+                     Flush flush, ImportResult& result, bool& failed)
+        {
+            size_t start = 0;
+            Task task;
+            while (start < data.size()) {
+                size_t end = recordEnd(data, start);
+                if (end == std::string_view::npos && !at_eof)
+                    break;
+                size_t stop = end == std::string_view::npos ? data.size() : end;
+                std::string_view record = data.substr(start, stop - start);
+
+                if (parseRecord(record, task)) {
+                    batch.push_back(std::move(task));
+                    if (batch.size() >= batch_size && !flush()) {
+                        failed = true;
+                        return start;
+                    }
+                }
+                else if (!error_text.empty()) {
+                    result.error_line = line;
+                    result.error = error_text;
+                    failed = true;
+                    return start;
+                }
+
+                line += static_cast<size_t>(std::count(record.begin(), record.end(), '\n')) + 1;
+                start = end == std::string_view::npos ? data.size() : end + 1;
+            }
+            return start;
+        }
+};
+
+// ================================================================================
+// ================================================================================
+//   Import pipeline
+// ================================================================================
+
+// Bounded hand-off between the parser thread and the writer.  push blocks
+// while the queue is full; close wakes both sides.
+class BatchQueue
+{
+    private:
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::vector<Task>> batches;
+        size_t capacity;
+        bool closed;
+// ================================================================================
+
+    public:
+
+        explicit BatchQueue(size_t capacity) : capacity(std::max<size_t>(capacity, 1)), closed(false) {}
+// --------------------------------------------------------------------------------
+
+        bool push(std::vector<Task>& batch)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return closed || batches.size() < capacity; });
+            if (closed)
+                return false;
+            batches.push_back(std::move(batch));
+            changed.notify_all();
+            return true;
+        }
+// --------------------------------------------------------------------------------
+
+        bool pop(std::vector<Task>& batch)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return closed || !batches.empty(); });
+            if (batches.empty())
+                return false;
+            batch = std::move(batches.front());
+            batches.pop_front();
+            changed.notify_all();
+            return true;
+        }
+// --------------------------------------------------------------------------------
+
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            changed.notify_all();
+        }
+};
+// --------------------------------------------------------------------------------
+
+// Parser thread body: feeds the whole input through the parser.
+static void parse_input(int fd, const ImportOptions& options, BatchQueue& queue,
+                        ImportResult& result, bool& failed)
+{
+    RecordParser parser(options.format);
+    std::vector<Task> batch;
+    batch.reserve(options.batch_size);
+    auto flush = [&]() {
+        if (!queue.push(batch))
+            return false;
+        batch.clear();
+        batch.reserve(options.batch_size);
+        return true;
+    };
+
+    struct stat info;
+    bool mapped = false;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t size = static_cast<size_t>(info.st_size);
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            // The kernel reads ahead and drops pages behind, so files larger
+            // than RAM stream through the page cache
+            madvise(data, size, MADV_SEQUENTIAL);
+            parser.parse(std::string_view(static_cast<const char*>(data), size), true,
+                         batch, options.batch_size, flush, result, failed);
+            result.bytes = size;
+            munmap(data, size);
+            mapped = true;
+        }
+    }
+
+    if (!mapped) {
+        std::string buffer;
+        std::vector<char> chunk(READ_CHUNK);
+        bool at_eof = false;
+        while (!failed && !at_eof) {
+            ssize_t count = read(fd, chunk.data(), chunk.size());
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count < 0) {
+                result.error = std::string("read failed: ") + std::strerror(errno);
+                failed = true;
+                break;
+            }
+            at_eof = count == 0;
+            buffer.append(chunk.data(), static_cast<size_t>(count));
+            result.bytes += static_cast<uint64_t>(count);
+
+            size_t consumed = parser.parse(buffer, at_eof, batch, options.batch_size, flush, result, failed);
+            buffer.erase(0, consumed);
+        }
+    }
+
+    if (!failed && !batch.empty())
+        failed = !flush();
+    queue.close();
+}
+// --------------------------------------------------------------------------------
+
+bool parse_data_format(const std::string& name, DataFormat& format)
+{
+    if (name == "tsv")
+        format = DataFormat::Tsv;
+    else if (name == "csv")
+        format = DataFormat::Csv;
+    else if (name == "ndjson" || name == "jsonl" || name == "json")
+        format = DataFormat::Ndjson;
+    else
+        return false;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+DataFormat data_format_for_path(const std::string& path, DataFormat fallback)
+{
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos)
+        return fallback;
+    DataFormat format;
+    return parse_data_format(path.substr(dot + 1), format) ? format : fallback;
+}
+// --------------------------------------------------------------------------------
+
+int import_tasks(DB& db, const std::string& path, const ImportOptions& options, ImportResult& result)
+{
+    result = ImportResult();
+    int fd = path == "-" ? STDIN_FILENO : open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        result.error = "cannot open " + path + ": " + std::strerror(errno);
+        return SQLITE_CANTOPEN;
+    }
+
+    int rc = options.atomic ? db.beginTransaction() : SQLITE_OK;
+    if (rc != SQLITE_OK) {
+        if (fd != STDIN_FILENO)
+            close(fd);
+        result.error = "cannot start transaction";
+        return rc;
+    }
+
+    BatchQueue queue(options.queue_depth);
+    bool parse_failed = false;
+    std::thread parser(parse_input, fd, std::cref(options), std::ref(queue),
+                       std::ref(result), std::ref(parse_failed));
+
+    // Writer stage: one bulkInsertTasks transaction per batch
+    std::vector<Task> batch;
+    while (queue.pop(batch)) {
+        rc = db.bulkInsertTasks(batch);
+        if (rc != SQLITE_OK) {
+            // Stops the parser at its next push
+            queue.close();
+            break;
+        }
+        result.rows += batch.size();
+    }
+    parser.join();
+    if (fd != STDIN_FILENO)
+        close(fd);
+
+    if (rc == SQLITE_OK && parse_failed)
+        rc = SQLITE_ERROR;
+    else if (rc != SQLITE_OK && result.error.empty())
+        result.error = std::string("insert failed: ") + sqlite3_errstr(rc);
+
+    if (options.atomic) {
+        if (rc != SQLITE_OK) {
+            db.rollbackTransaction();
+            result.rows = 0;
+        }
+        else {
+            rc = db.commitTransaction();
+        }
+    }
+    return rc;
+}
+
+// ================================================================================
+// ================================================================================
+//   Export
+// ================================================================================
+
+// Collects output and hands it to write(2) a megabyte at a time.
+class BufferedWriter
+{
+    private:
+
+        int fd;
+        std::string buffer;
+        bool failed;
+// ================================================================================
+
+    public:
+
+        explicit BufferedWriter(int fd) : fd(fd), failed(false)
+        {
+            buffer.reserve(WRITE_BUFFER + 4096);
+        }
+// --------------------------------------------------------------------------------
+
+        std::string& data()
+        {
+            return buffer;
+        }
+// --------------------------------------------------------------------------------
+
+        void flushIfFull()
+        {
+            if (buffer.size() >= WRITE_BUFFER)
+                flush();
+        }
+// --------------------------------------------------------------------------------
+
+        bool flush()
+        {
+            size_t written = 0;
+            while (!failed && written < buffer.size()) {
+                ssize_t count = write(fd, buffer.data() + written, buffer.size() - written);
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    failed = true;
+                else
+                    written += static_cast<size_t>(count);
+            }
+            buffer.clear();
+            return !failed;
+        }
+};
+// --------------------------------------------------------------------------------
+
+static void append_csv_field(std::string& out, std::string_view field)
+{
+    bool quote = field.find_first_of(",\"\r\n") != std::string_view::npos ||
+                 (!field.empty() && (field.front() == ' ' || field.back() == ' '));
+    if (!quote) {
+        out.append(field);
+        return;
+    }
+    out.push_back('"');
+    for (char c : field) {
+        if (c == '"')
+            out.push_back('"');
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+// --------------------------------------------------------------------------------
+
+static void append_json_string(std::string& out, std::string_view text)
+{
+    out.push_back('"');
+    for (char c : text) {
+        switch (c) {
+            case '"':  out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    out.append(escape);
+                }
+                else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+// --------------------------------------------------------------------------------
+
+int export_tasks(DB& db, const std::string& path, DataFormat format, uint64_t* rows)
+{
+    int fd = STDOUT_FILENO;
+    if (path == "-") {
+        // Anything already written through std::cout goes first
+        std::cout.flush();
+    }
+    else {
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Error opening " << path << ": " << std::strerror(errno) << std::endl;
+            return SQLITE_CANTOPEN;
+        }
+    }
+
+    BufferedWriter writer(fd);
+    std::string& out = writer.data();
+    if (format == DataFormat::Csv)
+        out.append("id,task,due_date,priority\n");
+
+    uint64_t count = 0;
+    std::string due_date;
+    TaskCursor cursor = db.scanTasks();
+    for (const RowView& row : cursor) {
+        // The parsed key is canonical; unparsable dates keep their text
+        if (row.due_key != INVALID_DUE_KEY)
+            due_date = format_due_key(row.due_key);
+        else
+            due_date.assign(row.due_date);
+
+        switch (format) {
+            case DataFormat::Tsv:
+                out.append(std::to_string(row.id));
+                out.push_back('\t');
+                append_escaped_field(out, row.task);
+                out.push_back('\t');
+                append_escaped_field(out, due_date);
+                out.push_back('\t');
+                out.append(std::to_string(row.priority));
+                break;
+            case DataFormat::Csv:
+                out.append(std::to_string(row.id));
+                out.push_back(',');
+                append_csv_field(out, row.task);
+                out.push_back(',');
+                append_csv_field(out, due_date);
+                out.push_back(',');
+                out.append(std::to_string(row.priority));
+                break;
+            case DataFormat::Ndjson:
+                out.append("{\"id\": ");
+                out.append(std::to_string(row.id));
+                out.append(", \"task\": ");
+                append_json_string(out, row.task);
+                out.append(", \"due_date\": ");
+                append_json_string(out, due_date);
+                out.append(", \"priority\": ");
+                out.append(std::to_string(row.priority));
+                out.push_back('}');
+                break;
+        }
+        out.push_back('\n');
+        count++;
+        writer.flushIfFull();
+    }
+
+    bool written = writer.flush();
+    if (fd != STDOUT_FILENO && close(fd) != 0)
+        written = false;
+    if (!written) {
+        std::cerr << "Error writing " << path << ": " << std::strerror(errno) << std::endl;
+        return SQLITE_IOERR;
+    }
+    if (rows)
+        *rows = count;
+    return cursor.status();
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
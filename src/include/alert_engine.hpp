@@ -0,0 +1,170 @@
+// ================================================================================
+// ================================================================================
+// - File:    alert_engine.hpp
+// - Purpose: Due-date alerts ("when a task falls due", "an hour before")
+//            for planners of any size.  Every pending alert sits in a
+//            hierarchical timing wheel with one-minute ticks, so scheduling
+//            and cancelling are O(1) and advancing the clock only touches
+//            the alerts that fire or move down a level.  Seeded from the
+//            PLANNER table and kept in sync through the observer hook and
+//            the change log.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef ALERT_ENGINE_HPP
+#define ALERT_ENGINE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "db.hpp"
+#include "date_key.hpp"
+// --------------------------------------------------------------------------------
+
+struct Alert {
+    int id;
+    DueKey due_key;
+    int lead_minutes;           // 0 when the task falls due
+    int64_t minute;             // when it fired, in due_key_to_minutes units
+};
+// --------------------------------------------------------------------------------
+
+struct AlertOptions {
+    // One alert per entry for every task: 0 fires as the task falls due,
+    // 60 an hour before.  Duplicates and negative entries are dropped.
+    std::vector<int> lead_minutes{0};
+};
+// --------------------------------------------------------------------------------
+
+// The local wall-clock time in due_key_to_minutes units.  Due dates carry
+// no time zone, so they are read as local time.
+int64_t local_minute_now();
+// ================================================================================
+
+
+class AlertEngine : public PlannerObserver
+{
+    private:
+
+        // Level L has SLOTS slots of SLOTS^L minutes each; six levels
+        // reach 64^6 minutes (about 130,000 years) ahead
+        static const int SLOT_BITS = 6;
+        static const int SLOTS = 1 << SLOT_BITS;
+        static const int LEVELS = 6;
+        static const uint32_t NIL = UINT32_MAX;
+
+        struct Timer {
+            int64_t expires;            // the minute to fire at
+            int id;
+            uint32_t prev;              // neighbours in the slot's list
+            uint32_t next;              // (next also links the free list)
+            uint32_t task_next;         // the same task's other alerts
+            uint16_t slot;              // level * SLOTS + index, for unlinking a list head
+            uint16_t lead;              // index into lead_minutes
+        };
+
+        DB* db;
+        std::function<void(const Alert&)> fire;
+        std::vector<int> lead_minutes;
+        int64_t now;
+
+        std::vector<Timer> timers;
+        uint32_t free_timers;
+        uint32_t heads[LEVELS * SLOTS];
+        uint64_t occupied[LEVELS];                  // bit i: slot i of the level is not empty
+        std::unordered_map<int, uint32_t> by_task;  // ID -> its first alert
+        size_t pending_count;
+        int64_t change_sequence;
+        bool catch_up_failed;                       // retry even if data_version has not moved
+// --------------------------------------------------------------------------------
+
+        uint32_t allocate();
+        void release(uint32_t timer);
+// --------------------------------------------------------------------------------
+
+        // Links the timer into the slot its expiry falls in, seen from now.
+        void place(uint32_t timer);
+// --------------------------------------------------------------------------------
+
+        void unlink(uint32_t timer);
+// --------------------------------------------------------------------------------
+
+        // Moves the current slot of level down to the levels below.
+        void cascade(int level);
+// --------------------------------------------------------------------------------
+
+        // Fires level 0's slot for now.
+        size_t fireCurrent();
+// --------------------------------------------------------------------------------
+
+        // Drops the timer from its task's chain (and the task once empty).
+        void detachFromTask(uint32_t timer);
+// ================================================================================
+
+    public:
+
+        // Loads every task from db and follows its changes until destroyed.
+        // fire is called once per alert, in time order, from advance; it may
+        // change the planner (e.g. complete the task).
+        AlertEngine(DB& db, std::function<void(const Alert&)> fire, int64_t now_minute,
+                    const AlertOptions& options = AlertOptions());
+// --------------------------------------------------------------------------------
+
+        AlertEngine(const AlertEngine&) = delete;
+        AlertEngine& operator=(const AlertEngine&) = delete;
+// --------------------------------------------------------------------------------
+
+        ~AlertEngine();
+// --------------------------------------------------------------------------------
+
+        // Drops every alert and schedules the planner's tasks again.
+        void reload();
+// --------------------------------------------------------------------------------
+
+        // Applies what other connections have changed since the last load or
+        // catch-up (see PlannerSnapshot::catchUp).
+        int catchUp();
+// --------------------------------------------------------------------------------
+
+        // Replaces the task's alerts with those for due_key that are still
+        // ahead of the clock; alerts whose time has passed are skipped.
+        void schedule(int id, DueKey due_key);
+// --------------------------------------------------------------------------------
+
+        void cancel(int id);
+// --------------------------------------------------------------------------------
+
+        // Moves the clock to minute, firing every alert due up to and
+        // including it.  Stretches with nothing pending are skipped a whole
+        // wheel turn at a time.  Returns the number fired.
+        size_t advance(int64_t minute);
+// --------------------------------------------------------------------------------
+
+        int64_t currentMinute() const;
+// --------------------------------------------------------------------------------
+
+        // Alerts scheduled and not yet fired.
+        size_t pending() const;
+// --------------------------------------------------------------------------------
+
+        void taskInserted(int id, const std::string& task, const std::string& due_date, int priority) override;
+// --------------------------------------------------------------------------------
+
+        void taskCompleted(int id) override;
+// --------------------------------------------------------------------------------
+
+        void plannerUpdated(const UpdateRow& updated_row) override;
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,120 @@
+// ================================================================================
+// ================================================================================
+// - File:    cli.hpp
+// - Purpose: Subcommands for the planner CLI, a batch mode that runs many
+//            commands over one connection in one transaction, and buffered
+//            text/TSV/JSON output.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef CLI_HPP
+#define CLI_HPP
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "alert_engine.hpp"
+#include "db.hpp"
+// --------------------------------------------------------------------------------
+
+enum class OutputFormat {
+    Text,       // "ID: 1, Task: ..., Due Date: ..." as the interactive output
+    Tsv,        // id<TAB>task<TAB>due_date<TAB>priority, tabs/newlines/backslashes escaped
+    Json        // one JSON object per line
+};
+// --------------------------------------------------------------------------------
+
+bool parse_output_format(const std::string& name, OutputFormat& format);
+// --------------------------------------------------------------------------------
+
+// Collects output in one buffer and hands it to the stream in large chunks.
+// Nothing is flushed per line; the destructor writes whatever is left.
+class RowWriter
+{
+    private:
+
+        std::ostream& out;
+        OutputFormat format;
+        bool quiet;
+        bool held;                      // nothing reaches the stream until release()
+        std::string buffer;
+// ================================================================================
+
+        void appendEscaped(std::string_view text);
+        void flushIfFull();
+// ================================================================================
+
+    public:
+
+        RowWriter(std::ostream& out, OutputFormat format, bool quiet = false);
+        ~RowWriter();
+        RowWriter(const RowWriter&) = delete;
+        RowWriter& operator=(const RowWriter&) = delete;
+// --------------------------------------------------------------------------------
+
+        OutputFormat outputFormat() const;
+// --------------------------------------------------------------------------------
+
+        void row(int id, std::string_view task, DueKey due_key, std::string_view due_date = {},
+                 int priority = MIN_PRIORITY);
+        void row(const TaskRow& task_row);
+// --------------------------------------------------------------------------------
+
+        // One recurrence rule with its pending occurrence.
+        void recurrence(const RecurrenceRule& rule);
+// --------------------------------------------------------------------------------
+
+        // One fired alert with the task's description.
+        void alert(const Alert& alert, std::string_view task);
+// --------------------------------------------------------------------------------
+
+        // A command's result, e.g. ("id", 12) after add.  Suppressed when quiet.
+        void result(std::string_view name, long long value);
+// --------------------------------------------------------------------------------
+
+        void flush();
+// --------------------------------------------------------------------------------
+
+        // Keeps everything buffered, however large, until release() writes
+        // it or discard() drops it.  An explicit flush() still writes.
+        void hold();
+        void release();
+        void discard();
+};
+// --------------------------------------------------------------------------------
+
+// Splits a batch line into words.  Double quotes group words and accept
+// \" and \\ escapes; an unquoted # starts a comment.
+std::vector<std::string> split_command_line(const std::string& line);
+// --------------------------------------------------------------------------------
+
+// Runs one subcommand (args[0] is its name).  Returns 0 on success.
+//   add TASK DUE_DATE [PRIORITY]           complete ID...
+//   update ID task|due_date|priority VALUE
+//   next [N]                   range FROM TO            list
+//   search QUERY [N] [FROM TO]
+//   import FILE|- [FORMAT]     export [FILE|-] [FORMAT]     (tsv, csv or ndjson)
+//   recur TASK START daily|weekly|monthly [INTERVAL] [UNTIL]
+//   recurrences                unrecur ID
+//   changes [SEQ]              prune-changes SEQ
+int run_command(DB& db, const std::vector<std::string>& args, RowWriter& out);
+// --------------------------------------------------------------------------------
+
+// Runs one command per line inside a single transaction; the first failing
+// line rolls everything back, and the output of the lines before it is
+// dropped with it.  Output is held until the transaction commits.
+int run_batch(DB& db, std::istream& in, RowWriter& out);
+// --------------------------------------------------------------------------------
+
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
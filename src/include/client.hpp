@@ -0,0 +1,73 @@
+// ================================================================================
+// ================================================================================
+// - File:    client.hpp
+// - Purpose: Blocking client for the planner server.  Requests can be
+//            queued with send() and written together with flush(), then
+//            read back in order, so many requests share one round trip.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef CLIENT_HPP
+#define CLIENT_HPP
+
+#include <string>
+#include <vector>
+// --------------------------------------------------------------------------------
+
+struct ServerResponse {
+    bool ok = false;
+    std::string error;                          // set when ok is false
+    std::vector<std::vector<std::string>> rows; // unescaped fields of each row
+};
+// --------------------------------------------------------------------------------
+
+class PlannerClient
+{
+    private:
+
+        int fd;
+        std::string output;
+        std::string input;
+        size_t input_start;
+// ================================================================================
+
+        bool readLine(std::string& line);
+// ================================================================================
+
+    public:
+
+        PlannerClient();
+        ~PlannerClient();
+        PlannerClient(const PlannerClient&) = delete;
+        PlannerClient& operator=(const PlannerClient&) = delete;
+// --------------------------------------------------------------------------------
+
+        // Returns 0, or -1 after reporting the error.
+        int connectTo(const std::string& path);
+// --------------------------------------------------------------------------------
+
+        // Queues one request; nothing is written until flush().
+        void send(const std::vector<std::string>& fields);
+// --------------------------------------------------------------------------------
+
+        bool flush();
+// --------------------------------------------------------------------------------
+
+        // Reads the response to the oldest unanswered request.
+        bool receive(ServerResponse& response);
+// --------------------------------------------------------------------------------
+
+        // send + flush + receive.
+        bool call(const std::vector<std::string>& fields, ServerResponse& response);
+};
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
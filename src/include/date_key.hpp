@@ -0,0 +1,111 @@
+// ================================================================================
+// ================================================================================
+// - File:    date_key.hpp
+// - Purpose: Compact, sortable integer keys for due dates.  A key packs a
+//            "YYYY-MM-DD" or "YYYY-MM-DDTHH:MM" date as the decimal number
+//            YYYYMMDDHHMM, so ordering two dates is a single integer compare
+//            and the key reads naturally when stored in the DUE_KEY column.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef DATE_KEY_HPP
+#define DATE_KEY_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+// --------------------------------------------------------------------------------
+
+typedef int64_t DueKey;
+
+// Sorts after every valid date so unparsable rows never jump the queue.
+const DueKey INVALID_DUE_KEY = INT64_MAX;
+// --------------------------------------------------------------------------------
+
+// Parses "YYYY-MM-DD" with an optional "THH:MM" (or " HH:MM") suffix without
+// allocating.  Returns false and leaves key untouched if the text is not a
+// valid calendar date.
+bool parse_due_key(const char* text, size_t length, DueKey& key);
+// --------------------------------------------------------------------------------
+
+// Same as above, returning INVALID_DUE_KEY on failure.
+DueKey parse_due_key(std::string_view text);
+// --------------------------------------------------------------------------------
+
+// Ordering key: the due key with the task's priority folded into the low
+// byte, so "earlier first, then more urgent first" is one integer compare
+// and one SQLite index (see the ORDER_KEY column in DB::createPlanner).
+// Equal keys fall back on the task ID.
+typedef int64_t OrderKey;
+
+const int MIN_PRIORITY = 0;         // the default
+const int MAX_PRIORITY = 255;       // most urgent
+const OrderKey INVALID_ORDER_KEY = INT64_MAX;
+// --------------------------------------------------------------------------------
+
+inline OrderKey make_order_key(DueKey due_key, int priority)
+{
+    if (due_key == INVALID_DUE_KEY)
+        return INVALID_ORDER_KEY;
+    priority = priority < MIN_PRIORITY ? MIN_PRIORITY : priority > MAX_PRIORITY ? MAX_PRIORITY : priority;
+    return due_key * 256 + (MAX_PRIORITY - priority);
+}
+// --------------------------------------------------------------------------------
+
+inline DueKey order_key_due(OrderKey key)
+{
+    return key == INVALID_ORDER_KEY ? INVALID_DUE_KEY : key / 256;
+}
+// --------------------------------------------------------------------------------
+
+inline int order_key_priority(OrderKey key)
+{
+    return key == INVALID_ORDER_KEY ? MIN_PRIORITY : MAX_PRIORITY - static_cast<int>(key % 256);
+}
+// --------------------------------------------------------------------------------
+
+// A date that failed to parse in a batch: its position in the input and
+// the offending text.
+struct DateError {
+    size_t index;
+    std::string text;
+};
+// --------------------------------------------------------------------------------
+
+// Parses texts[0..count) into keys (INVALID_DUE_KEY for each failure) and
+// appends one DateError per failure to errors, in input order.  Large
+// batches are split into fixed-size chunks parsed on up to threads threads
+// (0 = one per core); small ones stay on the calling thread.
+void parse_due_keys(const std::string_view* texts, size_t count, DueKey* keys,
+                    std::vector<DateError>& errors, unsigned threads = 0);
+// --------------------------------------------------------------------------------
+
+// "YYYY-MM-DD", plus "THH:MM" when the key carries a time of day.
+std::string format_due_key(DueKey key);
+// --------------------------------------------------------------------------------
+
+// Days since 1970-01-01 (proleptic Gregorian) and back.
+int64_t days_from_civil(int year, int month, int day);
+// --------------------------------------------------------------------------------
+
+DueKey due_key_from_days(int64_t days, int hour = 0, int minute = 0);
+// --------------------------------------------------------------------------------
+
+// Minutes since 1970-01-01T00:00, for arithmetic on keys (years 0000-9999).
+int64_t due_key_to_minutes(DueKey key);
+// --------------------------------------------------------------------------------
+
+DueKey due_key_from_minutes(int64_t minutes);
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
@@ -1,8 +1,14 @@
 #ifndef DB_H
 #define DB_H
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include "/usr/include/sqlite3.h"
+#include <sqlite3.h>
+#include "date_key.hpp"
+#include "recurrence.hpp"
+#include "schema.hpp"
+#include "statement.hpp"
 // ================================================================================
 // ================================================================================
 
@@ -19,23 +25,221 @@ struct UpdateRow {
 struct Task{
     std::string task;
     std::string due_date;
+    int priority = MIN_PRIORITY;
+};
+// --------------------------------------------------------------------------------
+
+
+struct TaskRow {
+    int id;
+    std::string task;
+    DueKey due_key;
+    int priority = MIN_PRIORITY;
+};
+// --------------------------------------------------------------------------------
+
+
+// One row of a TaskCursor.  The string views point into SQLite's buffers and
+// are only valid until the cursor advances.
+struct RowView {
+    int id;
+    std::string_view task;
+    std::string_view due_date;
+    DueKey due_key;
+    int priority;
+
+    // Copies the row out for callers that need to keep it.
+    TaskRow materialize() const;
+};
+// --------------------------------------------------------------------------------
+
+
+// Streams (ID, TASK, DUE_DATE, DUE_KEY, PRIORITY) rows out of a prepared
+// statement in constant memory.  Holds the statement handle until the rows run out; move-only.
+class TaskCursor
+{
+    private:
+
+        Statement statement;
+        int rc;
+        RowView current;
+        uint64_t rows_read;     // flushed to the metrics when the scan ends
+        bool parse_dates;
+// ================================================================================
+
+    public:
+
+        class iterator
+        {
+            private:
+                TaskCursor* cursor;
+
+            public:
+                explicit iterator(TaskCursor* cursor) : cursor(cursor) {}
+                const RowView& operator*() const { return cursor->row(); }
+                const RowView* operator->() const { return &cursor->row(); }
+                iterator& operator++();
+                bool operator==(const iterator& other) const { return cursor == other.cursor; }
+                bool operator!=(const iterator& other) const { return cursor != other.cursor; }
+        };
+// --------------------------------------------------------------------------------
+
+        // Takes an already bound statement.  An empty handle yields an empty
+        // cursor reporting error_rc from status().
+        explicit TaskCursor(Statement statement, int error_rc = SQLITE_OK);
+// --------------------------------------------------------------------------------
+
+        TaskCursor(TaskCursor&& other) noexcept = default;
+        TaskCursor& operator=(TaskCursor&& other) noexcept = default;
+        TaskCursor(const TaskCursor&) = delete;
+        TaskCursor& operator=(const TaskCursor&) = delete;
+// --------------------------------------------------------------------------------
+
+        // Rows without a stored DUE_KEY are parsed as they are read unless
+        // this is turned off, in which case they report INVALID_DUE_KEY and
+        // the caller parses due_date itself (e.g. in bulk with parse_due_keys).
+        void setParseDates(bool parse);
+// --------------------------------------------------------------------------------
+
+        // Advances to the next row; false once the rows run out or on error.
+        bool next();
+// --------------------------------------------------------------------------------
+
+        const RowView& row() const;
+// --------------------------------------------------------------------------------
+
+        // SQLITE_OK while rows remain or after a clean finish, the error otherwise.
+        int status() const;
+// --------------------------------------------------------------------------------
+
+        // Single pass: begin() fetches the first row.
+        iterator begin();
+        iterator end();
+// --------------------------------------------------------------------------------
+};
+// --------------------------------------------------------------------------------
+
+// Connection settings.  The defaults match a plain sqlite3_open.
+struct DBOptions {
+    bool read_only = false;
+    bool wal = false;                // PRAGMA journal_mode=WAL (persistent in the file)
+    std::string synchronous;         // OFF, NORMAL or FULL; empty keeps SQLite's default
+    long long mmap_size = -1;        // bytes; -1 keeps SQLite's default
+    int cache_size = 0;              // PRAGMA cache_size (negative = KiB); 0 keeps the default
+    int busy_timeout_ms = 0;         // wait this long on a locked database instead of failing
+    bool quiet = false;              // no success messages on std::cout (errors still go to std::cerr)
+};
+// --------------------------------------------------------------------------------
+
+// Net effect of a span of the change log: a task inserted and then updated
+// is only inserted, one inserted and then completed does not appear.  Each
+// list is in ascending ID order.
+struct ChangeSet {
+    int64_t sequence = 0;           // the last change covered; pass it to the next changesSince
+    bool complete = true;           // false when the log no longer reaches back that far: reload instead
+    std::vector<int> inserted;
+    std::vector<int> updated;
+    std::vector<int> completed;
+};
+// --------------------------------------------------------------------------------
+
+// Receives every change made through a DB instance once it is committed, so
+// resident structures (e.g. the Scheduler) can stay in sync without
+// re-reading the table.
+class PlannerObserver
+{
+    public:
+        virtual ~PlannerObserver() = default;
+
+        virtual void taskInserted(int id, const std::string& task, const std::string& due_date, int priority) = 0;
+
+        virtual void taskCompleted(int id) = 0;
+
+        virtual void plannerUpdated(const UpdateRow& updated_row) = 0;
 };
 // ================================================================================
 
 
 class DB
 {
+    // Runs schema changes through execSQL, prepare and the transactions
+    friend class SchemaMigrator;
+
     private:
         
         char* error_msg;
         int rc;
         std::string filename;
+        DBOptions options;
+        std::vector<PlannerObserver*> observers;
+        StatementCache statements;
+        int64_t data_version;            // last PRAGMA data_version seen; -1 before the first check
+// --------------------------------------------------------------------------------
+
+        // A change held back from the observers until the transaction it
+        // was made in is durable.
+        struct Notification {
+            enum Kind { Inserted, Completed, Updated };
+            Kind kind;
+            int id;
+            std::string task;
+            std::string due_date;
+            int priority;
+            UpdateRow updated_row;
+        };
+
+        std::vector<Notification> pending_notifications;
+        std::vector<size_t> savepoints;  // size of pending_notifications as each open savepoint began
 // --------------------------------------------------------------------------------
 
         void checkDBErrors(); 
 // --------------------------------------------------------------------------------
 
-       static int callback(void* not_used, int argc, char** argv, char** azColName);
+        int execSQL(const std::string& sql);
+// --------------------------------------------------------------------------------
+
+        // Borrows the cached statement for sql, preparing it on first use.
+        int prepare(const std::string& sql, Statement& statement);
+// --------------------------------------------------------------------------------
+
+        static int bindDueKey(sqlite3_stmt* stmt, int index, const std::string& due_date);
+// --------------------------------------------------------------------------------
+
+        // Applies the journal mode and tuning pragmas from options.
+        int applyOptions();
+// --------------------------------------------------------------------------------
+
+        // Shared body of the searchTasks overloads.
+        int runSearch(const std::string& query, int limit, bool ranged, DueKey from, DueKey to,
+                      std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Drains a cursor into rows.
+        int collectTasks(TaskCursor cursor, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Inserts one PLANNER row inside the caller's transaction.
+        int insertRow(const std::string& task, const std::string& due_date, int& id);
+// --------------------------------------------------------------------------------
+
+        // Fills rule if completed_id holds a rule's pending occurrence.
+        // Returns SQLITE_ROW when it does and SQLITE_DONE when it does not.
+        int findRecurrence(int completed_id, RecurrenceRule& rule);
+// --------------------------------------------------------------------------------
+
+        // Replaces the rule's completed occurrence with the next one, or drops
+        // the rule once it has ended.  Runs inside the caller's transaction;
+        // a new occurrence is appended to inserted for the observers.
+        int advanceRecurrence(const RecurrenceRule& rule, std::vector<std::pair<int, Task>>& inserted);
+// --------------------------------------------------------------------------------
+
+        // Passes a change to the observers: at once outside a transaction,
+        // when the outermost one commits inside one.  A rolled-back
+        // savepoint drops what was queued in it.
+        void notifyInserted(int id, const std::string& task, const std::string& due_date, int priority);
+        void notifyCompleted(int id);
+        void notifyUpdated(const UpdateRow& updated_row);
+        void deliver(const Notification& notification);
 // ================================================================================
 
     public:
@@ -46,19 +250,38 @@ class DB
         DB(std::string filename);
 // --------------------------------------------------------------------------------
 
+        DB(std::string filename, const DBOptions& options);
+// --------------------------------------------------------------------------------
+
         ~DB();
 // --------------------------------------------------------------------------------
 
         void closeDB();
 // --------------------------------------------------------------------------------
         
+        // Creates the planner or brings an older one up to SCHEMA_VERSION.
         int createPlanner();
 // --------------------------------------------------------------------------------
+
+        // createPlanner with chunk size and progress reporting for large
+        // planners (see schema.hpp).
+        int migrate(const MigrationOptions& migration);
+// --------------------------------------------------------------------------------
         
         int insertTask(std::string& task, std::string& due_date);
 // --------------------------------------------------------------------------------
        
-        int completeTask(int row_num);
+        // Deletes the task with this ID.  IDs are stable and never reused;
+        // the remaining rows keep theirs.  Completing a recurring task's
+        // occurrence inserts the next one (with a new ID) in the same
+        // transaction.  An ID that does not exist is not an error, and the
+        // observers are not told about it.
+        int completeTask(int id);
+// --------------------------------------------------------------------------------
+
+        // Completes every ID in one transaction, all or nothing.  completed
+        // (when given) receives the number of IDs that existed.
+        int completeTasks(const std::vector<int>& ids, int* completed = nullptr);
 // --------------------------------------------------------------------------------
        
         int printPlanner();
@@ -66,8 +289,117 @@ class DB
         
         int updatePlanner(UpdateRow& updated_row);
 // --------------------------------------------------------------------------------
+
+        // Sets the task's priority (MIN_PRIORITY..MAX_PRIORITY; higher goes
+        // first among tasks due at the same time) through updatePlanner.
+        int setPriority(int id, int priority);
+// --------------------------------------------------------------------------------
         
-        int bulkInsertTasks(std::vector<Task>& tasks);
+        // Inserts every task through prepared (multi-row) statements inside
+        // explicit transactions.  A batch_size of 0 runs the whole load as a single
+        // all-or-nothing transaction; otherwise a transaction is committed every
+        // batch_size rows and a failure rolls back the batch in progress.
+        int bulkInsertTasks(std::vector<Task>& tasks, int batch_size = 0);
+// --------------------------------------------------------------------------------
+
+        // The count tasks with the closest due dates, earliest (then highest
+        // priority, then lowest ID) first.  Served from the ORDER_KEY index,
+        // so only count rows are read.  The queries below share this order.
+        int nextTasks(int count, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Tasks with from <= due date < to, earliest first.
+        int tasksDueBetween(DueKey from, DueKey to, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Tasks due strictly before as_of, earliest first.
+        int overdueTasks(DueKey as_of, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Up to limit tasks whose description matches query, best match
+        // (bm25) first, then in due order.  Every word must appear; a
+        // trailing * matches a prefix ("pass*") and double quotes a phrase
+        // ("tax return").  Needs SQLite with FTS5.
+        int searchTasks(const std::string& query, int limit, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // The same, limited to tasks with from <= due date < to.
+        int searchTasks(const std::string& query, int limit, DueKey from, DueKey to, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Appends the rows of those ids that still exist, in the order given.
+        int tasksById(const std::vector<int>& ids, std::vector<TaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Every task in ID order, streamed.
+        TaskCursor scanTasks();
+// --------------------------------------------------------------------------------
+
+        // Every task in due-date and priority order, streamed from the
+        // ORDER_KEY index.
+        TaskCursor scanTasksByDue();
+// --------------------------------------------------------------------------------
+
+        // Number of tasks, or -1 on error.
+        long long countTasks();
+// --------------------------------------------------------------------------------
+
+        // Stores rule and inserts its first occurrence (rule.start).  Sets
+        // rule.id, rule.pending_id and rule.pending_key.
+        int addRecurrence(RecurrenceRule& rule);
+// --------------------------------------------------------------------------------
+
+        // Every rule still producing occurrences, in ID order.
+        int listRecurrences(std::vector<RecurrenceRule>& rules);
+// --------------------------------------------------------------------------------
+
+        // Deletes the rule and its pending occurrence.
+        int removeRecurrence(int rule_id);
+// --------------------------------------------------------------------------------
+
+        // The sequence number of the latest change to PLANNER by any
+        // connection (0 before the first), or -1 on error.  Read it in the
+        // same transaction as a full load to know where to follow on from.
+        int64_t changeSequence();
+// --------------------------------------------------------------------------------
+
+        // What changed after sequence since, in O(changes).  A since ahead of
+        // the log (e.g. the file was restored from a backup) or behind a
+        // pruned part of it leaves changes.complete false.
+        int changesSince(int64_t since, ChangeSet& changes);
+// --------------------------------------------------------------------------------
+
+        // Drops the log up to and including sequence through.  Readers that
+        // have not caught up that far will have to reload.
+        int pruneChanges(int64_t through, int* pruned = nullptr);
+// --------------------------------------------------------------------------------
+
+        // True if another connection has committed since the last call (and
+        // on the first call, or if the check fails).  A pragma that reads
+        // one counter, so cheap enough to run before every read; changes
+        // made through this DB are not counted, the observers see those.
+        bool changedElsewhere();
+// --------------------------------------------------------------------------------
+
+        // Nestable transaction (SAVEPOINT); the outermost commit is durable.
+        // Observers hear about changes made inside it once that commit
+        // succeeds, and never about changes that are rolled back.
+        int beginTransaction();
+// --------------------------------------------------------------------------------
+
+        int commitTransaction();
+// --------------------------------------------------------------------------------
+
+        int rollbackTransaction();
+// --------------------------------------------------------------------------------
+
+        StatementCacheStats statementCacheStats() const;
+// --------------------------------------------------------------------------------
+
+        void addObserver(PlannerObserver* observer);
+// --------------------------------------------------------------------------------
+
+        void removeObserver(PlannerObserver* observer);
 // --------------------------------------------------------------------------------
 };
 #endif
@@ -0,0 +1,85 @@
+// ================================================================================
+// ================================================================================
+// - File:    import_export.hpp
+// - Purpose: Streaming task import and export in TSV, CSV and NDJSON.
+//
+//            Import runs as a two-stage pipeline: a parser thread reads the
+//            file (memory-mapped when it is a regular file, streamed in
+//            chunks otherwise), validates every date and hands fixed-size
+//            batches through a bounded queue to the calling thread, which
+//            inserts each batch with DB::bulkInsertTasks.  Parsing and
+//            SQLite writes overlap, and at most queue_depth + 2 batches are
+//            in memory however large the file is.
+//
+//            Export streams DB::scanTasks through a large buffer straight
+//            to the file descriptor.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef IMPORT_EXPORT_HPP
+#define IMPORT_EXPORT_HPP
+
+#include <cstdint>
+#include <string>
+#include "db.hpp"
+// --------------------------------------------------------------------------------
+
+// Record layouts.  All three carry a task and a due date and may carry an
+// id, which import ignores (tasks always get fresh IDs), and a priority,
+// which defaults to MIN_PRIORITY.  Export writes all four.
+//   Tsv     [id<TAB>]task<TAB>due_date or id<TAB>task<TAB>due_date<TAB>priority,
+//           backslash escapes as in protocol.hpp
+//   Csv     RFC 4180; a header row naming task and due_date (and
+//           optionally id and priority) may put the columns in any order
+//   Ndjson  one object per line with string "task" and "due_date" members
+//           and an optional numeric "priority"
+enum class DataFormat {
+    Tsv,
+    Csv,
+    Ndjson
+};
+// --------------------------------------------------------------------------------
+
+bool parse_data_format(const std::string& name, DataFormat& format);
+// --------------------------------------------------------------------------------
+
+// .csv -> Csv, .ndjson / .jsonl / .json -> Ndjson, anything else -> fallback.
+DataFormat data_format_for_path(const std::string& path, DataFormat fallback);
+// --------------------------------------------------------------------------------
+
+struct ImportOptions {
+    DataFormat format = DataFormat::Tsv;
+    size_t batch_size = 50000;      // rows per bulkInsertTasks call
+    size_t queue_depth = 4;         // parsed batches waiting for the writer
+    bool atomic = true;             // one enclosing transaction: every row or none
+};
+// --------------------------------------------------------------------------------
+
+struct ImportResult {
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    size_t error_line = 0;          // 1-based line of a rejected record, 0 if none
+    std::string error;              // empty on success
+};
+// --------------------------------------------------------------------------------
+
+// Imports path ("-" reads stdin).  Returns SQLITE_OK, or an error code with
+// result.error describing the first problem; nothing is kept on error when
+// options.atomic is set.
+int import_tasks(DB& db, const std::string& path, const ImportOptions& options, ImportResult& result);
+// --------------------------------------------------------------------------------
+
+// Writes every task in ID order to path ("-" writes stdout).  Returns
+// SQLITE_OK or an error code after reporting the problem on std::cerr.
+int export_tasks(DB& db, const std::string& path, DataFormat format, uint64_t* rows = nullptr);
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
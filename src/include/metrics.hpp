@@ -0,0 +1,118 @@
+// ================================================================================
+// ================================================================================
+// - File:    metrics.hpp
+// - Purpose: Process-wide counters and latency histograms for the DB and
+//            scheduler hot paths, with text, JSON and Prometheus dumps.
+//
+//            Instrumentation goes through the PLANNER_COUNT / PLANNER_TIMED
+//            macros. Building with PLANNER_METRICS=0 turns both into no-ops,
+//            so the hot paths carry no clock reads or atomics at all; the
+//            dump functions still exist and report that metrics are off.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifndef PLANNER_METRICS
+#define PLANNER_METRICS 1
+#endif
+// --------------------------------------------------------------------------------
+
+enum class MetricCounter {
+    RowsScanned,            // rows read through TaskCursor
+    RowsWritten,            // rows inserted, updated or deleted
+    DateParses,
+    DateParseErrors,
+    StatementCacheHits,
+    StatementCacheMisses,
+    DBErrors,
+    COUNT
+};
+// --------------------------------------------------------------------------------
+
+enum class MetricTimer {
+    Prepare,                // sqlite3_prepare_v3
+    Step,                   // sqlite3_step on write statements
+    Finalize,               // returning a statement: reset to the cache or finalize
+    Exec,                   // sqlite3_exec (DDL, pragmas, transaction control)
+    DbToVector,
+    NextTask,
+    HeapLoad,
+    HeapPush,
+    HeapPop,
+    HeapUpdate,             // reschedule, rename and erase
+    COUNT
+};
+// --------------------------------------------------------------------------------
+
+// Latency buckets are powers of two in nanoseconds; bucket i counts samples
+// below 2^(i+1) ns, the last one everything slower (~17 s and up).
+constexpr int METRIC_BUCKETS = 35;
+// --------------------------------------------------------------------------------
+
+const char* metric_name(MetricCounter counter);
+const char* metric_name(MetricTimer timer);
+// --------------------------------------------------------------------------------
+
+void metrics_count(MetricCounter counter, uint64_t n = 1);
+void metrics_record(MetricTimer timer, uint64_t nanoseconds);
+void metrics_reset();
+// --------------------------------------------------------------------------------
+
+void write_metrics_text(std::ostream& out);
+void write_metrics_json(std::ostream& out);
+void write_metrics_prometheus(std::ostream& out);
+// --------------------------------------------------------------------------------
+
+// JSON when the path ends in ".json", Prometheus text format otherwise.
+bool write_metrics_file(const std::string& path);
+// --------------------------------------------------------------------------------
+
+class ScopedTimer
+{
+    private:
+
+        MetricTimer timer;
+        std::chrono::steady_clock::time_point started;
+// ================================================================================
+
+    public:
+
+        explicit ScopedTimer(MetricTimer timer) : timer(timer), started(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer()
+        {
+            metrics_record(timer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - started).count()));
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+// --------------------------------------------------------------------------------
+
+#define PLANNER_METRICS_JOIN2(a, b) a##b
+#define PLANNER_METRICS_JOIN(a, b) PLANNER_METRICS_JOIN2(a, b)
+
+#if PLANNER_METRICS
+#define PLANNER_COUNT(counter, n) metrics_count(MetricCounter::counter, (n))
+#define PLANNER_TIMED(timer) ScopedTimer PLANNER_METRICS_JOIN(planner_timer_, __LINE__)(MetricTimer::timer)
+#else
+#define PLANNER_COUNT(counter, n) ((void)0)
+#define PLANNER_TIMED(timer) ((void)0)
+#endif
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -16,25 +16,56 @@
 #define MIN_HEAP_HPP
 
 #include <string>
-#include <ctime>
+#include <utility>
 #include <vector>
-#include "/usr/include/sqlite3.h"
+#include <sqlite3.h>
 #include "db.hpp"
+#include "date_key.hpp"
 // --------------------------------------------------------------------------------
 
 struct PriorityQueue
 {
     int id;
+    int priority_level;     // kept apart from order_key, which has none while !valid()
     std::string task;
-    std::string due_date_string;
-    std::tm datetime;
+    DueKey due_key;
+    OrderKey order_key;     // due_key and priority packed; the heap order
+    std::string due_date;   // the text that failed to parse; empty while valid()
 
-    PriorityQueue(int input_id, std::string intput_task, std::string input_due_date_string) : 
-                  id(input_id), task(intput_task), due_date_string(input_due_date_string)
+    PriorityQueue(int input_id, std::string intput_task, const std::string& input_due_date_string,
+                  int input_priority = MIN_PRIORITY) :
+                  id(input_id), priority_level(input_priority), task(std::move(intput_task)),
+                  due_key(INVALID_DUE_KEY), order_key(INVALID_ORDER_KEY)
                   {
-                    parseDateString();
+                    parseDateString(input_due_date_string, input_priority);
                   }
-    void parseDateString();
+
+    PriorityQueue(int input_id, std::string intput_task, DueKey input_due_key,
+                  int input_priority = MIN_PRIORITY) :
+                  id(input_id), priority_level(input_priority), task(std::move(intput_task)),
+                  due_key(input_due_key), order_key(make_order_key(input_due_key, input_priority))
+                  {
+                  }
+
+    // Sets due_key, or INVALID_DUE_KEY (keeping the text in due_date) when
+    // the text is not a valid date.
+    void parseDateString(const std::string& due_date_string, int priority = MIN_PRIORITY);
+
+    bool valid() const
+    {
+        return due_key != INVALID_DUE_KEY;
+    }
+
+    int priority() const
+    {
+        return priority_level;
+    }
+
+    void setPriority(int priority)
+    {
+        priority_level = priority;
+        order_key = make_order_key(due_key, priority);
+    }
 
     friend std::ostream& operator<<(std::ostream& os, const PriorityQueue& datetime);
 
@@ -44,35 +75,42 @@ struct PriorityQueue
 
     bool operator()(const PriorityQueue& pq1, const PriorityQueue& pq2) const
     {
-        // Compare the year first
-        if (pq1.datetime.tm_year < pq2.datetime.tm_year)
-            return true;
-        else if (pq1.datetime.tm_year > pq2.datetime.tm_year)
-            return false;
-
-        // If years are equal, compare the month
-        if (pq1.datetime.tm_mon < pq2.datetime.tm_mon)
-            return true;
-        else if (pq1.datetime.tm_mon > pq2.datetime.tm_mon)
-            return false;
-
-        // If months are equal, compare the day
-        if (pq1.datetime.tm_mday < pq2.datetime.tm_mday)
-            return true;
-        else if (pq1.datetime.tm_mday > pq2.datetime.tm_mday)
-            return false;
-
-        // If day is also equal, return false (pq1 is not less than pq2)
-        return false;
+        return pq1 < pq2;
     }
 };
 // --------------------------------------------------------------------------------
 
-std::vector<PriorityQueue> db_to_vector(DB& db);
+// What db_to_vector does with rows whose due date does not parse.
+enum class InvalidDates {
+    Keep,           // loaded with INVALID_DUE_KEY, after every valid task
+    Exclude         // left out of the result
+};
+// --------------------------------------------------------------------------------
+
+// A task whose due date does not parse.
+struct InvalidTask {
+    int id;
+    std::string task;
+    std::string due_date;
+    int priority = MIN_PRIORITY;
+};
+// --------------------------------------------------------------------------------
+
+// Loads every task.  Rows without a stored DUE_KEY are parsed together,
+// in parallel, once the scan is done; the ones that fail are appended to
+// invalid (when given) and kept or dropped according to policy.
+std::vector<PriorityQueue> db_to_vector(DB& db, InvalidDates policy = InvalidDates::Keep,
+                                        std::vector<InvalidTask>* invalid = nullptr);
+
+// --------------------------------------------------------------------------------
+
+// One-shot O(n) scan.  Callers asking repeatedly should keep a Scheduler.
+PriorityQueue next_task(const std::vector<PriorityQueue>& vec);
 
 // --------------------------------------------------------------------------------
 
-PriorityQueue next_task(std::vector<PriorityQueue>vec);
+// Streams the table in constant memory; false if the planner is empty.
+bool next_task(DB& db, TaskRow& next);
 
 // --------------------------------------------------------------------------------
 #endif
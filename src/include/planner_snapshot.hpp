@@ -0,0 +1,171 @@
+// ================================================================================
+// ================================================================================
+// - File:    planner_snapshot.hpp
+// - Purpose: Resident, structure-of-arrays copy of the PLANNER table.  IDs and
+//            due-date keys live in parallel contiguous arrays sorted by ID and
+//            every task's text sits in one string arena, so reads and
+//            next-task queries never touch SQLite.  Mutations are written
+//            through to the DB and applied back through the observer hook;
+//            other processes' writes are followed through the change log.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef PLANNER_SNAPSHOT_HPP
+#define PLANNER_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "db.hpp"
+#include "date_key.hpp"
+// --------------------------------------------------------------------------------
+
+struct SnapshotRow {
+    int id;
+    std::string_view task;      // valid until the snapshot changes
+    DueKey due_key;
+    int priority;
+};
+// ================================================================================
+
+
+class PlannerSnapshot : public PlannerObserver
+{
+    private:
+
+        static const uint32_t DEAD = UINT32_MAX;
+        static const size_t NO_SLOT = SIZE_MAX;
+
+        DB* db;
+
+        // Slot i describes one task; slots are kept in ascending ID order
+        std::vector<int> ids;
+        std::vector<OrderKey> order_keys;       // due key and priority, see make_order_key
+        std::vector<uint8_t> priorities;        // kept apart: an invalid key carries none
+        std::vector<size_t> text_offsets;        // the arena can outgrow 4 GiB; one text cannot
+        std::vector<uint32_t> text_lengths;      // DEAD marks a completed slot
+        std::string arena;
+
+        // (order key, ID) of every live task with a valid due date, so next,
+        // nextTasks and tasksDueBetween walk tasks in due order without a
+        // scan.  Keyed by ID rather than slot, which inserts and compaction
+        // shift.
+        std::set<std::pair<OrderKey, int>> due_order;
+
+        size_t live_count;
+        size_t dead_arena_bytes;
+        int64_t change_sequence;                 // the change log position the arrays reflect
+        bool catch_up_failed;                    // retry even if data_version has not moved
+// --------------------------------------------------------------------------------
+
+        size_t slotOf(int id) const;
+// --------------------------------------------------------------------------------
+
+        SnapshotRow rowAt(size_t slot) const;
+// --------------------------------------------------------------------------------
+
+        size_t appendText(std::string_view task);
+// --------------------------------------------------------------------------------
+
+        void addRow(int id, std::string_view task, DueKey due_key, int priority);
+// --------------------------------------------------------------------------------
+
+        // Patches one slot's key and moves it in due_order.
+        void setOrderKey(size_t slot, DueKey due_key, int priority);
+// --------------------------------------------------------------------------------
+
+        void compactIfNeeded();
+// --------------------------------------------------------------------------------
+
+        // Re-reads one task from the DB: revives, replaces or drops its slot.
+        void refreshRow(int id);
+// ================================================================================
+
+    public:
+
+        // Loads every task from db and follows its changes until destroyed.
+        explicit PlannerSnapshot(DB& db);
+// --------------------------------------------------------------------------------
+
+        PlannerSnapshot(const PlannerSnapshot&) = delete;
+        PlannerSnapshot& operator=(const PlannerSnapshot&) = delete;
+// --------------------------------------------------------------------------------
+
+        ~PlannerSnapshot();
+// --------------------------------------------------------------------------------
+
+        void reload();
+// --------------------------------------------------------------------------------
+
+        // Applies what other connections have changed since the last load or
+        // catch-up, read from the change log in O(changes); reloads only if
+        // the log has been pruned past that point.  Returns straight away
+        // when PRAGMA data_version shows no outside commits.
+        int catchUp();
+// --------------------------------------------------------------------------------
+
+        size_t size() const;
+// --------------------------------------------------------------------------------
+
+        bool find(int id, SnapshotRow& row) const;
+// --------------------------------------------------------------------------------
+
+        // Earliest valid due date (highest priority, then lowest ID, among
+        // equals); false if there is none.  nextTasks and tasksDueBetween
+        // use the same order.  O(log n), and O(log n + rows) for the others.
+        bool next(SnapshotRow& row) const;
+// --------------------------------------------------------------------------------
+
+        void nextTasks(size_t count, std::vector<SnapshotRow>& rows) const;
+// --------------------------------------------------------------------------------
+
+        void tasksDueBetween(DueKey from, DueKey to, std::vector<SnapshotRow>& rows) const;
+// --------------------------------------------------------------------------------
+
+        // Visits every task in ID order.
+        void forEach(const std::function<void(const SnapshotRow&)>& visit) const;
+// --------------------------------------------------------------------------------
+
+        int insertTask(std::string& task, std::string& due_date);
+// --------------------------------------------------------------------------------
+
+        int completeTask(int id);
+// --------------------------------------------------------------------------------
+
+        int updatePlanner(UpdateRow& updated_row);
+// --------------------------------------------------------------------------------
+
+        // Compares the snapshot row by row with what is on disk in db.
+        // Returns the number of differences and describes each on report.
+        size_t verify(DB& db, std::ostream* report = nullptr) const;
+// --------------------------------------------------------------------------------
+
+        // Bytes held by the arrays, the arena (capacity, not size) and the
+        // due-order index (approximate: its nodes' allocator overhead is not
+        // visible).
+        size_t memoryUsage() const;
+// --------------------------------------------------------------------------------
+
+        void taskInserted(int id, const std::string& task, const std::string& due_date, int priority) override;
+// --------------------------------------------------------------------------------
+
+        void taskCompleted(int id) override;
+// --------------------------------------------------------------------------------
+
+        void plannerUpdated(const UpdateRow& updated_row) override;
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
@@ -0,0 +1,125 @@
+// ================================================================================
+// ================================================================================
+// - File:    planner_store.hpp
+// - Purpose: Thread-safe planner store for many readers and one writer.  The
+//            database runs in WAL mode; reads go through a pool of read-only
+//            connections leased out to one thread at a time, and every write
+//            is queued onto a single writer thread that owns the only
+//            read-write connection, which commits them in groups.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef PLANNER_STORE_HPP
+#define PLANNER_STORE_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "db.hpp"
+#include "write_pipeline.hpp"
+// --------------------------------------------------------------------------------
+
+struct PlannerStoreOptions {
+    size_t readers = 4;                      // at least one; reads never use the writer
+    WritePipelineOptions writes;             // group size, delay and durability
+    long long mmap_size = 256LL << 20;       // 256 MiB per connection
+    int cache_size = -64 * 1024;             // 64 MiB of page cache per connection
+    int busy_timeout_ms = 5000;
+};
+// ================================================================================
+
+
+class PlannerStore
+{
+    private:
+
+        std::string filename;
+        int open_rc;                // first failure while opening; SQLITE_OK otherwise
+        std::unique_ptr<DB> writer_db;
+        std::vector<std::unique_ptr<DB>> readers;
+        std::vector<DB*> idle_readers;
+        std::mutex reader_mutex;
+        std::condition_variable reader_available;
+
+        std::unique_ptr<WritePipeline> pipeline;
+// --------------------------------------------------------------------------------
+
+        void returnReader(DB* db);
+// ================================================================================
+
+    public:
+
+        // A read-only connection, returned to the pool when the lease ends.
+        class ReadLease
+        {
+            private:
+                PlannerStore* store;
+                DB* connection;
+
+            public:
+                ReadLease(PlannerStore* store, DB* connection);
+                ReadLease(ReadLease&& other) noexcept;
+                ReadLease(const ReadLease&) = delete;
+                ReadLease& operator=(const ReadLease&) = delete;
+                ReadLease& operator=(ReadLease&&) = delete;
+                ~ReadLease();
+
+                DB& db() const { return *connection; }
+                DB* operator->() const { return connection; }
+        };
+// --------------------------------------------------------------------------------
+
+        // Opens (and creates if needed) the planner, switches it to WAL and
+        // starts the writer thread.  Check status() before using the store.
+        PlannerStore(const std::string& filename, const PlannerStoreOptions& options = PlannerStoreOptions());
+// --------------------------------------------------------------------------------
+
+        PlannerStore(const PlannerStore&) = delete;
+        PlannerStore& operator=(const PlannerStore&) = delete;
+// --------------------------------------------------------------------------------
+
+        // Drains the write queue, then closes every connection.
+        ~PlannerStore();
+// --------------------------------------------------------------------------------
+
+        // Blocks until a read connection is free.
+        ReadLease reader();
+// --------------------------------------------------------------------------------
+
+        // Runs job on the writer connection, in submission order and grouped
+        // with other writes into one commit.  The future holds the job's
+        // sqlite3 result code once its group is committed.
+        std::future<int> write(std::function<int(DB&)> job);
+// --------------------------------------------------------------------------------
+
+        std::future<int> insertTask(std::string task, std::string due_date);
+// --------------------------------------------------------------------------------
+
+        std::future<int> completeTask(int id);
+// --------------------------------------------------------------------------------
+
+        std::future<int> updatePlanner(UpdateRow updated_row);
+// --------------------------------------------------------------------------------
+
+        WritePipelineMetrics writeMetrics() const;
+// --------------------------------------------------------------------------------
+
+        // SQLITE_OK once every connection is open and the schema is current;
+        // otherwise the first error, and reads and writes will fail.
+        int status() const;
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
@@ -0,0 +1,57 @@
+// ================================================================================
+// ================================================================================
+// - File:    protocol.hpp
+// - Purpose: Wire format shared by the planner server and its clients.
+//
+//            Requests and responses are newline-terminated lines of
+//            TAB-separated fields.  Inside a field, backslash, TAB, CR and
+//            LF are escaped as \\ \t \r \n, so any task text fits on one line.
+//            A client may write any number of requests before reading;
+//            responses come back in request order.
+//
+//            Requests                                  Response rows
+//              PING                                      -
+//              NEXT [N]                                  task rows (earliest first)
+//              FIND ID                                   task rows (0 or 1)
+//              RANGE FROM TO                             task rows (FROM <= due < TO)
+//              COUNT                                     count
+//              ADD TASK DUE_DATE [PRIORITY]              id
+//              COMPLETE ID                               -
+//              UPDATE ID task|due_date|priority VALUE    -
+//
+//            A task row is id, task, due_date, priority; PRIORITY is 0-255
+//            and the higher one goes first on the same due date.
+//
+//            A response starts with "OK <rows>" followed by that many row
+//            lines, or is the single line "ERR <message>".
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef PROTOCOL_HPP
+#define PROTOCOL_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+// --------------------------------------------------------------------------------
+
+void append_escaped_field(std::string& out, std::string_view field);
+// --------------------------------------------------------------------------------
+
+// Appends the fields TAB-separated and escaped, plus the closing newline.
+void append_line(std::string& out, const std::vector<std::string>& fields);
+// --------------------------------------------------------------------------------
+
+// Splits one line (without its newline) into unescaped fields.
+void split_line(std::string_view line, std::vector<std::string>& fields);
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
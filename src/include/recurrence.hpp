@@ -0,0 +1,71 @@
+// ================================================================================
+// ================================================================================
+// - File:    recurrence.hpp
+// - Purpose: Recurrence rules for repeating tasks.  A rule is stored once in
+//            the RECURRENCE table and only its next occurrence exists as a
+//            PLANNER row; completing that row makes DB produce the one after
+//            it.  Storage and scans therefore grow with the number of rules,
+//            not with the number of occurrences.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef RECURRENCE_HPP
+#define RECURRENCE_HPP
+
+#include <string>
+#include "date_key.hpp"
+// --------------------------------------------------------------------------------
+
+// "Every N days" is Daily with an interval of N.
+enum class Frequency {
+    Daily,
+    Weekly,
+    Monthly
+};
+// --------------------------------------------------------------------------------
+
+// "daily", "weekly" or "monthly".
+bool parse_frequency(const std::string& name, Frequency& frequency);
+// --------------------------------------------------------------------------------
+
+const char* frequency_name(Frequency frequency);
+// --------------------------------------------------------------------------------
+
+struct RecurrenceRule {
+    int id = 0;
+    std::string task;
+    DueKey start = INVALID_DUE_KEY;         // first occurrence; fixes the time of day
+    Frequency frequency = Frequency::Daily;
+    int interval = 1;                       // every interval days / weeks / months
+    DueKey until = INVALID_DUE_KEY;         // last allowed occurrence, INVALID_DUE_KEY for none; see recurrence_end
+    int pending_id = 0;                     // PLANNER row holding the next occurrence
+    DueKey pending_key = INVALID_DUE_KEY;   // scheduled key of that occurrence
+};
+// --------------------------------------------------------------------------------
+
+// The first occurrence strictly after after, or INVALID_DUE_KEY once the rule
+// has ended.  Occurrences are counted from start, so monthly rules keep
+// their day of month (clamped to shorter months) and rescheduling one
+// occurrence does not shift the ones after it.
+DueKey next_occurrence(const RecurrenceRule& rule, DueKey after);
+// --------------------------------------------------------------------------------
+
+// The latest key an occurrence may fall on.  An until without a time of day
+// (stored as midnight) allows the whole of that date, so a 09:00 rule
+// "until 2026-01-31" still has its 09:00 occurrence on the 31st.
+DueKey recurrence_end(const RecurrenceRule& rule);
+// --------------------------------------------------------------------------------
+
+// "every 2 weeks until 2027-01-01" and the like.
+std::string describe_recurrence(const RecurrenceRule& rule);
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
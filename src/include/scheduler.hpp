@@ -0,0 +1,145 @@
+// ================================================================================
+// ================================================================================
+// - File:    scheduler.hpp
+// - Purpose: Long-lived next-task scheduler.  Keeps every task in an indexed
+//            4-ary min heap keyed by task ID so "what's next" is O(1) and
+//            push/pop/reschedule/erase are O(log n).  Registers itself as a
+//            PlannerObserver so it follows inserts, updates and completions
+//            made through the DB it was loaded from.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "db.hpp"
+#include "min_heap.hpp"
+// --------------------------------------------------------------------------------
+
+class Scheduler : public PlannerObserver
+{
+    private:
+
+        static const size_t ARITY = 4;
+
+        DB* db;
+        std::vector<PriorityQueue> heap;
+        std::unordered_map<int, size_t> position;
+        std::unordered_map<int, InvalidTask> invalid;   // tasks kept out of the heap
+// --------------------------------------------------------------------------------
+
+        static bool before(const PriorityQueue& pq1, const PriorityQueue& pq2);
+// --------------------------------------------------------------------------------
+
+        void swapNodes(size_t i, size_t j);
+// --------------------------------------------------------------------------------
+
+        void siftUp(size_t i);
+// --------------------------------------------------------------------------------
+
+        void siftDown(size_t i);
+// --------------------------------------------------------------------------------
+
+        void restore(size_t i);
+// --------------------------------------------------------------------------------
+
+        void replace(PriorityQueue item);
+// --------------------------------------------------------------------------------
+
+        void removeAt(size_t i);
+// --------------------------------------------------------------------------------
+
+        // Takes the task out of the heap (if there) and parks it in invalid.
+        void setInvalid(InvalidTask task);
+// ================================================================================
+
+    public:
+
+        Scheduler();
+// --------------------------------------------------------------------------------
+
+        // Loads every task from db and follows its changes until destroyed.
+        explicit Scheduler(DB& db);
+// --------------------------------------------------------------------------------
+
+        // Same as above for callers that already read the rows.
+        Scheduler(DB& db, std::vector<PriorityQueue> rows, std::vector<InvalidTask> invalid_rows = {});
+// --------------------------------------------------------------------------------
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+// --------------------------------------------------------------------------------
+
+        ~Scheduler();
+// --------------------------------------------------------------------------------
+
+        // Replaces the contents with rows, O(n) heapify.  Rows without a
+        // valid due date never enter the heap; they are listed by
+        // invalidTasks() together with invalid_rows.
+        void load(std::vector<PriorityQueue> rows, std::vector<InvalidTask> invalid_rows = {});
+// --------------------------------------------------------------------------------
+
+        // Re-reads the whole table from the attached DB.
+        void reload();
+// --------------------------------------------------------------------------------
+
+        // Tasks whose due date does not parse, by ID.  They are not scheduled
+        // until a reschedule gives them a valid date.
+        const std::unordered_map<int, InvalidTask>& invalidTasks() const;
+// --------------------------------------------------------------------------------
+
+        bool empty() const;
+// --------------------------------------------------------------------------------
+
+        size_t size() const;
+// --------------------------------------------------------------------------------
+
+        bool contains(int id) const;
+// --------------------------------------------------------------------------------
+
+        // Adds a task, or replaces the entry with the same ID.  An item
+        // without a valid due date is set aside instead.
+        void push(PriorityQueue item);
+// --------------------------------------------------------------------------------
+
+        // Task with the closest due date.  The scheduler must not be empty.
+        const PriorityQueue& peek() const;
+// --------------------------------------------------------------------------------
+
+        PriorityQueue pop();
+// --------------------------------------------------------------------------------
+
+        bool reschedule(int id, const std::string& due_date);
+// --------------------------------------------------------------------------------
+
+        bool rename(int id, const std::string& task);
+// --------------------------------------------------------------------------------
+
+        bool reprioritize(int id, int priority);
+// --------------------------------------------------------------------------------
+
+        bool erase(int id);
+// --------------------------------------------------------------------------------
+
+        void taskInserted(int id, const std::string& task, const std::string& due_date, int priority) override;
+// --------------------------------------------------------------------------------
+
+        void taskCompleted(int id) override;
+// --------------------------------------------------------------------------------
+
+        void plannerUpdated(const UpdateRow& updated_row) override;
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
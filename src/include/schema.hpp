@@ -0,0 +1,137 @@
+// ================================================================================
+// ================================================================================
+// - File:    schema.hpp
+// - Purpose: Versioned schema migrations for the planner file.  The version
+//            lives in PRAGMA user_version; each migration moves it up by one.
+//            Files from before versioning (user_version 0) are placed by
+//            looking at their tables.  Migrations that touch every row run
+//            in chunked transactions, so a large planner is upgraded while
+//            other connections keep reading and writing between chunks.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef SCHEMA_HPP
+#define SCHEMA_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+// --------------------------------------------------------------------------------
+
+class DB;
+// --------------------------------------------------------------------------------
+
+// Versions:
+//   1  PLANNER with ID INTEGER PRIMARY KEY, TASK and DUE_DATE
+//   2  DUE_KEY, the parsed due date
+//   3  PRIORITY and the generated ORDER_KEY with its index
+//   4  RECURRENCE
+//   5  PLANNER_FTS full-text index (skipped when SQLite lacks FTS5)
+//   6  PLANNER_CHANGES change log
+//   7  PLANNER.ID declared AUTOINCREMENT, so IDs are never reused
+const int SCHEMA_VERSION = 7;
+// --------------------------------------------------------------------------------
+
+// PLANNER_CHANGES.KIND: what a write did to the row with TASK_ID
+const int CHANGE_INSERTED = 0;
+const int CHANGE_UPDATED = 1;
+const int CHANGE_COMPLETED = 2;
+// --------------------------------------------------------------------------------
+
+struct MigrationProgress {
+    int version;                // the version being migrated to
+    const char* description;
+    int64_t done;               // rows processed so far
+    int64_t total;              // rows to process; 0 for steps that are not chunked
+};
+// --------------------------------------------------------------------------------
+
+struct MigrationOptions {
+    int64_t chunk_rows = 50000;     // rows per transaction in chunked steps
+    // Called as each step starts (done == 0) and after every chunk.
+    std::function<void(const MigrationProgress&)> progress;
+};
+// ================================================================================
+
+
+class SchemaMigrator
+{
+    private:
+
+        DB& db;
+        MigrationOptions options;
+        bool nested;        // the open transaction is a savepoint inside the caller's
+// --------------------------------------------------------------------------------
+
+        void report(int version, int64_t done, int64_t total);
+// --------------------------------------------------------------------------------
+
+        // Write transactions take the write lock up front (BEGIN IMMEDIATE),
+        // so a chunk that reads and then writes cannot lose a race with
+        // another writer; inside a caller's transaction they nest instead.
+        int beginWrite();
+        int commitWrite();
+        void rollbackWrite();
+// --------------------------------------------------------------------------------
+
+        // Reads user_version; for an unversioned file, works the version out
+        // from the tables present (0 for the original lowercase planner whose
+        // id is not a rowid, -1 for an empty file).
+        int detectVersion(int& version);
+// --------------------------------------------------------------------------------
+
+        bool hasTable(const std::string& name);
+        bool hasColumn(const std::string& table, const std::string& column);
+        bool hasAutoincrement();        // PLANNER.ID is declared AUTOINCREMENT
+// --------------------------------------------------------------------------------
+
+        // Runs body and sets user_version in one transaction.
+        int inTransaction(int version, const std::function<int()>& body);
+// --------------------------------------------------------------------------------
+
+        int createRecurrenceTables();
+        int createSearchTables();
+        int createSearchTriggers();
+        int createChangeLog();
+// --------------------------------------------------------------------------------
+
+        int createLatest();
+        // Copies PLANNER into a table keyed by an AUTOINCREMENT rowid in
+        // chunks and swaps it in, recording version.
+        int rebuildPlanner(int version);
+        int rebuildWithRowid();         // 0 -> 1
+        int addDueKeys();               // 1 -> 2
+        int addPriority();              // 2 -> 3
+        int addRecurrence();            // 3 -> 4
+        int addSearchIndex();           // 4 -> 5
+        int addChangeLog();             // 5 -> 6
+        int addAutoincrement();         // 6 -> 7
+// ================================================================================
+
+    public:
+
+        SchemaMigrator(DB& db, const MigrationOptions& options = MigrationOptions());
+// --------------------------------------------------------------------------------
+
+        // The file's schema version (see detectVersion), or -1 on error.
+        int currentVersion();
+// --------------------------------------------------------------------------------
+
+        // Brings the file up to SCHEMA_VERSION.  Fails without changes if the
+        // file was written by a newer version of the planner.
+        int migrate();
+// --------------------------------------------------------------------------------
+
+        static const char* describe(int version);
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,182 @@
+// ================================================================================
+// ================================================================================
+// - File:    server.hpp
+// - Purpose: Long-running planner daemon.  Keeps one DB connection and a
+//            resident PlannerSnapshot loaded and serves the protocol in
+//            protocol.hpp over a Unix domain socket.
+//
+//            One thread runs an epoll loop that accepts, reads and writes
+//            without blocking.  Complete request lines are handed to a
+//            worker pool a connection at a time, so a connection's
+//            pipelined requests are answered in order while different
+//            connections are served in parallel.  Reads share the snapshot
+//            under a shared lock; writes go through the DB under an
+//            exclusive one.  Other processes writing the same file are
+//            followed through the change log (see PlannerSnapshot::catchUp).
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "db.hpp"
+#include "planner_snapshot.hpp"
+// --------------------------------------------------------------------------------
+
+struct ServerOptions {
+    int workers = 4;
+    size_t max_line_bytes = 1 << 20;        // a longer request closes the connection
+    size_t max_output_bytes = 8 << 20;      // stop reading from a client this far behind
+    int max_next = 10000;                   // cap on NEXT N
+    int refresh_ms = 100;                   // follow other writers' changes this often; 0 never
+};
+// --------------------------------------------------------------------------------
+
+class PlannerServer
+{
+    private:
+
+        struct Connection {
+            int fd;
+            std::string input;
+            std::string output;
+            size_t output_sent = 0;
+            bool busy = false;              // a worker holds this connection's requests
+            bool eof = false;               // the client closed its write side
+            uint32_t events = 0;
+        };
+
+        struct Job {
+            uint64_t connection;
+            std::string requests;
+        };
+
+        struct Completion {
+            uint64_t connection;
+            std::string responses;
+        };
+
+        static const uint64_t LISTEN_ID = 0;
+        static const uint64_t WAKE_ID = 1;
+
+        DB& db;
+        ServerOptions options;
+        PlannerSnapshot snapshot;
+        std::shared_mutex state_mutex;
+
+        std::string socket_path;
+        int listen_fd;
+        int epoll_fd;
+        int wake_fd;
+        std::atomic<bool> stopping;
+        std::atomic<uint64_t> requests_served;
+        std::atomic<int64_t> next_refresh;     // steady_clock nanoseconds
+
+        // Touched only by the event loop thread
+        std::unordered_map<uint64_t, Connection> connections;
+        uint64_t next_connection;
+
+        std::mutex jobs_mutex;
+        std::condition_variable jobs_ready;
+        std::deque<Job> jobs;
+        bool workers_stopping;
+        std::vector<std::thread> workers;
+
+        std::mutex completions_mutex;
+        std::vector<Completion> completions;
+// ================================================================================
+
+        void workerLoop();
+// --------------------------------------------------------------------------------
+
+        void handleRequests(const std::string& requests, std::string& responses);
+// --------------------------------------------------------------------------------
+
+        void handleRequest(const std::vector<std::string>& fields, std::string& out);
+// --------------------------------------------------------------------------------
+
+        // Runs a DB write under the exclusive lock; the snapshot follows it
+        // through the observer hook before readers see it again.
+        template <typename Write>
+        int writeLocked(Write write);
+// --------------------------------------------------------------------------------
+
+        // At most once per refresh_ms, brings the snapshot up to date with
+        // commits from other processes before a job is served.
+        void refreshIfDue();
+// --------------------------------------------------------------------------------
+
+        void acceptConnections();
+// --------------------------------------------------------------------------------
+
+        void readConnection(uint64_t id);
+// --------------------------------------------------------------------------------
+
+        void writeConnection(uint64_t id);
+// --------------------------------------------------------------------------------
+
+        void dispatch(uint64_t id);
+// --------------------------------------------------------------------------------
+
+        void drainCompletions();
+// --------------------------------------------------------------------------------
+
+        // Closes the connection once it has nothing left to answer or send.
+        void finishIfDone(uint64_t id);
+// --------------------------------------------------------------------------------
+
+        void closeConnection(uint64_t id);
+// --------------------------------------------------------------------------------
+
+        void updateEvents(uint64_t id);
+// ================================================================================
+
+    public:
+
+        // db must outlive the server; the snapshot follows its changes.
+        explicit PlannerServer(DB& db, const ServerOptions& options = ServerOptions());
+// --------------------------------------------------------------------------------
+
+        PlannerServer(const PlannerServer&) = delete;
+        PlannerServer& operator=(const PlannerServer&) = delete;
+// --------------------------------------------------------------------------------
+
+        ~PlannerServer();
+// --------------------------------------------------------------------------------
+
+        // Binds the socket (replacing a stale socket file) and starts the
+        // workers.  Returns 0 or -1 after reporting the error.
+        int listen(const std::string& path);
+// --------------------------------------------------------------------------------
+
+        // Serves until requestStop().  Returns 0 on a clean stop.
+        int run();
+// --------------------------------------------------------------------------------
+
+        // Safe to call from a signal handler or another thread.
+        void requestStop();
+// --------------------------------------------------------------------------------
+
+        uint64_t requestsServed() const;
+};
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
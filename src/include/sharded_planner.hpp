@@ -0,0 +1,153 @@
+// ================================================================================
+// ================================================================================
+// - File:    sharded_planner.hpp
+// - Purpose: One logical planner spread over several planner files (shards),
+//            each a PlannerStore with its own writer thread and reader pool.
+//            Tasks are placed by a stable hash of their project (or of the
+//            task text when there is none), so each shard's writer lock only
+//            sees its own share of the writes.  Queries run on every shard
+//            in parallel and the per-shard results, already in due order,
+//            are combined with a k-way merge.
+//
+//            Task IDs are per shard; rows carry their shard index, and
+//            updates and completions name both.  A query sees each shard as
+//            of its own read, not one snapshot across shards.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef SHARDED_PLANNER_HPP
+#define SHARDED_PLANNER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "planner_store.hpp"
+// --------------------------------------------------------------------------------
+
+struct ShardedPlannerOptions {
+    PlannerStoreOptions store;      // applied to every shard
+    // Threads that run the other shards' part of a query while the caller
+    // runs the first shard's; 0 means one per additional shard.
+    size_t fanout_threads = 0;
+};
+// --------------------------------------------------------------------------------
+
+struct ShardTaskRow {
+    size_t shard;
+    TaskRow task;
+};
+// --------------------------------------------------------------------------------
+
+// 64-bit FNV-1a.  Unlike std::hash it is the same in every build, so a
+// project stays on the shard that already holds its tasks.
+uint64_t shard_hash(std::string_view key);
+// ================================================================================
+
+
+class ShardedPlanner
+{
+    private:
+
+        std::vector<std::unique_ptr<PlannerStore>> shards;
+
+        std::mutex jobs_mutex;
+        std::condition_variable jobs_ready;
+        std::deque<std::function<void()>> jobs;
+        bool workers_stopping;
+        std::vector<std::thread> workers;
+// --------------------------------------------------------------------------------
+
+        void workerLoop();
+// --------------------------------------------------------------------------------
+
+        // Runs query(shard, connection) on a read connection of every shard
+        // at once and waits for all of them.  Returns the first error.
+        int fanOut(const std::function<int(size_t, DB&)>& query);
+// --------------------------------------------------------------------------------
+
+        // Merges the per-shard lists (each in due order) into rows, keeping
+        // at most limit of them.  Ties on the order key go to the lower ID,
+        // as in PriorityQueue, then to the lower shard.
+        static void merge(std::vector<std::vector<TaskRow>>& per_shard, size_t limit,
+                          std::vector<ShardTaskRow>& rows);
+// ================================================================================
+
+    public:
+
+        // Opens (and creates if needed) one PlannerStore per file; there
+        // must be at least one.  The order of filenames fixes the shard
+        // indexes and must not change.  Check status() before using it.
+        ShardedPlanner(const std::vector<std::string>& filenames,
+                       const ShardedPlannerOptions& options = ShardedPlannerOptions());
+// --------------------------------------------------------------------------------
+
+        ShardedPlanner(const ShardedPlanner&) = delete;
+        ShardedPlanner& operator=(const ShardedPlanner&) = delete;
+// --------------------------------------------------------------------------------
+
+        // Stops the fan-out threads, then drains and closes every shard.
+        ~ShardedPlanner();
+// --------------------------------------------------------------------------------
+
+        size_t shardCount() const;
+// --------------------------------------------------------------------------------
+
+        // SQLITE_OK if every shard opened; otherwise the first shard's error.
+        int status() const;
+// --------------------------------------------------------------------------------
+
+        PlannerStore& shard(size_t index);
+// --------------------------------------------------------------------------------
+
+        // The shard that owns key (a project name or a task's text).
+        size_t shardFor(std::string_view key) const;
+// --------------------------------------------------------------------------------
+
+        // Queues the insert on the owning shard: shardFor(project), or
+        // shardFor(task) without a project.  shard (when given) receives
+        // the index.
+        std::future<int> insertTask(std::string task, std::string due_date, std::string_view project = {},
+                                    size_t* shard = nullptr);
+// --------------------------------------------------------------------------------
+
+        std::future<int> completeTask(size_t shard, int id);
+// --------------------------------------------------------------------------------
+
+        std::future<int> updatePlanner(size_t shard, UpdateRow updated_row);
+// --------------------------------------------------------------------------------
+
+        // The count tasks with the closest due dates across all shards, in
+        // the order of DB::nextTasks.  Each shard reads only count rows.
+        int nextTasks(int count, std::vector<ShardTaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Tasks with from <= due date < to, earliest first.
+        int tasksDueBetween(DueKey from, DueKey to, std::vector<ShardTaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Tasks due strictly before as_of, earliest first.
+        int overdueTasks(DueKey as_of, std::vector<ShardTaskRow>& rows);
+// --------------------------------------------------------------------------------
+
+        // Tasks on every shard, or -1 on error.
+        long long countTasks();
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,121 @@
+// ================================================================================
+// ================================================================================
+// - File:    statement.hpp
+// - Purpose: RAII handles for prepared statements and the per-connection cache
+//            DB keeps them in, so hot operations skip sqlite3_prepare and no
+//            error path can leak a statement.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef STATEMENT_HPP
+#define STATEMENT_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <sqlite3.h>
+// --------------------------------------------------------------------------------
+
+struct StatementCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    size_t cached;
+};
+// ================================================================================
+
+
+// Borrowed (cached) statements are reset and unbound when the handle is
+// released; owned ones are finalized.  Move-only.
+class Statement
+{
+    private:
+
+        sqlite3_stmt* stmt;
+        bool* in_use;
+// ================================================================================
+
+    public:
+
+        Statement();
+// --------------------------------------------------------------------------------
+
+        // in_use is the cache slot to hand back, or nullptr for an owned
+        // statement.
+        Statement(sqlite3_stmt* stmt, bool* in_use);
+// --------------------------------------------------------------------------------
+
+        Statement(Statement&& other) noexcept;
+        Statement& operator=(Statement&& other) noexcept;
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+// --------------------------------------------------------------------------------
+
+        ~Statement();
+// --------------------------------------------------------------------------------
+
+        sqlite3_stmt* get() const;
+// --------------------------------------------------------------------------------
+
+        explicit operator bool() const;
+// --------------------------------------------------------------------------------
+
+        // Returns the statement to the cache (or finalizes it) early.
+        void release();
+// --------------------------------------------------------------------------------
+};
+// ================================================================================
+
+
+class StatementCache
+{
+    private:
+
+        struct Entry {
+            sqlite3_stmt* stmt;
+            bool in_use;
+        };
+
+        // Dynamic SQL (e.g. updatePlanner's column names) could otherwise grow
+        // the cache without bound; past this, statements are prepared uncached.
+        static const size_t MAX_ENTRIES = 64;
+
+        std::unordered_map<std::string, Entry> entries;
+        uint64_t hits;
+        uint64_t misses;
+// ================================================================================
+
+    public:
+
+        StatementCache();
+// --------------------------------------------------------------------------------
+
+        StatementCache(const StatementCache&) = delete;
+        StatementCache& operator=(const StatementCache&) = delete;
+// --------------------------------------------------------------------------------
+
+        ~StatementCache();
+// --------------------------------------------------------------------------------
+
+        // Hands out the cached statement for sql, preparing it on a miss.  If
+        // the cached one is still held elsewhere (e.g. nested cursors) a
+        // private statement is prepared instead.  Returns the sqlite3 code.
+        int acquire(sqlite3* db, const std::string& sql, Statement& statement);
+// --------------------------------------------------------------------------------
+
+        // Finalizes every cached statement; must run before sqlite3_close.
+        void clear();
+// --------------------------------------------------------------------------------
+
+        StatementCacheStats stats() const;
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
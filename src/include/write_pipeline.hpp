@@ -0,0 +1,134 @@
+// ================================================================================
+// ================================================================================
+// - File:    write_pipeline.hpp
+// - Purpose: Asynchronous group-commit write pipeline in front of a DB.
+//            Callers enqueue mutations and get a future; a background writer
+//            drains the queue and commits whole groups in one transaction,
+//            so a burst of small edits pays for one journal sync instead of
+//            one per edit.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef WRITE_PIPELINE_HPP
+#define WRITE_PIPELINE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "db.hpp"
+// --------------------------------------------------------------------------------
+
+// How hard a committed group is pushed to disk (PRAGMA synchronous).
+enum class Durability {
+    None,       // OFF: fastest, a power loss can lose the last groups
+    Normal,     // NORMAL: durable except for the last groups on power loss in WAL mode
+    Full        // FULL: every group is synced before its futures resolve
+};
+// --------------------------------------------------------------------------------
+
+struct WritePipelineOptions {
+    size_t max_batch_size = 256;
+    // Mutations that arrive while a group is committing form the next group
+    // on their own; max_delay additionally holds a lone mutation back this
+    // long so a slower trickle can still be grouped.
+    std::chrono::microseconds max_delay{0};
+    Durability durability = Durability::Normal;
+};
+// --------------------------------------------------------------------------------
+
+struct WritePipelineMetrics {
+    static const int BUCKETS = 16;
+
+    uint64_t batches;
+    uint64_t mutations;
+    uint64_t failed_mutations;
+    uint64_t failed_commits;
+
+    // batch_sizes[i] counts groups of size [2^i, 2^(i+1))
+    uint64_t batch_sizes[BUCKETS];
+
+    // commit_latency_us[i] counts commits that took [2^i, 2^(i+1)) microseconds
+    uint64_t commit_latency_us[BUCKETS];
+    double total_commit_us;
+    double max_commit_us;
+};
+// ================================================================================
+
+
+class WritePipeline
+{
+    private:
+
+        struct Mutation {
+            std::function<int(DB&)> apply;
+            std::promise<int> result;
+        };
+
+        DB& db;
+        WritePipelineOptions options;
+
+        std::deque<Mutation> queue;
+        std::mutex queue_mutex;
+        std::condition_variable queue_ready;
+        bool stopping;
+
+        WritePipelineMetrics stats;
+        mutable std::mutex stats_mutex;
+
+        std::thread writer_thread;
+// --------------------------------------------------------------------------------
+
+        void writerLoop();
+// --------------------------------------------------------------------------------
+
+        void commitGroup(std::deque<Mutation>& group);
+// ================================================================================
+
+    public:
+
+        // db must outlive the pipeline and only be written through it.
+        WritePipeline(DB& db, const WritePipelineOptions& options = WritePipelineOptions());
+// --------------------------------------------------------------------------------
+
+        WritePipeline(const WritePipeline&) = delete;
+        WritePipeline& operator=(const WritePipeline&) = delete;
+// --------------------------------------------------------------------------------
+
+        // Commits everything still queued, then stops the writer.
+        ~WritePipeline();
+// --------------------------------------------------------------------------------
+
+        // Queues a mutation.  It runs inside its own savepoint, so a failing
+        // mutation is rolled back alone; the future resolves with its result
+        // once the group it belongs to has committed.
+        std::future<int> submit(std::function<int(DB&)> mutation);
+// --------------------------------------------------------------------------------
+
+        std::future<int> insertTask(std::string task, std::string due_date);
+// --------------------------------------------------------------------------------
+
+        std::future<int> completeTask(int id);
+// --------------------------------------------------------------------------------
+
+        std::future<int> updatePlanner(UpdateRow updated_row);
+// --------------------------------------------------------------------------------
+
+        WritePipelineMetrics metrics() const;
+// --------------------------------------------------------------------------------
+};
+#endif
+// ================================================================================
+// ================================================================================
+//eof
@@ -12,32 +12,385 @@
 // ================================================================================
 #include "include/db.hpp"
 #include "include/min_heap.hpp"
+#include "include/scheduler.hpp"
+#include "include/planner_snapshot.hpp"
+#include "include/metrics.hpp"
+#include "include/cli.hpp"
+#include "include/server.hpp"
+#include "include/alert_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <sqlite3.h>
 #include <iomanip>
+#include <thread>
 // ================================================================================
 // ================================================================================
 
-int main() 
+// Serves the listing and next task from a resident PlannerSnapshot and
+// checks it against the file.
+static int run_in_memory(DB& db)
 {
-    
-    std::string filename{"../data/planner.db"};
+    PlannerSnapshot snapshot(db);
+
+    snapshot.forEach([](const SnapshotRow& row) {
+        std::cout << "ID: " << row.id << ", Task: " << row.task << ", Due Date: "
+                  << format_due_key(row.due_key) << "\n";
+    });
+
+    SnapshotRow next{};
+    if (snapshot.next(next)) {
+        std::cout << "\nYour next task is: ID: " << next.id << ", Task: " << next.task
+                  << ", Due Date: " << format_due_key(next.due_key) << "\n";
+    }
+    else {
+        std::cout << "\nYour planner is empty.\n";
+    }
+
+    size_t differences = snapshot.verify(db, &std::cerr);
+    std::cout << "\nIn-memory planner: " << snapshot.size() << " tasks, "
+              << snapshot.memoryUsage() << " bytes, "
+              << (differences == 0 ? "consistent with disk" : "DIFFERS from disk") << "\n\n";
+    return differences == 0 ? 0 : 1;
+}
+// --------------------------------------------------------------------------------
 
-    DB db(filename);
+static int run_planner(DB& db)
+{
+    std::vector<InvalidTask> invalid;
+    std::vector<PriorityQueue> vec = db_to_vector(db, InvalidDates::Keep, &invalid);
 
-    std::vector<PriorityQueue> vec = db_to_vector(db);
+    {
+        // Both lists are in ID order, so the stored text of each unparsable
+        // date is found by walking them together
+        RowWriter out(std::cout, OutputFormat::Text);
+        size_t next_invalid = 0;
+        for (auto& item : vec) {
+            std::string_view due_date;
+            if (!item.valid() && next_invalid < invalid.size() && invalid[next_invalid].id == item.id)
+                due_date = invalid[next_invalid++].due_date;
+            out.row(item.id, item.task, item.due_key, due_date);
+        }
+    }
 
-    for (auto& item : vec){
-        std::cout << item << std::endl;
+    Scheduler scheduler(db, vec, std::move(invalid));
+    if (!scheduler.invalidTasks().empty()) {
+        std::cerr << "\n" << scheduler.invalidTasks().size()
+                  << " task(s) with an invalid due date are not scheduled\n";
     }
 
-    PriorityQueue next = next_task(vec);
+    if (scheduler.empty()) {
+        std::cout << "\nYour planner is empty.\n\n";
+        return 0;
+    }
 
-    std::cout << std::endl << "Your next task is: " << next << std::endl << std::endl;
+    std::cout << "\nYour next task is: " << scheduler.peek() << "\n\n";
 
     return 0;
+}
+// --------------------------------------------------------------------------------
+
+static PlannerServer* active_server = nullptr;
+
+static void stop_server(int)
+{
+    if (active_server)
+        active_server->requestStop();
+}
+// --------------------------------------------------------------------------------
+
+// Keeps the planner resident and answers requests on a Unix socket until
+// SIGINT or SIGTERM.
+static int run_server(DB& db, const std::vector<std::string>& command)
+{
+    if (command.size() < 2 || command.size() > 3) {
+        std::cerr << "Usage: main [--db PATH] serve SOCKET [WORKERS]" << std::endl;
+        return 2;
+    }
+    ServerOptions server_options;
+    if (command.size() == 3)
+        server_options.workers = std::max(1, std::atoi(command[2].c_str()));
+
+    PlannerServer server(db, server_options);
+    if (server.listen(command[1]) != 0)
+        return 1;
+
+    active_server = &server;
+    std::signal(SIGINT, stop_server);
+    std::signal(SIGTERM, stop_server);
+    std::cerr << "Serving " << command[1] << " with " << server_options.workers << " workers" << std::endl;
+    int result = server.run();
+    active_server = nullptr;
+
+    std::cerr << "Stopped after " << server.requestsServed() << " requests" << std::endl;
+    return result == 0 ? 0 : 1;
+}
+// --------------------------------------------------------------------------------
+
+static volatile std::sig_atomic_t stop_watching = 0;
+
+static void stop_watch(int)
+{
+    stop_watching = 1;
+}
+// --------------------------------------------------------------------------------
+
+// Writes an alert to stdout as each task falls due (and LEAD_MINUTES before
+// it, for each lead given) until SIGINT or SIGTERM.  Changes made by other
+// processes are picked up from the change log within a second.
+static int run_watch(DB& db, const std::vector<std::string>& command, OutputFormat format)
+{
+    AlertOptions alert_options;
+    if (command.size() > 1) {
+        alert_options.lead_minutes.clear();
+    }
+    for (size_t i = 1; i < command.size(); i++) {
+        char* end = nullptr;
+        long lead = std::strtol(command[i].c_str(), &end, 10);
+        if (command[i].empty() || *end != '\0' || lead < 0 || lead > INT32_MAX) {
+            std::cerr << "Usage: main [--db PATH] watch [LEAD_MINUTES...]" << std::endl;
+            return 2;
+        }
+        alert_options.lead_minutes.push_back(static_cast<int>(lead));
+    }
+
+    RowWriter out(std::cout, format);
+    std::vector<TaskRow> rows;
+    AlertEngine engine(db, [&](const Alert& alert) {
+        rows.clear();
+        db.tasksById({alert.id}, rows);
+        out.alert(alert, rows.empty() ? std::string_view() : std::string_view(rows[0].task));
+    }, local_minute_now(), alert_options);
 
+    std::signal(SIGINT, stop_watch);
+    std::signal(SIGTERM, stop_watch);
+    std::cerr << "Watching " << engine.pending() << " alerts" << std::endl;
+    while (!stop_watching) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        engine.catchUp();
+        engine.advance(local_minute_now());
+        out.flush();
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+// Upgrades the planner in chunks of CHUNK_ROWS rows, reporting progress on
+// stderr.  Other processes can keep using the planner between chunks.
+static int run_migrate(DB& db, const std::vector<std::string>& command)
+{
+    MigrationOptions migration;
+    if (command.size() == 2)
+        migration.chunk_rows = std::atoll(command[1].c_str());
+    if (command.size() > 2 || migration.chunk_rows <= 0) {
+        std::cerr << "Usage: main [--db PATH] migrate [CHUNK_ROWS]" << std::endl;
+        return 2;
+    }
+
+    int from = SchemaMigrator(db).currentVersion();
+    migration.progress = [](const MigrationProgress& progress) {
+        std::cerr << "Version " << progress.version << " (" << progress.description << ")";
+        if (progress.total > 0)
+            std::cerr << ": " << progress.done << " / " << progress.total << " rows";
+        std::cerr << std::endl;
+    };
+    if (db.migrate(migration) != SQLITE_OK)
+        return 1;
+
+    if (from == SCHEMA_VERSION)
+        std::cout << "Schema version " << SCHEMA_VERSION << " is current" << std::endl;
+    else if (from < 0)
+        std::cout << "Created a planner with schema version " << SCHEMA_VERSION << std::endl;
+    else
+        std::cout << "Migrated from schema version " << from << " to " << SCHEMA_VERSION << std::endl;
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+// Gives an empty file the current schema.  An older planner is left as it
+// is: a full migration can take a while, so it only runs through `migrate`,
+// which shows its progress.
+static int open_planner(DB& db)
+{
+    int version = SchemaMigrator(db).currentVersion();
+    if (version < 0)
+        return db.createPlanner();
+    if (version < SCHEMA_VERSION) {
+        std::cerr << "Error: the planner has schema version " << version << " and this program needs version "
+                  << SCHEMA_VERSION << "; run `planner migrate` first" << std::endl;
+        return SQLITE_ERROR;
+    }
+    if (version > SCHEMA_VERSION) {
+        std::cerr << "Error: the planner has schema version " << version << "; this program supports up to "
+                  << SCHEMA_VERSION << std::endl;
+        return SQLITE_ERROR;
+    }
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+static void print_usage()
+{
+    std::cerr <<
+        "Usage: main [options] [command [args...]]\n"
+        "\n"
+        "Options:\n"
+        "  --db PATH            planner file (default ../data/planner.db)\n"
+        "  --format FORMAT      text, tsv or json (one object per line)\n"
+        "  --quiet              no confirmations from add/complete/update/import\n"
+        "  --in-memory          without a command: serve the listing from memory\n"
+        "  --stats              print operation counters and latencies to stderr\n"
+        "  --stats-file FILE    write them to FILE (JSON if it ends in .json,\n"
+        "                       Prometheus text otherwise)\n"
+        "\n"
+        "Commands:\n"
+        "  add TASK DUE_DATE [PRIORITY]      complete ID...\n"
+        "  update ID task|due_date|priority VALUE\n"
+        "                   PRIORITY is 0-255; higher goes first on the same due date\n"
+        "  next [N]         range FROM TO    list\n"
+        "  search QUERY [N] [FROM TO]\n"
+        "                   best matches first; words must all appear, pre* for a\n"
+        "                   prefix, \"two words\" for a phrase (default N: 20)\n"
+        "  import FILE|- [FORMAT]            export [FILE|-] [FORMAT]\n"
+        "                   FORMAT is tsv, csv or ndjson (default: from the\n"
+        "                   file extension, else tsv, or ndjson with --format json)\n"
+        "  recur TASK START daily|weekly|monthly [INTERVAL] [UNTIL]\n"
+        "                   repeating task; only its next occurrence is stored\n"
+        "  recurrences                       unrecur ID\n"
+        "  changes [SEQ]    IDs inserted, updated and completed since SEQ (by any\n"
+        "                   process), then the sequence to pass next time\n"
+        "  prune-changes SEQ   drop the change log up to SEQ\n"
+        "  batch [FILE|-]   one command per line, all in one transaction\n"
+        "  migrate [CHUNK_ROWS]   upgrade an older planner in chunked transactions\n"
+        "                         with progress (other commands refuse an older one)\n"
+        "  serve SOCKET [WORKERS]   keep the planner loaded and answer requests\n"
+        "                           on a Unix socket (see protocol.hpp)\n"
+        "  watch [LEAD_MINUTES...]  print an alert as tasks fall due, and that many\n"
+        "                           minutes before (default: 0, when due only)\n"
+        "\n"
+        "Without a command, lists the planner and shows the next task.\n";
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv) 
+{
+    std::ios::sync_with_stdio(false);
+
+    std::string filename{"../data/planner.db"};
+    OutputFormat format = OutputFormat::Text;
+    bool quiet = false;
+    bool in_memory = false;
+    bool stats = false;
+    std::string stats_file;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-' && argv[i][1] == '-'; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--db" && has_value)
+            filename = argv[++i];
+        else if (arg == "--format" && has_value) {
+            if (!parse_output_format(argv[++i], format)) {
+                std::cerr << "Unknown format " << argv[i] << std::endl;
+                return 2;
+            }
+        }
+        else if (arg == "--quiet")
+            quiet = true;
+        else if (arg == "--in-memory")
+            in_memory = true;
+        else if (arg == "--stats")
+            stats = true;
+        else if (arg == "--stats-file" && has_value)
+            stats_file = argv[++i];
+        else if (arg == "--help") {
+            print_usage();
+            return 0;
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            print_usage();
+            return 2;
+        }
+    }
+    std::vector<std::string> command(argv + i, argv + argc);
+
+    int result;
+    {
+        // Commands keep the DB's own confirmations off stdout so the
+        // output stays machine readable.
+        DBOptions options;
+        options.quiet = !command.empty() || quiet;
+        if (!command.empty() && command[0] == "serve") {
+            // Long-lived: WAL lets other processes read while it writes
+            options.wal = true;
+            options.synchronous = "NORMAL";
+            options.busy_timeout_ms = 5000;
+        }
+        else if (!command.empty() && (command[0] == "migrate" || command[0] == "watch")) {
+            // Waits out other writers (between chunks, or to read their changes)
+            options.busy_timeout_ms = 5000;
+        }
+        DB db(filename, options);
+        if (!db.db) {
+            return 1;
+        }
+
+        // Only migrate brings older planners up to the current schema
+        if (!command.empty() && command[0] == "migrate") {
+            result = run_migrate(db, command);
+        }
+        else if (open_planner(db) != SQLITE_OK) {
+            result = 1;
+        }
+        else if (command.empty()) {
+            result = in_memory ? run_in_memory(db) : run_planner(db);
+        }
+        else if (command[0] == "serve") {
+            result = run_server(db, command);
+        }
+        else if (command[0] == "watch") {
+            result = run_watch(db, command, format);
+        }
+        else if (command[0] == "batch") {
+            RowWriter out(std::cout, format, quiet);
+            if (command.size() > 2) {
+                result = 2;
+                print_usage();
+            }
+            else if (command.size() == 1 || command[1] == "-") {
+                result = run_batch(db, std::cin, out);
+            }
+            else {
+                std::ifstream file(command[1]);
+                if (!file) {
+                    std::cerr << "Error opening " << command[1] << std::endl;
+                    result = 1;
+                }
+                else {
+                    result = run_batch(db, file, out);
+                }
+            }
+        }
+        else {
+            RowWriter out(std::cout, format, quiet);
+            result = run_command(db, command, out);
+        }
+    }
+
+    if (stats) {
+        std::cerr << "Planner statistics:\n";
+        write_metrics_text(std::cerr);
+    }
+    if (!stats_file.empty() && !write_metrics_file(stats_file)) {
+        std::cerr << "Error writing statistics to " << stats_file << std::endl;
+        return 1;
+    }
+    return result;
 }
 // ================================================================================
 // ================================================================================
@@ -0,0 +1,252 @@
+// ================================================================================
+// ================================================================================
+// - File:    metrics.cpp
+// - Purpose: Storage and dump formats for the planner metrics.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+// ================================================================================
+// ================================================================================
+
+static constexpr size_t COUNTERS = static_cast<size_t>(MetricCounter::COUNT);
+static constexpr size_t TIMERS = static_cast<size_t>(MetricTimer::COUNT);
+
+// One cache line per slot so threads bumping different metrics don't
+// bounce the same line between cores.
+struct alignas(64) CounterSlot {
+    std::atomic<uint64_t> value{0};
+};
+
+struct alignas(64) TimerSlot {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> buckets[METRIC_BUCKETS] = {};
+};
+
+static CounterSlot counters[COUNTERS];
+static TimerSlot timers[TIMERS];
+
+static const char* const COUNTER_NAMES[COUNTERS] = {
+    "rows_scanned", "rows_written", "date_parses", "date_parse_errors",
+    "statement_cache_hits", "statement_cache_misses", "db_errors"
+};
+
+static const char* const TIMER_NAMES[TIMERS] = {
+    "prepare", "step", "finalize", "exec", "db_to_vector", "next_task",
+    "heap_load", "heap_push", "heap_pop", "heap_update"
+};
+
+// Plain copy of a timer slot, so a dump works from one consistent-enough read.
+struct TimerView {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[METRIC_BUCKETS];
+};
+
+static TimerView read_timer(size_t i)
+{
+    TimerView view;
+    view.count = timers[i].count.load(std::memory_order_relaxed);
+    view.total_ns = timers[i].total_ns.load(std::memory_order_relaxed);
+    view.max_ns = timers[i].max_ns.load(std::memory_order_relaxed);
+    for (int b = 0; b < METRIC_BUCKETS; b++) {
+        view.buckets[b] = timers[i].buckets[b].load(std::memory_order_relaxed);
+    }
+    return view;
+}
+// --------------------------------------------------------------------------------
+
+// Upper edge of bucket b, in nanoseconds.
+static double bucket_bound_ns(int b)
+{
+    return static_cast<double>(uint64_t{2} << b);
+}
+// --------------------------------------------------------------------------------
+
+// Upper bound of the bucket holding the p-th sample; capped at the true max.
+static double percentile_ns(const TimerView& view, double p)
+{
+    if (view.count == 0)
+        return 0.0;
+    uint64_t rank = static_cast<uint64_t>(p * (view.count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < METRIC_BUCKETS; b++) {
+        seen += view.buckets[b];
+        if (seen >= rank)
+            return std::min(bucket_bound_ns(b), static_cast<double>(view.max_ns));
+    }
+    return static_cast<double>(view.max_ns);
+}
+// ================================================================================
+// ================================================================================
+
+const char* metric_name(MetricCounter counter)
+{
+    return COUNTER_NAMES[static_cast<size_t>(counter)];
+}
+// --------------------------------------------------------------------------------
+
+const char* metric_name(MetricTimer timer)
+{
+    return TIMER_NAMES[static_cast<size_t>(timer)];
+}
+// --------------------------------------------------------------------------------
+
+void metrics_count(MetricCounter counter, uint64_t n)
+{
+    counters[static_cast<size_t>(counter)].value.fetch_add(n, std::memory_order_relaxed);
+}
+// --------------------------------------------------------------------------------
+
+void metrics_record(MetricTimer timer, uint64_t nanoseconds)
+{
+    TimerSlot& slot = timers[static_cast<size_t>(timer)];
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+    slot.total_ns.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    int bucket = nanoseconds == 0 ? 0 : 63 - __builtin_clzll(nanoseconds);
+    if (bucket >= METRIC_BUCKETS)
+        bucket = METRIC_BUCKETS - 1;
+    slot.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = slot.max_ns.load(std::memory_order_relaxed);
+    while (nanoseconds > max &&
+           !slot.max_ns.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+// --------------------------------------------------------------------------------
+
+void metrics_reset()
+{
+    for (CounterSlot& slot : counters) {
+        slot.value.store(0, std::memory_order_relaxed);
+    }
+    for (TimerSlot& slot : timers) {
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.total_ns.store(0, std::memory_order_relaxed);
+        slot.max_ns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : slot.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void write_metrics_text(std::ostream& out)
+{
+    if (!PLANNER_METRICS) {
+        out << "Metrics are disabled in this build (PLANNER_METRICS=0).\n";
+        return;
+    }
+
+    out << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < COUNTERS; i++) {
+        out << std::left << std::setw(24) << COUNTER_NAMES[i] << std::right
+            << std::setw(14) << counters[i].value.load(std::memory_order_relaxed) << '\n';
+    }
+    out << '\n' << std::left << std::setw(24) << "operation" << std::right << std::setw(14) << "count"
+        << std::setw(12) << "mean us" << std::setw(12) << "p50 us" << std::setw(12) << "p99 us"
+        << std::setw(12) << "max us" << '\n';
+    for (size_t i = 0; i < TIMERS; i++) {
+        TimerView view = read_timer(i);
+        if (view.count == 0)
+            continue;
+        out << std::left << std::setw(24) << TIMER_NAMES[i] << std::right << std::setw(14) << view.count
+            << std::setw(12) << view.total_ns / 1e3 / view.count
+            << std::setw(12) << percentile_ns(view, 0.50) / 1e3
+            << std::setw(12) << percentile_ns(view, 0.99) / 1e3
+            << std::setw(12) << view.max_ns / 1e3 << '\n';
+    }
+}
+// --------------------------------------------------------------------------------
+
+void write_metrics_json(std::ostream& out)
+{
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"enabled\": " << (PLANNER_METRICS ? "true" : "false") << ",\n  \"counters\": {";
+    for (size_t i = 0; i < COUNTERS; i++) {
+        out << (i ? ", " : "") << '"' << COUNTER_NAMES[i] << "\": "
+            << counters[i].value.load(std::memory_order_relaxed);
+    }
+    out << "},\n  \"timers\": {\n";
+    for (size_t i = 0; i < TIMERS; i++) {
+        TimerView view = read_timer(i);
+        out << "    \"" << TIMER_NAMES[i] << "\": {\"count\": " << view.count
+            << ", \"total_us\": " << view.total_ns / 1e3
+            << ", \"p50_us\": " << percentile_ns(view, 0.50) / 1e3
+            << ", \"p90_us\": " << percentile_ns(view, 0.90) / 1e3
+            << ", \"p99_us\": " << percentile_ns(view, 0.99) / 1e3
+            << ", \"max_us\": " << view.max_ns / 1e3 << ", \"buckets\": [";
+        int last = METRIC_BUCKETS - 1;
+        while (last > 0 && view.buckets[last] == 0) {
+            last--;
+        }
+        for (int b = 0; b <= last; b++) {
+            out << (b ? ", " : "") << view.buckets[b];
+        }
+        out << "]}" << (i + 1 < TIMERS ? ",\n" : "\n");
+    }
+    out << "  }\n}\n";
+}
+// --------------------------------------------------------------------------------
+
+void write_metrics_prometheus(std::ostream& out)
+{
+    out << std::setprecision(9);
+    for (size_t i = 0; i < COUNTERS; i++) {
+        out << "# TYPE planner_" << COUNTER_NAMES[i] << "_total counter\n"
+            << "planner_" << COUNTER_NAMES[i] << "_total "
+            << counters[i].value.load(std::memory_order_relaxed) << '\n';
+    }
+
+    out << "# HELP planner_operation_duration_seconds Latency of planner hot-path operations.\n"
+        << "# TYPE planner_operation_duration_seconds histogram\n";
+    for (size_t i = 0; i < TIMERS; i++) {
+        TimerView view = read_timer(i);
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRIC_BUCKETS - 1; b++) {
+            cumulative += view.buckets[b];
+            out << "planner_operation_duration_seconds_bucket{op=\"" << TIMER_NAMES[i]
+                << "\",le=\"" << bucket_bound_ns(b) / 1e9 << "\"} " << cumulative << '\n';
+        }
+        out << "planner_operation_duration_seconds_bucket{op=\"" << TIMER_NAMES[i]
+            << "\",le=\"+Inf\"} " << view.count << '\n'
+            << "planner_operation_duration_seconds_sum{op=\"" << TIMER_NAMES[i] << "\"} "
+            << view.total_ns / 1e9 << '\n'
+            << "planner_operation_duration_seconds_count{op=\"" << TIMER_NAMES[i] << "\"} "
+            << view.count << '\n';
+    }
+}
+// --------------------------------------------------------------------------------
+
+bool write_metrics_file(const std::string& path)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json)
+        write_metrics_json(out);
+    else
+        write_metrics_prometheus(out);
+    return static_cast<bool>(out);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -14,134 +14,128 @@
 
 #include "include/min_heap.hpp"
 #include <iostream>
-#include <sstream>
-#include <iomanip>
-#include <ctime>
 #include <string>
-#include "/usr/include/sqlite3.h"
 #include "include/db.hpp"
+#include "include/metrics.hpp"
 #include <vector>
-#include <queue>
+#include <algorithm>
 
 // ================================================================================
 // ================================================================================
 
 
-void PriorityQueue::parseDateString()
+void PriorityQueue::parseDateString(const std::string& due_date_string, int priority)
 {
-    std::stringstream ss(due_date_string);
-    ss >> std::get_time(&datetime, "%Y-%m-%d");
-    if (ss.fail()) {
-        std::cerr << "Error parsing date string: " << due_date_string << std::endl;
-        }
+    due_key = parse_due_key(due_date_string);
+    priority_level = priority;
+    order_key = make_order_key(due_key, priority);
+    if (due_key == INVALID_DUE_KEY)
+        due_date = due_date_string;
+    else
+        due_date.clear();
 }
 // --------------------------------------------------------------------------------
 
 
-std::vector<PriorityQueue> db_to_vector(DB& db)
+std::vector<PriorityQueue> db_to_vector(DB& db, InvalidDates policy, std::vector<InvalidTask>* invalid)
 {
+    PLANNER_TIMED(DbToVector);
     std::vector<PriorityQueue> rows;
 
-    std::string sql = "SELECT ID, TASK, DUE_DATE FROM PLANNER;";
-
-    sqlite3_stmt* stmt;
-
-    int rc = sqlite3_prepare_v2(db.db, sql.c_str(), -1, &stmt, NULL);
-
-    if(rc != SQLITE_OK){
-        std::cerr << "Failed to prepare SQL statement << sqlite3_errmsg(db.db)" << std::endl;
-        return rows;
+    long long count = db.countTasks();
+    if (count > 0) {
+        rows.reserve(static_cast<size_t>(count));
     }
 
-    // Fetch rows one by one
-    while (sqlite3_step(stmt) == SQLITE_ROW){
-        int id = sqlite3_column_int(stmt, 0);
-        const unsigned char* task = sqlite3_column_text(stmt, 1);
-        const unsigned char* due_date = sqlite3_column_text(stmt, 2);
-
-        // Convert data to Priority Queue strut data types
-        std::string task_str(reinterpret_cast<const char*>(task));
-        std::string due_date_str(reinterpret_cast<const char*>(due_date));
-        PriorityQueue row(id, task_str, due_date_str);
-
-        rows.push_back(row);
+    // Each task string is copied exactly once, straight out of SQLite's buffer.
+    // Rows without a stored key are set aside and parsed in one batch below.
+    std::vector<size_t> unparsed;
+    std::vector<std::string> due_dates;
+    TaskCursor cursor = db.scanTasks();
+    cursor.setParseDates(false);
+    for (const RowView& row : cursor) {
+        if (row.due_key == INVALID_DUE_KEY) {
+            unparsed.push_back(rows.size());
+            due_dates.emplace_back(row.due_date);
+        }
+        rows.emplace_back(row.id, std::string(row.task), row.due_key, row.priority);
     }
+    if (unparsed.empty())
+        return rows;
 
-    sqlite3_finalize(stmt);
+    std::vector<std::string_view> texts(due_dates.begin(), due_dates.end());
+    std::vector<DueKey> keys(texts.size());
+    std::vector<DateError> errors;
+    parse_due_keys(texts.data(), texts.size(), keys.data(), errors);
+    for (size_t i = 0; i < unparsed.size(); i++) {
+        PriorityQueue& row = rows[unparsed[i]];
+        row.due_key = keys[i];
+        row.setPriority(row.priority());
+    }
 
+    for (DateError& error : errors) {
+        PriorityQueue& row = rows[unparsed[error.index]];
+        if (invalid)
+            invalid->push_back(InvalidTask{row.id, row.task, error.text, row.priority()});
+        row.due_date = std::move(error.text);
+    }
+    if (policy == InvalidDates::Exclude && !errors.empty()) {
+        rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                  [](const PriorityQueue& row) { return !row.valid(); }),
+                   rows.end());
+    }
     return rows;
 }
 // --------------------------------------------------------------------------------
 
 std::ostream& operator<<(std::ostream& os, const PriorityQueue& pq) {
     os << "ID: " << pq.id << ", Task: " << pq.task << ", Due Date: "
-       << std::put_time(&pq.datetime, "%c");
+       << format_due_key(pq.due_key);
     return os;
 }
 // --------------------------------------------------------------------------------
 
 bool operator<(const PriorityQueue& pq1, const PriorityQueue& pq2)
 {
-    // Compare the year first
-    if (pq1.datetime.tm_year < pq2.datetime.tm_year)
-        return true;
-    else if (pq1.datetime.tm_year > pq2.datetime.tm_year)
-        return false;
-
-    // If years are equal, compare the month
-    if (pq1.datetime.tm_mon < pq2.datetime.tm_mon)
-        return true;
-    else if (pq1.datetime.tm_mon > pq2.datetime.tm_mon)
-        return false;
-
-    // If months are equal, compare the day
-    if (pq1.datetime.tm_mday < pq2.datetime.tm_mday)
-        return true;
-    else if (pq1.datetime.tm_mday > pq2.datetime.tm_mday)
-        return false;
-
-    // If day is also equal, return false (pq1 is not less than pq2)
-    return false;
+    // Due date and priority are one packed compare; the ID only breaks ties
+    if (pq1.order_key != pq2.order_key)
+        return pq1.order_key < pq2.order_key;
+    return pq1.id < pq2.id;
 }
 // --------------------------------------------------------------------------------
 
 bool operator>(const PriorityQueue& pq1, const PriorityQueue& pq2)
 {
-    // Compare the year first
-    if (pq1.datetime.tm_year > pq2.datetime.tm_year)
-        return true;
-    else if (pq1.datetime.tm_year < pq2.datetime.tm_year)
-        return false;
-
-    // If years are equal, compare the month
-    if (pq1.datetime.tm_mon > pq2.datetime.tm_mon)
-        return true;
-    else if (pq1.datetime.tm_mon < pq2.datetime.tm_mon)
-        return false;
-
-    // If months are equal, compare the day
-    if (pq1.datetime.tm_mday > pq2.datetime.tm_mday)
-        return true;
-    else if (pq1.datetime.tm_mday < pq2.datetime.tm_mday)
-        return false;
-
-    // If day is also equal, return false (pq1 is not less than pq2)
-    return false;
+    return pq2 < pq1;
 }
 // --------------------------------------------------------------------------------
 
 
-PriorityQueue next_task(std::vector<PriorityQueue> vec)
+PriorityQueue next_task(const std::vector<PriorityQueue>& vec)
 {
-    // Define priority queue
-    std::priority_queue<PriorityQueue, std::vector<PriorityQueue>, std::greater<PriorityQueue>> pq;
+    PLANNER_TIMED(NextTask);
+    // A single pass finds the minimum without copying the rows into a heap
+    return *std::min_element(vec.begin(), vec.end());
+}
+// --------------------------------------------------------------------------------
 
-    // Push vector on priority queue
-    for (PriorityQueue item : vec){
-        pq.push(item);
+bool next_task(DB& db, TaskRow& next)
+{
+    PLANNER_TIMED(NextTask);
+    bool found = false;
+    for (const RowView& row : db.scanTasks()) {
+        // Rows arrive in ID order, so a strict compare keeps the lowest ID on ties
+        OrderKey key = make_order_key(row.due_key, row.priority);
+        if (!found || key < make_order_key(next.due_key, next.priority)) {
+            // Only a new minimum is copied; assign reuses the string's buffer
+            next.id = row.id;
+            next.task.assign(row.task);
+            next.due_key = row.due_key;
+            next.priority = row.priority;
+            found = true;
+        }
     }
-
-    return pq.top();
+    return found;
 }
 // ================================================================================
 // ================================================================================
@@ -0,0 +1,468 @@
+// ================================================================================
+// ================================================================================
+// - File:    planner_snapshot.cpp
+// - Purpose: Resident structure-of-arrays planner snapshot with write-through.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/planner_snapshot.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <exception>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+size_t PlannerSnapshot::slotOf(int id) const
+{
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id)
+        return NO_SLOT;
+
+    size_t slot = static_cast<size_t>(it - ids.begin());
+    return text_lengths[slot] == DEAD ? NO_SLOT : slot;
+}
+// --------------------------------------------------------------------------------
+
+SnapshotRow PlannerSnapshot::rowAt(size_t slot) const
+{
+    return SnapshotRow{ids[slot],
+                       std::string_view(arena.data() + text_offsets[slot], text_lengths[slot]),
+                       order_key_due(order_keys[slot]),
+                       priorities[slot]};
+}
+// --------------------------------------------------------------------------------
+
+size_t PlannerSnapshot::appendText(std::string_view task)
+{
+    size_t offset = arena.size();
+    arena.append(task);
+    return offset;
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::addRow(int id, std::string_view task, DueKey due_key, int priority)
+{
+    OrderKey order_key = make_order_key(due_key, priority);
+    // SQLite caps a TEXT value well below DEAD, so a length always fits
+    size_t offset = appendText(task);
+    uint32_t length = static_cast<uint32_t>(task.size());
+
+    // New rows almost always carry the highest ID, which keeps this an append
+    size_t slot = ids.size();
+    if (!ids.empty() && id <= ids.back()) {
+        slot = static_cast<size_t>(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+    }
+
+    if (slot < ids.size() && ids[slot] == id) {
+        if (text_lengths[slot] != DEAD) {
+            dead_arena_bytes += text_lengths[slot];
+            due_order.erase({order_keys[slot], id});
+            live_count--;
+        }
+        order_keys[slot] = order_key;
+        priorities[slot] = static_cast<uint8_t>(priority);
+        text_offsets[slot] = offset;
+        text_lengths[slot] = length;
+    }
+    else {
+        ids.insert(ids.begin() + slot, id);
+        order_keys.insert(order_keys.begin() + slot, order_key);
+        priorities.insert(priorities.begin() + slot, static_cast<uint8_t>(priority));
+        text_offsets.insert(text_offsets.begin() + slot, offset);
+        text_lengths.insert(text_lengths.begin() + slot, length);
+    }
+    live_count++;
+    if (order_key != INVALID_ORDER_KEY) {
+        due_order.emplace(order_key, id);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::setOrderKey(size_t slot, DueKey due_key, int priority)
+{
+    OrderKey order_key = make_order_key(due_key, priority);
+    due_order.erase({order_keys[slot], ids[slot]});
+    order_keys[slot] = order_key;
+    priorities[slot] = static_cast<uint8_t>(priority);
+    if (order_key != INVALID_ORDER_KEY) {
+        due_order.emplace(order_key, ids[slot]);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::compactIfNeeded()
+{
+    size_t dead_slots = ids.size() - live_count;
+    bool slots_wasted = dead_slots > 1024 && dead_slots > live_count;
+    bool arena_wasted = dead_arena_bytes > (1u << 20) && dead_arena_bytes > arena.size() / 2;
+    if (!slots_wasted && !arena_wasted)
+        return;
+
+    std::vector<int> new_ids;
+    std::vector<OrderKey> new_keys;
+    std::vector<uint8_t> new_priorities;
+    std::vector<size_t> new_offsets;
+    std::vector<uint32_t> new_lengths;
+    std::string new_arena;
+    new_ids.reserve(live_count);
+    new_keys.reserve(live_count);
+    new_priorities.reserve(live_count);
+    new_offsets.reserve(live_count);
+    new_lengths.reserve(live_count);
+    new_arena.reserve(arena.size() - dead_arena_bytes);
+
+    for (size_t slot = 0; slot < ids.size(); slot++) {
+        if (text_lengths[slot] == DEAD)
+            continue;
+        new_ids.push_back(ids[slot]);
+        new_keys.push_back(order_keys[slot]);
+        new_priorities.push_back(priorities[slot]);
+        new_offsets.push_back(new_arena.size());
+        new_lengths.push_back(text_lengths[slot]);
+        new_arena.append(arena, text_offsets[slot], text_lengths[slot]);
+    }
+
+    ids.swap(new_ids);
+    order_keys.swap(new_keys);
+    priorities.swap(new_priorities);
+    text_offsets.swap(new_offsets);
+    text_lengths.swap(new_lengths);
+    arena.swap(new_arena);
+    dead_arena_bytes = 0;
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::refreshRow(int id)
+{
+    std::vector<TaskRow> rows;
+    if (db->tasksById({id}, rows) != SQLITE_OK) {
+        reload();
+        return;
+    }
+
+    // addRow replaces a live slot in place
+    if (rows.empty()) {
+        taskCompleted(id);
+    }
+    else {
+        addRow(rows[0].id, rows[0].task, rows[0].due_key, rows[0].priority);
+    }
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+PlannerSnapshot::PlannerSnapshot(DB& db) : db(&db), catch_up_failed(false)
+{
+    reload();
+    db.addObserver(this);
+}
+// --------------------------------------------------------------------------------
+
+PlannerSnapshot::~PlannerSnapshot()
+{
+    db->removeObserver(this);
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::reload()
+{
+    ids.clear();
+    order_keys.clear();
+    priorities.clear();
+    text_offsets.clear();
+    text_lengths.clear();
+    arena.clear();
+    due_order.clear();
+    live_count = 0;
+    dead_arena_bytes = 0;
+
+    // The rows and the sequence they are current to come from one read
+    // transaction; anything committed elsewhere after the data_version
+    // check is picked up by the next catchUp
+    db->changedElsewhere();
+    db->beginTransaction();
+    change_sequence = db->changeSequence();
+    long long count = db->countTasks();
+    if (count > 0) {
+        ids.reserve(static_cast<size_t>(count));
+        order_keys.reserve(static_cast<size_t>(count));
+        priorities.reserve(static_cast<size_t>(count));
+        text_offsets.reserve(static_cast<size_t>(count));
+        text_lengths.reserve(static_cast<size_t>(count));
+    }
+
+    // scanTasks is in ID order, so every row is an append
+    for (const RowView& row : db->scanTasks()) {
+        addRow(row.id, row.task, row.due_key, row.priority);
+    }
+    db->commitTransaction();
+    arena.shrink_to_fit();
+}
+// --------------------------------------------------------------------------------
+
+int PlannerSnapshot::catchUp()
+{
+    // A failed catch-up has already consumed the data_version change
+    if (!db->changedElsewhere() && !catch_up_failed) {
+        return SQLITE_OK;
+    }
+    catch_up_failed = true;
+
+    // The log also holds the changes made through db, which the observer
+    // hooks have applied already; applying them again is harmless
+    int rc = db->beginTransaction();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    ChangeSet changes;
+    std::vector<TaskRow> rows;
+    rc = db->changesSince(change_sequence, changes);
+    if (rc == SQLITE_OK && changes.complete) {
+        rc = db->tasksById(changes.inserted, rows);
+    }
+    if (rc == SQLITE_OK && changes.complete) {
+        rc = db->tasksById(changes.updated, rows);
+    }
+    if (rc != SQLITE_OK) {
+        db->rollbackTransaction();
+        return rc;
+    }
+    if (!changes.complete) {
+        db->commitTransaction();
+        reload();
+        catch_up_failed = false;
+        return SQLITE_OK;
+    }
+    rc = db->commitTransaction();
+    catch_up_failed = false;
+
+    for (int id : changes.completed) {
+        taskCompleted(id);
+    }
+    for (const TaskRow& row : rows) {
+        addRow(row.id, row.task, row.due_key, row.priority);
+    }
+    change_sequence = changes.sequence;
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+size_t PlannerSnapshot::size() const
+{
+    return live_count;
+}
+// --------------------------------------------------------------------------------
+
+bool PlannerSnapshot::find(int id, SnapshotRow& row) const
+{
+    size_t slot = slotOf(id);
+    if (slot == NO_SLOT)
+        return false;
+    row = rowAt(slot);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool PlannerSnapshot::next(SnapshotRow& row) const
+{
+    if (due_order.empty())
+        return false;
+    row = rowAt(slotOf(due_order.begin()->second));
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::nextTasks(size_t count, std::vector<SnapshotRow>& rows) const
+{
+    for (auto it = due_order.begin(); it != due_order.end() && count > 0; ++it, count--) {
+        rows.push_back(rowAt(slotOf(it->second)));
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::tasksDueBetween(DueKey from, DueKey to, std::vector<SnapshotRow>& rows) const
+{
+    OrderKey high = make_order_key(to, MAX_PRIORITY);
+    auto it = due_order.lower_bound({make_order_key(from, MAX_PRIORITY), INT_MIN});
+    for (; it != due_order.end() && it->first < high; ++it) {
+        rows.push_back(rowAt(slotOf(it->second)));
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::forEach(const std::function<void(const SnapshotRow&)>& visit) const
+{
+    for (size_t slot = 0; slot < ids.size(); slot++) {
+        if (text_lengths[slot] != DEAD)
+            visit(rowAt(slot));
+    }
+}
+// --------------------------------------------------------------------------------
+
+int PlannerSnapshot::insertTask(std::string& task, std::string& due_date)
+{
+    // The DB notifies this snapshot once the row is stored
+    return db->insertTask(task, due_date);
+}
+// --------------------------------------------------------------------------------
+
+int PlannerSnapshot::completeTask(int id)
+{
+    return db->completeTask(id);
+}
+// --------------------------------------------------------------------------------
+
+int PlannerSnapshot::updatePlanner(UpdateRow& updated_row)
+{
+    return db->updatePlanner(updated_row);
+}
+// --------------------------------------------------------------------------------
+
+size_t PlannerSnapshot::verify(DB& db, std::ostream* report) const
+{
+    size_t differences = 0;
+    size_t slot = 0;
+    auto next_live = [this](size_t from) {
+        while (from < ids.size() && text_lengths[from] == DEAD)
+            from++;
+        return from;
+    };
+
+    // Both sides are in ID order, so one merge pass lines them up
+    slot = next_live(slot);
+    TaskCursor cursor = db.scanTasks();
+    for (const RowView& disk : cursor) {
+        while (slot < ids.size() && ids[slot] < disk.id) {
+            differences++;
+            if (report)
+                *report << "ID " << ids[slot] << ": in memory but not on disk\n";
+            slot = next_live(slot + 1);
+        }
+
+        if (slot >= ids.size() || ids[slot] != disk.id) {
+            differences++;
+            if (report)
+                *report << "ID " << disk.id << ": on disk but not in memory\n";
+            continue;
+        }
+
+        SnapshotRow memory = rowAt(slot);
+        if (memory.task != disk.task || memory.due_key != disk.due_key || memory.priority != disk.priority) {
+            differences++;
+            if (report)
+                *report << "ID " << disk.id << ": differs (memory \"" << memory.task << "\" "
+                        << format_due_key(memory.due_key) << ", disk \"" << disk.task << "\" "
+                        << format_due_key(disk.due_key) << ")\n";
+        }
+        slot = next_live(slot + 1);
+    }
+    for (; slot < ids.size(); slot = next_live(slot + 1)) {
+        differences++;
+        if (report)
+            *report << "ID " << ids[slot] << ": in memory but not on disk\n";
+    }
+
+    if (cursor.status() != SQLITE_OK)
+        differences++;
+    return differences;
+}
+// --------------------------------------------------------------------------------
+
+size_t PlannerSnapshot::memoryUsage() const
+{
+    return sizeof(*this)
+         + ids.capacity() * sizeof(int)
+         + order_keys.capacity() * sizeof(OrderKey)
+         + priorities.capacity() * sizeof(uint8_t)
+         + text_offsets.capacity() * sizeof(size_t)
+         + text_lengths.capacity() * sizeof(uint32_t)
+         + arena.capacity()
+         + due_order.size() * (sizeof(std::pair<OrderKey, int>) + 4 * sizeof(void*));
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::taskInserted(int id, const std::string& task, const std::string& due_date, int priority)
+{
+    addRow(id, task, parse_due_key(due_date), priority);
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::taskCompleted(int id)
+{
+    size_t slot = slotOf(id);
+    if (slot == NO_SLOT)
+        return;
+
+    // Tombstone the slot; compaction reclaims slots and text in bulk
+    dead_arena_bytes += text_lengths[slot];
+    text_lengths[slot] = DEAD;
+    due_order.erase({order_keys[slot], id});
+    live_count--;
+    compactIfNeeded();
+}
+// --------------------------------------------------------------------------------
+
+void PlannerSnapshot::plannerUpdated(const UpdateRow& updated_row)
+{
+    int id = 0;
+    bool by_id = sqlite3_stricmp(updated_row.id_column_name.c_str(), "ID") == 0;
+    if (by_id) {
+        try {
+            id = std::stoi(updated_row.id_column_value);
+        } catch (const std::exception&) {
+            by_id = false;
+        }
+    }
+    if (!by_id) {
+        // Any number of rows may have changed
+        reload();
+        return;
+    }
+
+    // An ID the snapshot does not hold (inserted elsewhere and not caught
+    // up yet, or not there at all) or a column it cannot patch costs one
+    // row's read, not a reload
+    size_t slot = slotOf(id);
+    bool sets_due_date = sqlite3_stricmp(updated_row.set_column_name.c_str(), "DUE_DATE") == 0;
+    bool sets_task = sqlite3_stricmp(updated_row.set_column_name.c_str(), "TASK") == 0;
+    bool sets_priority = sqlite3_stricmp(updated_row.set_column_name.c_str(), "PRIORITY") == 0;
+    if (slot == NO_SLOT || (!sets_due_date && !sets_task && !sets_priority)) {
+        refreshRow(id);
+        return;
+    }
+
+    if (sets_task) {
+        dead_arena_bytes += text_lengths[slot];
+        text_offsets[slot] = appendText(updated_row.set_new_value);
+        text_lengths[slot] = static_cast<uint32_t>(updated_row.set_new_value.size());
+        compactIfNeeded();
+        return;
+    }
+
+    if (sets_priority) {
+        int priority = std::atoi(updated_row.set_new_value.c_str());
+        setOrderKey(slot, order_key_due(order_keys[slot]), priority);
+    }
+    else {
+        setOrderKey(slot, parse_due_key(updated_row.set_new_value), priorities[slot]);
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
@@ -0,0 +1,159 @@
+// ================================================================================
+// ================================================================================
+// - File:    planner_store.cpp
+// - Purpose: WAL-mode planner store with a read connection pool and a single
+//            queued writer.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/planner_store.hpp"
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// ================================================================================
+// ================================================================================
+
+PlannerStore::ReadLease::ReadLease(PlannerStore* store, DB* connection) :
+    store(store),
+    connection(connection)
+{
+}
+// --------------------------------------------------------------------------------
+
+PlannerStore::ReadLease::ReadLease(ReadLease&& other) noexcept :
+    store(other.store),
+    connection(other.connection)
+{
+    other.connection = nullptr;
+}
+// --------------------------------------------------------------------------------
+
+PlannerStore::ReadLease::~ReadLease()
+{
+    if (connection) {
+        store->returnReader(connection);
+    }
+}
+// ================================================================================
+// ================================================================================
+
+void PlannerStore::returnReader(DB* db)
+{
+    {
+        std::lock_guard<std::mutex> lock(reader_mutex);
+        idle_readers.push_back(db);
+    }
+    reader_available.notify_one();
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+PlannerStore::PlannerStore(const std::string& filename, const PlannerStoreOptions& options) :
+    filename(filename),
+    open_rc(SQLITE_OK)
+{
+    DBOptions writer_options;
+    writer_options.wal = true;
+    writer_options.mmap_size = options.mmap_size;
+    writer_options.cache_size = options.cache_size;
+    writer_options.busy_timeout_ms = options.busy_timeout_ms;
+    writer_options.quiet = true;
+
+    // The writer goes first so the file, schema and WAL mode exist before
+    // any read-only connection opens it.
+    writer_db = std::make_unique<DB>(filename, writer_options);
+    if (options.readers == 0) {
+        // reader() would wait forever for a connection that never comes
+        std::cerr << "Error: a planner store needs at least one reader" << std::endl;
+        open_rc = SQLITE_MISUSE;
+    }
+    else if (writer_db->db) {
+        open_rc = writer_db->createPlanner();
+    }
+    else {
+        open_rc = SQLITE_CANTOPEN;
+    }
+
+    DBOptions reader_options = writer_options;
+    reader_options.read_only = true;
+    reader_options.wal = false;
+    for (size_t i = 0; i < options.readers; i++) {
+        readers.push_back(std::make_unique<DB>(filename, reader_options));
+        idle_readers.push_back(readers.back().get());
+        if (open_rc == SQLITE_OK && !readers.back()->db) {
+            open_rc = SQLITE_CANTOPEN;
+        }
+    }
+
+    pipeline = std::make_unique<WritePipeline>(*writer_db, options.writes);
+}
+// --------------------------------------------------------------------------------
+
+PlannerStore::~PlannerStore()
+{
+    // Commit whatever is still queued before the connections go away
+    pipeline.reset();
+    readers.clear();
+    writer_db.reset();
+}
+// --------------------------------------------------------------------------------
+
+PlannerStore::ReadLease PlannerStore::reader()
+{
+    std::unique_lock<std::mutex> lock(reader_mutex);
+    reader_available.wait(lock, [this] { return !idle_readers.empty(); });
+    DB* db = idle_readers.back();
+    idle_readers.pop_back();
+    return ReadLease(this, db);
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> PlannerStore::write(std::function<int(DB&)> job)
+{
+    return pipeline->submit(std::move(job));
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> PlannerStore::insertTask(std::string task, std::string due_date)
+{
+    return pipeline->insertTask(std::move(task), std::move(due_date));
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> PlannerStore::completeTask(int id)
+{
+    return pipeline->completeTask(id);
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> PlannerStore::updatePlanner(UpdateRow updated_row)
+{
+    return pipeline->updatePlanner(std::move(updated_row));
+}
+// --------------------------------------------------------------------------------
+
+WritePipelineMetrics PlannerStore::writeMetrics() const
+{
+    return pipeline->metrics();
+}
+// --------------------------------------------------------------------------------
+
+int PlannerStore::status() const
+{
+    return open_rc;
+}
+// ================================================================================
+// ================================================================================
+//eof
@@ -0,0 +1,70 @@
+// ================================================================================
+// ================================================================================
+// - File:    protocol.cpp
+// - Purpose: Escaping and line splitting for the planner wire format.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/protocol.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+void append_escaped_field(std::string& out, std::string_view field)
+{
+    for (char c : field) {
+        switch (c) {
+            case '\\': out.append("\\\\"); break;
+            case '\t': out.append("\\t"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            default:   out.push_back(c);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void append_line(std::string& out, const std::vector<std::string>& fields)
+{
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (i)
+            out.push_back('\t');
+        append_escaped_field(out, fields[i]);
+    }
+    out.push_back('\n');
+}
+// --------------------------------------------------------------------------------
+
+void split_line(std::string_view line, std::vector<std::string>& fields)
+{
+    fields.clear();
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    fields.emplace_back();
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (c == '\t') {
+            fields.emplace_back();
+        }
+        else if (c == '\\' && i + 1 < line.size()) {
+            char e = line[++i];
+            fields.back().push_back(e == 't' ? '\t' : e == 'n' ? '\n' : e == 'r' ? '\r' : e);
+        }
+        else {
+            fields.back().push_back(c);
+        }
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,127 @@
+// ================================================================================
+// ================================================================================
+// - File:    recurrence.cpp
+// - Purpose: Occurrence arithmetic for recurring tasks.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/recurrence.hpp"
+#include <algorithm>
+#include <string>
+
+// ================================================================================
+// ================================================================================
+
+static int key_year(DueKey key) { return static_cast<int>(key / 100000000); }
+static int key_month(DueKey key) { return static_cast<int>(key / 1000000 % 100); }
+static int key_day(DueKey key) { return static_cast<int>(key / 10000 % 100); }
+// --------------------------------------------------------------------------------
+
+static int month_length(int year, int month)
+{
+    int next_year = month == 12 ? year + 1 : year;
+    int next_month = month == 12 ? 1 : month + 1;
+    return static_cast<int>(days_from_civil(next_year, next_month, 1) - days_from_civil(year, month, 1));
+}
+// --------------------------------------------------------------------------------
+
+// start moved on by months, keeping its day of month where the month allows.
+static DueKey add_months(DueKey start, int64_t months)
+{
+    int64_t index = static_cast<int64_t>(key_year(start)) * 12 + (key_month(start) - 1) + months;
+    int year = static_cast<int>(index / 12);
+    int month = static_cast<int>(index % 12) + 1;
+    int day = std::min(key_day(start), month_length(year, month));
+    return ((static_cast<DueKey>(year) * 100 + month) * 100 + day) * 10000 + start % 10000;
+}
+// --------------------------------------------------------------------------------
+
+bool parse_frequency(const std::string& name, Frequency& frequency)
+{
+    if (name == "daily")
+        frequency = Frequency::Daily;
+    else if (name == "weekly")
+        frequency = Frequency::Weekly;
+    else if (name == "monthly")
+        frequency = Frequency::Monthly;
+    else
+        return false;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+const char* frequency_name(Frequency frequency)
+{
+    switch (frequency) {
+        case Frequency::Daily:   return "daily";
+        case Frequency::Weekly:  return "weekly";
+        case Frequency::Monthly: return "monthly";
+    }
+    return "daily";
+}
+// --------------------------------------------------------------------------------
+
+DueKey next_occurrence(const RecurrenceRule& rule, DueKey after)
+{
+    if (rule.start == INVALID_DUE_KEY || rule.interval < 1)
+        return INVALID_DUE_KEY;
+
+    DueKey next = rule.start;
+    if (after >= rule.start) {
+        if (rule.frequency == Frequency::Monthly) {
+            // Jump close to after, then step; clamping means at most two steps
+            int64_t elapsed = (static_cast<int64_t>(key_year(after)) * 12 + key_month(after)) -
+                              (static_cast<int64_t>(key_year(rule.start)) * 12 + key_month(rule.start));
+            int64_t k = elapsed / rule.interval;
+            do {
+                next = add_months(rule.start, k * rule.interval);
+                k++;
+            } while (next <= after);
+        }
+        else {
+            int64_t step = static_cast<int64_t>(rule.interval) * (rule.frequency == Frequency::Weekly ? 7 : 1) * 1440;
+            int64_t start_minutes = due_key_to_minutes(rule.start);
+            int64_t steps = (due_key_to_minutes(after) - start_minutes) / step + 1;
+            next = due_key_from_minutes(start_minutes + steps * step);
+        }
+    }
+
+    if (rule.until != INVALID_DUE_KEY && next > recurrence_end(rule))
+        return INVALID_DUE_KEY;
+    return next;
+}
+// --------------------------------------------------------------------------------
+
+DueKey recurrence_end(const RecurrenceRule& rule)
+{
+    // A key stores no "date only" flag; midnight is how one reads back
+    if (rule.until == INVALID_DUE_KEY || rule.until % 10000 != 0)
+        return rule.until;
+    return rule.until + 2359;
+}
+// --------------------------------------------------------------------------------
+
+std::string describe_recurrence(const RecurrenceRule& rule)
+{
+    std::string text;
+    if (rule.interval == 1) {
+        text = frequency_name(rule.frequency);
+    }
+    else {
+        const char* unit = rule.frequency == Frequency::Daily ? " days" :
+                           rule.frequency == Frequency::Weekly ? " weeks" : " months";
+        text = "every " + std::to_string(rule.interval) + unit;
+    }
+    if (rule.until != INVALID_DUE_KEY)
+        text += " until " + format_due_key(rule.until);
+    return text;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,378 @@
+// ================================================================================
+// ================================================================================
+// - File:    scheduler.cpp
+// - Purpose: Long-lived next-task scheduler backed by an indexed 4-ary min heap.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/scheduler.hpp"
+#include "include/metrics.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static std::string to_upper(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return std::toupper(c); });
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::before(const PriorityQueue& pq1, const PriorityQueue& pq2)
+{
+    // Packed due date and priority, then the ID, so the order is deterministic
+    return pq1 < pq2;
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::swapNodes(size_t i, size_t j)
+{
+    std::swap(heap[i], heap[j]);
+    position[heap[i].id] = i;
+    position[heap[j].id] = j;
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::siftUp(size_t i)
+{
+    while (i > 0) {
+        size_t parent = (i - 1) / ARITY;
+        if (!before(heap[i], heap[parent]))
+            break;
+        swapNodes(i, parent);
+        i = parent;
+    }
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::siftDown(size_t i)
+{
+    while (true) {
+        size_t first_child = i * ARITY + 1;
+        if (first_child >= heap.size())
+            break;
+
+        // Pick the earliest of up to ARITY children
+        size_t last_child = std::min(first_child + ARITY, heap.size());
+        size_t best = first_child;
+        for (size_t child = first_child + 1; child < last_child; child++) {
+            if (before(heap[child], heap[best]))
+                best = child;
+        }
+
+        if (!before(heap[best], heap[i]))
+            break;
+        swapNodes(i, best);
+        i = best;
+    }
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::restore(size_t i)
+{
+    if (i > 0 && before(heap[i], heap[(i - 1) / ARITY]))
+        siftUp(i);
+    else
+        siftDown(i);
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::removeAt(size_t i)
+{
+    size_t last = heap.size() - 1;
+    if (i != last) {
+        swapNodes(i, last);
+    }
+    position.erase(heap[last].id);
+    heap.pop_back();
+    if (i < heap.size()) {
+        restore(i);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::replace(PriorityQueue item)
+{
+    size_t i = position[item.id];
+    heap[i] = std::move(item);
+    restore(i);
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::setInvalid(InvalidTask task)
+{
+    auto it = position.find(task.id);
+    if (it != position.end()) {
+        removeAt(it->second);
+    }
+    int id = task.id;
+    invalid.insert_or_assign(id, std::move(task));
+}
+// --------------------------------------------------------------------------------
+
+Scheduler::Scheduler() : db(nullptr)
+{
+}
+// --------------------------------------------------------------------------------
+
+Scheduler::Scheduler(DB& db) : db(&db)
+{
+    reload();
+    db.addObserver(this);
+}
+// --------------------------------------------------------------------------------
+
+Scheduler::Scheduler(DB& db, std::vector<PriorityQueue> rows, std::vector<InvalidTask> invalid_rows) : db(&db)
+{
+    load(std::move(rows), std::move(invalid_rows));
+    db.addObserver(this);
+}
+// --------------------------------------------------------------------------------
+
+Scheduler::~Scheduler()
+{
+    if (db) {
+        db->removeObserver(this);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::load(std::vector<PriorityQueue> rows, std::vector<InvalidTask> invalid_rows)
+{
+    PLANNER_TIMED(HeapLoad);
+    invalid.clear();
+    for (InvalidTask& task : invalid_rows) {
+        int id = task.id;
+        invalid.insert_or_assign(id, std::move(task));
+    }
+    for (PriorityQueue& row : rows) {
+        if (!row.valid())
+            invalid.try_emplace(row.id, InvalidTask{row.id, std::move(row.task), std::move(row.due_date), row.priority()});
+    }
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+                              [](const PriorityQueue& row) { return !row.valid(); }),
+               rows.end());
+
+    heap = std::move(rows);
+    position.clear();
+    position.reserve(heap.size());
+    for (size_t i = 0; i < heap.size(); i++) {
+        position[heap[i].id] = i;
+    }
+
+    // Bottom-up heapify from the last parent
+    if (heap.size() > 1) {
+        for (size_t i = (heap.size() - 2) / ARITY + 1; i-- > 0;) {
+            siftDown(i);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::reload()
+{
+    if (db) {
+        std::vector<InvalidTask> invalid_rows;
+        std::vector<PriorityQueue> rows = db_to_vector(*db, InvalidDates::Exclude, &invalid_rows);
+        load(std::move(rows), std::move(invalid_rows));
+    }
+}
+// --------------------------------------------------------------------------------
+
+const std::unordered_map<int, InvalidTask>& Scheduler::invalidTasks() const
+{
+    return invalid;
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::empty() const
+{
+    return heap.empty();
+}
+// --------------------------------------------------------------------------------
+
+size_t Scheduler::size() const
+{
+    return heap.size();
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::contains(int id) const
+{
+    return position.count(id) != 0;
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::push(PriorityQueue item)
+{
+    PLANNER_TIMED(HeapPush);
+    if (!item.valid()) {
+        setInvalid(InvalidTask{item.id, std::move(item.task), std::move(item.due_date), item.priority()});
+        return;
+    }
+    invalid.erase(item.id);
+    if (contains(item.id)) {
+        replace(std::move(item));
+        return;
+    }
+
+    position[item.id] = heap.size();
+    heap.push_back(std::move(item));
+    siftUp(heap.size() - 1);
+}
+// --------------------------------------------------------------------------------
+
+const PriorityQueue& Scheduler::peek() const
+{
+    return heap.front();
+}
+// --------------------------------------------------------------------------------
+
+PriorityQueue Scheduler::pop()
+{
+    PLANNER_TIMED(HeapPop);
+    PriorityQueue top = heap.front();
+    removeAt(0);
+    return top;
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::reschedule(int id, const std::string& due_date)
+{
+    PLANNER_TIMED(HeapUpdate);
+    auto it = position.find(id);
+    if (it != position.end()) {
+        const PriorityQueue& current = heap[it->second];
+        PriorityQueue item(id, current.task, due_date, current.priority());
+        if (item.valid())
+            replace(std::move(item));
+        else
+            setInvalid(InvalidTask{id, std::move(item.task), due_date, item.priority()});
+        return true;
+    }
+
+    // A parked task comes back into the heap once its date parses
+    auto parked = invalid.find(id);
+    if (parked == invalid.end())
+        return false;
+    PriorityQueue item(id, parked->second.task, due_date, parked->second.priority);
+    if (item.valid()) {
+        invalid.erase(parked);
+        position[id] = heap.size();
+        heap.push_back(std::move(item));
+        siftUp(heap.size() - 1);
+    }
+    else {
+        parked->second.due_date = due_date;
+    }
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::rename(int id, const std::string& task)
+{
+    PLANNER_TIMED(HeapUpdate);
+    auto it = position.find(id);
+    if (it == position.end()) {
+        auto parked = invalid.find(id);
+        if (parked == invalid.end())
+            return false;
+        parked->second.task = task;
+        return true;
+    }
+
+    // The task text does not take part in the ordering
+    heap[it->second].task = task;
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::reprioritize(int id, int priority)
+{
+    PLANNER_TIMED(HeapUpdate);
+    auto it = position.find(id);
+    if (it == position.end()) {
+        auto parked = invalid.find(id);
+        if (parked == invalid.end())
+            return false;
+        parked->second.priority = priority;
+        return true;
+    }
+
+    heap[it->second].setPriority(priority);
+    restore(it->second);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+bool Scheduler::erase(int id)
+{
+    PLANNER_TIMED(HeapUpdate);
+    auto it = position.find(id);
+    if (it == position.end())
+        return invalid.erase(id) != 0;
+
+    removeAt(it->second);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::taskInserted(int id, const std::string& task, const std::string& due_date, int priority)
+{
+    PriorityQueue item(id, task, due_date, priority);
+    if (item.valid())
+        push(std::move(item));
+    else
+        setInvalid(InvalidTask{id, task, due_date, priority});
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::taskCompleted(int id)
+{
+    erase(id);
+}
+// --------------------------------------------------------------------------------
+
+void Scheduler::plannerUpdated(const UpdateRow& updated_row)
+{
+    std::string set_column = to_upper(updated_row.set_column_name);
+    int id = 0;
+    bool keyed_by_id = to_upper(updated_row.id_column_name) == "ID";
+    if (keyed_by_id) {
+        try {
+            id = std::stoi(updated_row.id_column_value);
+        } catch (const std::exception&) {
+            keyed_by_id = false;
+        }
+    }
+
+    if (keyed_by_id && set_column == "DUE_DATE") {
+        reschedule(id, updated_row.set_new_value);
+    }
+    else if (keyed_by_id && set_column == "TASK") {
+        rename(id, updated_row.set_new_value);
+    }
+    else if (keyed_by_id && set_column == "PRIORITY") {
+        reprioritize(id, std::atoi(updated_row.set_new_value.c_str()));
+    }
+    else {
+        // Anything not addressed by ID can touch any number of rows
+        reload();
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
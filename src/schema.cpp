@@ -0,0 +1,683 @@
+// ================================================================================
+// ================================================================================
+// - File:    schema.cpp
+// - Purpose: Versioned schema migrations; see schema.hpp.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/schema.hpp"
+#include "include/date_key.hpp"
+#include "include/db.hpp"
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+
+// ================================================================================
+// ================================================================================
+
+// The current PLANNER layout.  AUTOINCREMENT keeps a completed task's ID
+// from being handed to a new one.  ORDER_KEY is make_order_key computed by
+// SQLite: never written, but indexable, so every ordered query reads one
+// index in order.
+static const char* const CREATE_PLANNER =
+    "CREATE TABLE IF NOT EXISTS PLANNER("
+    "ID INTEGER PRIMARY KEY AUTOINCREMENT, "
+    "TASK TEXT NOT NULL, "
+    "DUE_DATE VARCHAR(10), "
+    "DUE_KEY INTEGER, "
+    "PRIORITY INTEGER NOT NULL DEFAULT 0 CHECK (PRIORITY BETWEEN 0 AND 255), "
+    "ORDER_KEY INTEGER GENERATED ALWAYS AS (DUE_KEY * 256 + 255 - PRIORITY) VIRTUAL );";
+
+static const char* const PRIORITY_COLUMN =
+    "PRIORITY INTEGER NOT NULL DEFAULT 0 CHECK (PRIORITY BETWEEN 0 AND 255)";
+
+static const char* const ORDER_KEY_COLUMN =
+    "ORDER_KEY INTEGER GENERATED ALWAYS AS (DUE_KEY * 256 + 255 - PRIORITY) VIRTUAL";
+
+// (ORDER_KEY, ID) covers the ORDER BY of every due-date query, and its
+// ranges the WHERE
+static const char* const CREATE_ORDER_KEY_INDEX =
+    "CREATE INDEX IF NOT EXISTS PLANNER_ORDER_KEY_IDX ON PLANNER(ORDER_KEY);";
+// --------------------------------------------------------------------------------
+
+static bool fts5_available()
+{
+    return sqlite3_compileoption_used("ENABLE_FTS5") != 0;
+}
+// --------------------------------------------------------------------------------
+
+// First column of the first row of sql as an integer; false if there is no
+// row or the value is NULL.
+static bool query_int64(sqlite3* db, const std::string& sql, int64_t& value)
+{
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+    bool found = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL;
+    if (found)
+        value = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+// ================================================================================
+// ================================================================================
+
+
+ //   private:
+
+void SchemaMigrator::report(int version, int64_t done, int64_t total)
+{
+    if (options.progress)
+        options.progress(MigrationProgress{version, describe(version), done, total});
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::beginWrite()
+{
+    nested = !sqlite3_get_autocommit(db.db);
+    return nested ? db.beginTransaction() : db.execSQL("BEGIN IMMEDIATE;");
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::commitWrite()
+{
+    return nested ? db.commitTransaction() : db.execSQL("COMMIT;");
+}
+// --------------------------------------------------------------------------------
+
+void SchemaMigrator::rollbackWrite()
+{
+    if (nested)
+        db.rollbackTransaction();
+    else
+        db.execSQL("ROLLBACK;");
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::detectVersion(int& version)
+{
+    int64_t stored = 0;
+    if (!query_int64(db.db, "PRAGMA user_version;", stored)) {
+        std::cerr << "Error reading the schema version: " << sqlite3_errmsg(db.db) << std::endl;
+        return SQLITE_ERROR;
+    }
+    version = static_cast<int>(stored);
+    if (version > 0) {
+        return SQLITE_OK;
+    }
+
+    if (!hasTable("PLANNER")) {
+        version = -1;
+        return SQLITE_OK;
+    }
+
+    // The first planners declared "id INT NOT NULL, PRIMARY KEY (id)": an
+    // ordinary indexed column, so inserts without an ID fail.  Only a
+    // column declared exactly INTEGER PRIMARY KEY aliases the rowid.
+    int64_t rowid_alias = 0;
+    query_int64(db.db,
+                "SELECT COUNT(*) = 1 AND SUM(name = 'ID' COLLATE NOCASE AND type = 'INTEGER' COLLATE NOCASE) = 1 "
+                "FROM pragma_table_info('PLANNER') WHERE pk > 0;",
+                rowid_alias);
+    if (!rowid_alias)
+        version = 0;
+    else if (!hasColumn("PLANNER", "DUE_KEY"))
+        version = 1;
+    else if (!hasColumn("PLANNER", "ORDER_KEY"))
+        version = 2;
+    else if (!hasTable("RECURRENCE"))
+        version = 3;
+    else if (fts5_available() && !hasTable("PLANNER_FTS"))
+        version = 4;
+    else if (!hasTable("PLANNER_CHANGES"))
+        version = 5;
+    else if (!hasAutoincrement())
+        version = 6;
+    else
+        version = 7;
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+bool SchemaMigrator::hasTable(const std::string& name)
+{
+    int64_t found = 0;
+    return query_int64(db.db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = '" + name +
+                              "' COLLATE NOCASE;", found) && found > 0;
+}
+// --------------------------------------------------------------------------------
+
+bool SchemaMigrator::hasAutoincrement()
+{
+    // SQLite keeps no flag for it; the declaration is the only record
+    int64_t found = 0;
+    return query_int64(db.db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'PLANNER' "
+                              "AND sql LIKE '%AUTOINCREMENT%';", found) && found > 0;
+}
+// --------------------------------------------------------------------------------
+
+bool SchemaMigrator::hasColumn(const std::string& table, const std::string& column)
+{
+    // table_xinfo also lists generated columns
+    int64_t found = 0;
+    return query_int64(db.db, "SELECT COUNT(*) FROM pragma_table_xinfo('" + table + "') WHERE name = '" +
+                              column + "' COLLATE NOCASE;", found) && found > 0;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::inTransaction(int version, const std::function<int()>& body)
+{
+    int rc = beginWrite();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    rc = body();
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("PRAGMA user_version = " + std::to_string(version) + ";");
+    }
+    if (rc != SQLITE_OK) {
+        rollbackWrite();
+        return rc;
+    }
+    return commitWrite();
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::createRecurrenceTables()
+{
+    // One row per recurring task; PENDING_ID is the PLANNER row holding its
+    // next occurrence and is looked up on every completion
+    int rc = db.execSQL("CREATE TABLE IF NOT EXISTS RECURRENCE("
+                        "ID INTEGER PRIMARY KEY, "
+                        "TASK TEXT NOT NULL, "
+                        "START_KEY INTEGER NOT NULL, "
+                        "FREQUENCY TEXT NOT NULL, "
+                        "EVERY INTEGER NOT NULL, "
+                        "UNTIL_KEY INTEGER, "
+                        "PENDING_ID INTEGER, "
+                        "PENDING_KEY INTEGER );");
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE INDEX IF NOT EXISTS RECURRENCE_PENDING_IDX ON RECURRENCE(PENDING_ID);");
+    }
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::createSearchTables()
+{
+    // Search is optional: a SQLite built without FTS5 still runs the planner
+    if (!fts5_available()) {
+        return SQLITE_OK;
+    }
+
+    // External content: the index stores only tokens and reads TASK back
+    // from PLANNER, and the triggers keep it in step with every writer
+    // (bulk loads, the write pipeline, other processes)
+    int rc = db.execSQL("CREATE VIRTUAL TABLE IF NOT EXISTS PLANNER_FTS USING fts5("
+                        "TASK, content='PLANNER', content_rowid='ID', "
+                        "tokenize='unicode61 remove_diacritics 2', prefix='2 3');");
+    if (rc == SQLITE_OK) {
+        rc = createSearchTriggers();
+    }
+    if (rc == SQLITE_OK) {
+        // Index the rows already there.  FTS5 cannot index part of an
+        // external-content table while the triggers maintain the rest, so
+        // this one statement holds the write lock for the whole table.
+        rc = db.execSQL("INSERT INTO PLANNER_FTS(PLANNER_FTS) VALUES ('rebuild');");
+    }
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::createSearchTriggers()
+{
+    int rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_FTS_INSERT AFTER INSERT ON PLANNER BEGIN "
+                        "INSERT INTO PLANNER_FTS(rowid, TASK) VALUES (new.ID, new.TASK); END;");
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_FTS_DELETE AFTER DELETE ON PLANNER BEGIN "
+                        "INSERT INTO PLANNER_FTS(PLANNER_FTS, rowid, TASK) VALUES ('delete', old.ID, old.TASK); END;");
+    }
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_FTS_UPDATE AFTER UPDATE OF ID, TASK ON PLANNER BEGIN "
+                        "INSERT INTO PLANNER_FTS(PLANNER_FTS, rowid, TASK) VALUES ('delete', old.ID, old.TASK); "
+                        "INSERT INTO PLANNER_FTS(rowid, TASK) VALUES (new.ID, new.TASK); END;");
+    }
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::createChangeLog()
+{
+    // Every write to PLANNER, from any connection, appends (SEQ, TASK_ID,
+    // KIND).  AUTOINCREMENT keeps SEQ increasing even after the log is
+    // pruned, so a reader's last sequence is never handed out again.
+    int rc = db.execSQL("CREATE TABLE IF NOT EXISTS PLANNER_CHANGES("
+                        "SEQ INTEGER PRIMARY KEY AUTOINCREMENT, "
+                        "TASK_ID INTEGER NOT NULL, "
+                        "KIND INTEGER NOT NULL );");
+    std::string inserted = std::to_string(CHANGE_INSERTED);
+    std::string updated = std::to_string(CHANGE_UPDATED);
+    std::string completed = std::to_string(CHANGE_COMPLETED);
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_CHANGES_INSERT AFTER INSERT ON PLANNER BEGIN "
+                        "INSERT INTO PLANNER_CHANGES(TASK_ID, KIND) VALUES (new.ID, " + inserted + "); END;");
+    }
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_CHANGES_UPDATE AFTER UPDATE ON PLANNER "
+                        "WHEN old.ID = new.ID BEGIN "
+                        "INSERT INTO PLANNER_CHANGES(TASK_ID, KIND) VALUES (new.ID, " + updated + "); END;");
+    }
+    if (rc == SQLITE_OK) {
+        // A changed ID reads as the old task completed and a new one inserted
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_CHANGES_RENUMBER AFTER UPDATE OF ID ON PLANNER "
+                        "WHEN old.ID <> new.ID BEGIN "
+                        "INSERT INTO PLANNER_CHANGES(TASK_ID, KIND) VALUES (old.ID, " + completed + "); "
+                        "INSERT INTO PLANNER_CHANGES(TASK_ID, KIND) VALUES (new.ID, " + inserted + "); END;");
+    }
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_CHANGES_DELETE AFTER DELETE ON PLANNER BEGIN "
+                        "INSERT INTO PLANNER_CHANGES(TASK_ID, KIND) VALUES (old.ID, " + completed + "); END;");
+    }
+    return rc;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::createLatest()
+{
+    return inTransaction(SCHEMA_VERSION, [this] {
+        int rc = db.execSQL(CREATE_PLANNER);
+        if (rc == SQLITE_OK) {
+            rc = db.execSQL(CREATE_ORDER_KEY_INDEX);
+        }
+        if (rc == SQLITE_OK) {
+            rc = createRecurrenceTables();
+        }
+        if (rc == SQLITE_OK) {
+            rc = createSearchTables();
+        }
+        if (rc == SQLITE_OK) {
+            rc = createChangeLog();
+        }
+        return rc;
+    });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::rebuildPlanner(int version)
+{
+    // Copy into a table keyed by the rowid, then swap it in.  Triggers on the
+    // old table mirror every change into the copy, so writers carry on
+    // between chunks; both the triggers and the chunks write a row's current
+    // state, which also makes an interrupted rebuild safe to start over.
+    // Columns a later build may already have added come along.
+    std::string columns = "ID, TASK, DUE_DATE";
+    std::string create = "CREATE TABLE IF NOT EXISTS PLANNER_REBUILD("
+                         "ID INTEGER PRIMARY KEY AUTOINCREMENT, TASK TEXT NOT NULL, DUE_DATE VARCHAR(10)";
+    if (hasColumn("PLANNER", "DUE_KEY")) {
+        columns += ", DUE_KEY";
+        create += ", DUE_KEY INTEGER";
+    }
+    if (hasColumn("PLANNER", "PRIORITY")) {
+        columns += ", PRIORITY";
+        create += std::string(", ") + PRIORITY_COLUMN;
+    }
+    bool ordered = hasColumn("PLANNER", "ORDER_KEY");
+    if (ordered) {
+        create += std::string(", ") + ORDER_KEY_COLUMN;
+    }
+    create += ");";
+    std::string new_values = "new." + columns;
+    for (size_t comma = new_values.find(", "); comma != std::string::npos; comma = new_values.find(", ", comma + 2)) {
+        new_values.insert(comma + 2, "new.");
+    }
+    std::string mirror = "INSERT OR REPLACE INTO PLANNER_REBUILD(" + columns + ") VALUES (" + new_values + ");";
+
+    int rc = beginWrite();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    rc = db.execSQL(create);
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_REBUILD_INSERT AFTER INSERT ON PLANNER BEGIN " +
+                        mirror + " END;");
+    }
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_REBUILD_UPDATE AFTER UPDATE ON PLANNER BEGIN "
+                        "DELETE FROM PLANNER_REBUILD WHERE ID = old.ID; " + mirror + " END;");
+    }
+    if (rc == SQLITE_OK) {
+        rc = db.execSQL("CREATE TRIGGER IF NOT EXISTS PLANNER_REBUILD_DELETE AFTER DELETE ON PLANNER BEGIN "
+                        "DELETE FROM PLANNER_REBUILD WHERE ID = old.ID; END;");
+    }
+    if (rc != SQLITE_OK) {
+        rollbackWrite();
+        return rc;
+    }
+    rc = commitWrite();
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+
+    int64_t total = 0;
+    query_int64(db.db, "SELECT COUNT(*) FROM PLANNER;", total);
+    std::string chunk_end = "SELECT MAX(ID) FROM (SELECT ID FROM PLANNER WHERE ID > ? ORDER BY ID LIMIT ?);";
+    std::string copy = "INSERT OR REPLACE INTO PLANNER_REBUILD(" + columns + ") SELECT " + columns +
+                       " FROM PLANNER WHERE ID > ? AND ID <= ?;";
+
+    // The old primary key is indexed, so each chunk is a range scan
+    int64_t done = 0;
+    int64_t last = INT64_MIN;
+    for (;;) {
+        rc = beginWrite();
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+        Statement end_stmt, copy_stmt;
+        rc = db.prepare(chunk_end, end_stmt);
+        if (rc == SQLITE_OK) {
+            rc = db.prepare(copy, copy_stmt);
+        }
+        bool finished = false;
+        int64_t end = last;
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_int64(end_stmt.get(), 1, last);
+            sqlite3_bind_int64(end_stmt.get(), 2, options.chunk_rows);
+            rc = sqlite3_step(end_stmt.get()) == SQLITE_ROW ? SQLITE_OK : sqlite3_errcode(db.db);
+            finished = rc == SQLITE_OK && sqlite3_column_type(end_stmt.get(), 0) == SQLITE_NULL;
+            end = sqlite3_column_int64(end_stmt.get(), 0);
+        }
+        if (rc == SQLITE_OK && !finished) {
+            sqlite3_bind_int64(copy_stmt.get(), 1, last);
+            sqlite3_bind_int64(copy_stmt.get(), 2, end);
+            rc = sqlite3_step(copy_stmt.get()) == SQLITE_DONE ? SQLITE_OK : sqlite3_errcode(db.db);
+            done += sqlite3_changes(db.db);
+        }
+        end_stmt.release();
+        copy_stmt.release();
+        if (rc != SQLITE_OK) {
+            std::cerr << "Error copying planner rows: " << sqlite3_errmsg(db.db) << std::endl;
+            rollbackWrite();
+            return rc;
+        }
+        rc = commitWrite();
+        if (rc != SQLITE_OK || finished) {
+            break;
+        }
+        last = end;
+        report(version, done, total);
+    }
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+
+    // Dropping the old table drops its triggers and indexes with it, so
+    // the ones later versions added are made again on the new table.  The
+    // FTS index reads PLANNER by name and the rowids are unchanged, so it
+    // stays valid as it is.
+    bool searchable = hasTable("PLANNER_FTS");
+    bool logged = hasTable("PLANNER_CHANGES");
+    return inTransaction(version, [this, ordered, searchable, logged] {
+        int swap_rc = db.execSQL("DROP TABLE PLANNER;");
+        if (swap_rc == SQLITE_OK) {
+            swap_rc = db.execSQL("ALTER TABLE PLANNER_REBUILD RENAME TO PLANNER;");
+        }
+        if (swap_rc == SQLITE_OK && ordered) {
+            swap_rc = db.execSQL(CREATE_ORDER_KEY_INDEX);
+        }
+        if (swap_rc == SQLITE_OK && searchable) {
+            swap_rc = createSearchTriggers();
+        }
+        if (swap_rc == SQLITE_OK && logged) {
+            // IDs completed before the rebuild may be larger than any left
+            // in the table; the log remembers them, so they stay retired
+            swap_rc = createChangeLog();
+            if (swap_rc == SQLITE_OK) {
+                swap_rc = db.execSQL("INSERT INTO sqlite_sequence(name, seq) SELECT 'PLANNER', 0 "
+                                     "WHERE NOT EXISTS (SELECT 1 FROM sqlite_sequence WHERE name = 'PLANNER');");
+            }
+            if (swap_rc == SQLITE_OK) {
+                swap_rc = db.execSQL("UPDATE sqlite_sequence SET seq = MAX(seq, "
+                                     "(SELECT IFNULL(MAX(TASK_ID), 0) FROM PLANNER_CHANGES)) WHERE name = 'PLANNER';");
+            }
+        }
+        return swap_rc;
+    });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::rebuildWithRowid()
+{
+    return rebuildPlanner(1);
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::addDueKeys()
+{
+    // Adding a column only rewrites the schema; the keys are filled in below
+    if (!hasColumn("PLANNER", "DUE_KEY")) {
+        int rc = beginWrite();
+        if (rc == SQLITE_OK) {
+            rc = db.execSQL("ALTER TABLE PLANNER ADD COLUMN DUE_KEY INTEGER;");
+            if (rc != SQLITE_OK) {
+                rollbackWrite();
+                return rc;
+            }
+            rc = commitWrite();
+        }
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+    }
+
+    // Writers set DUE_KEY themselves from here on, so only older rows are
+    // left to fill.  Each chunk reads, parses and writes in one transaction.
+    int64_t total = 0;
+    query_int64(db.db, "SELECT COUNT(*) FROM PLANNER WHERE DUE_KEY IS NULL AND DUE_DATE IS NOT NULL;", total);
+    int64_t done = 0;
+    int64_t last = INT64_MIN;
+    std::vector<int> ids;
+    std::vector<std::string> due_dates;
+    for (;;) {
+        int rc = beginWrite();
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+        Statement stmt;
+        rc = db.prepare("SELECT ID, DUE_DATE FROM PLANNER WHERE ID > ? AND DUE_KEY IS NULL AND DUE_DATE IS NOT NULL "
+                        "ORDER BY ID LIMIT ?;", stmt);
+        ids.clear();
+        due_dates.clear();
+        if (rc == SQLITE_OK) {
+            sqlite3_bind_int64(stmt.get(), 1, last);
+            sqlite3_bind_int64(stmt.get(), 2, options.chunk_rows);
+            while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+                ids.push_back(sqlite3_column_int(stmt.get(), 0));
+                due_dates.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1)),
+                                       static_cast<size_t>(sqlite3_column_bytes(stmt.get(), 1)));
+            }
+            rc = rc == SQLITE_DONE ? SQLITE_OK : rc;
+            stmt.release();
+        }
+
+        std::vector<std::string_view> texts(due_dates.begin(), due_dates.end());
+        std::vector<DueKey> keys(texts.size());
+        std::vector<DateError> invalid;
+        parse_due_keys(texts.data(), texts.size(), keys.data(), invalid);
+        if (rc == SQLITE_OK) {
+            rc = db.prepare("UPDATE PLANNER SET DUE_KEY = ? WHERE ID = ?;", stmt);
+        }
+        for (size_t i = 0; rc == SQLITE_OK && i < ids.size(); i++) {
+            if (keys[i] == INVALID_DUE_KEY)
+                continue;
+            sqlite3_reset(stmt.get());
+            sqlite3_bind_int64(stmt.get(), 1, keys[i]);
+            sqlite3_bind_int(stmt.get(), 2, ids[i]);
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE)
+                rc = sqlite3_errcode(db.db);
+        }
+        stmt.release();
+        if (rc != SQLITE_OK) {
+            std::cerr << "Error filling DUE_KEY: " << sqlite3_errmsg(db.db) << std::endl;
+            rollbackWrite();
+            return rc;
+        }
+        rc = commitWrite();
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+        if (ids.empty()) {
+            break;
+        }
+        done += static_cast<int64_t>(ids.size());
+        last = ids.back();
+        report(2, done, total);
+    }
+    return inTransaction(2, [] { return SQLITE_OK; });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::addPriority()
+{
+    // Both columns are O(1) to add (ORDER_KEY is virtual and never stored);
+    // the index is built by one sort, which SQLite cannot split up
+    return inTransaction(3, [this] {
+        int rc = SQLITE_OK;
+        if (!hasColumn("PLANNER", "PRIORITY")) {
+            rc = db.execSQL(std::string("ALTER TABLE PLANNER ADD COLUMN ") + PRIORITY_COLUMN + ";");
+        }
+        if (rc == SQLITE_OK && !hasColumn("PLANNER", "ORDER_KEY")) {
+            rc = db.execSQL(std::string("ALTER TABLE PLANNER ADD COLUMN ") + ORDER_KEY_COLUMN + ";");
+        }
+        if (rc == SQLITE_OK) {
+            rc = db.execSQL(CREATE_ORDER_KEY_INDEX);
+        }
+        if (rc == SQLITE_OK) {
+            // Version 2 ordered by DUE_KEY alone
+            rc = db.execSQL("DROP INDEX IF EXISTS PLANNER_DUE_KEY_IDX;");
+        }
+        return rc;
+    });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::addRecurrence()
+{
+    return inTransaction(4, [this] { return createRecurrenceTables(); });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::addSearchIndex()
+{
+    return inTransaction(5, [this] { return createSearchTables(); });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::addChangeLog()
+{
+    // The log starts empty: readers load the table once and follow it from
+    // the sequence they loaded at
+    return inTransaction(6, [this] { return createChangeLog(); });
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::addAutoincrement()
+{
+    // A planner rebuilt from version 0 already has the keyword
+    if (hasAutoincrement()) {
+        return inTransaction(7, [] { return SQLITE_OK; });
+    }
+    return rebuildPlanner(7);
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+SchemaMigrator::SchemaMigrator(DB& db, const MigrationOptions& options)
+    : db(db), options(options), nested(false)
+{
+    if (this->options.chunk_rows <= 0)
+        this->options.chunk_rows = MigrationOptions().chunk_rows;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::currentVersion()
+{
+    int version;
+    return detectVersion(version) == SQLITE_OK ? version : -1;
+}
+// --------------------------------------------------------------------------------
+
+int SchemaMigrator::migrate()
+{
+    int version;
+    int rc = detectVersion(version);
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+    if (version > SCHEMA_VERSION) {
+        std::cerr << "Error: the planner has schema version " << version << "; this program supports up to "
+                  << SCHEMA_VERSION << std::endl;
+        return SQLITE_ERROR;
+    }
+    if (version < 0) {
+        report(SCHEMA_VERSION, 0, 0);
+        return createLatest();
+    }
+
+    typedef int (SchemaMigrator::*Step)();
+    static const Step steps[SCHEMA_VERSION] = {
+        &SchemaMigrator::rebuildWithRowid,
+        &SchemaMigrator::addDueKeys,
+        &SchemaMigrator::addPriority,
+        &SchemaMigrator::addRecurrence,
+        &SchemaMigrator::addSearchIndex,
+        &SchemaMigrator::addChangeLog,
+        &SchemaMigrator::addAutoincrement
+    };
+    for (int next = version + 1; next <= SCHEMA_VERSION; next++) {
+        report(next, 0, 0);
+        rc = (this->*steps[next - 1])();
+        if (rc != SQLITE_OK) {
+            std::cerr << "Error migrating the planner to schema version " << next << " ("
+                      << describe(next) << ")" << std::endl;
+            return rc;
+        }
+    }
+
+    // Planners from before versioning that already have every table only
+    // need the number written down
+    int64_t stored = 0;
+    if (query_int64(db.db, "PRAGMA user_version;", stored) && stored != SCHEMA_VERSION) {
+        return inTransaction(SCHEMA_VERSION, [] { return SQLITE_OK; });
+    }
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+const char* SchemaMigrator::describe(int version)
+{
+    switch (version) {
+        case 1: return "rowid task IDs";
+        case 2: return "parsed due dates";
+        case 3: return "priorities";
+        case 4: return "recurring tasks";
+        case 5: return "full-text search";
+        case 6: return "change log";
+        case 7: return "never-reused task IDs";
+    }
+    return "unknown";
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,663 @@
+// ================================================================================
+// ================================================================================
+// - File:    server.cpp
+// - Purpose: Long-running planner daemon over a Unix domain socket.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/server.hpp"
+#include "include/date_key.hpp"
+#include "include/protocol.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ================================================================================
+// ================================================================================
+
+static const size_t READ_CHUNK = 64 * 1024;
+// --------------------------------------------------------------------------------
+
+static bool parse_id(const std::string& text, int& id)
+{
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < 0 || value > INT32_MAX)
+        return false;
+    id = static_cast<int>(value);
+    return true;
+}
+// --------------------------------------------------------------------------------
+
+static void append_error(std::string& out, std::string_view message)
+{
+    out.append("ERR ").append(message).push_back('\n');
+}
+// --------------------------------------------------------------------------------
+
+static void append_header(std::string& out, size_t rows)
+{
+    out.append("OK ").append(std::to_string(rows)).push_back('\n');
+}
+// --------------------------------------------------------------------------------
+
+static void append_row(std::string& out, const SnapshotRow& row)
+{
+    out.append(std::to_string(row.id)).push_back('\t');
+    append_escaped_field(out, row.task);
+    out.push_back('\t');
+    out.append(format_due_key(row.due_key)).push_back('\t');
+    out.append(std::to_string(row.priority)).push_back('\n');
+}
+// --------------------------------------------------------------------------------
+
+static bool parse_priority(const std::string& text, int& priority)
+{
+    return parse_id(text, priority) && priority >= MIN_PRIORITY && priority <= MAX_PRIORITY;
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+PlannerServer::PlannerServer(DB& db, const ServerOptions& options) :
+    db(db),
+    options(options),
+    snapshot(db),
+    listen_fd(-1),
+    epoll_fd(-1),
+    wake_fd(-1),
+    stopping(false),
+    requests_served(0),
+    next_refresh(0),
+    next_connection(WAKE_ID + 1),
+    workers_stopping(false)
+{
+}
+// --------------------------------------------------------------------------------
+
+PlannerServer::~PlannerServer()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        workers_stopping = true;
+    }
+    jobs_ready.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (auto& [id, connection] : connections) {
+        close(connection.fd);
+    }
+    if (listen_fd >= 0) {
+        close(listen_fd);
+        unlink(socket_path.c_str());
+    }
+    if (epoll_fd >= 0)
+        close(epoll_fd);
+    if (wake_fd >= 0)
+        close(wake_fd);
+}
+// --------------------------------------------------------------------------------
+
+int PlannerServer::listen(const std::string& path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: socket path too long: " << path << std::endl;
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cerr << "Error creating socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    // A socket file left by a crashed server would make bind fail
+    unlink(path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listen_fd, SOMAXCONN) < 0) {
+        std::cerr << "Error binding " << path << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+    socket_path = path;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0) {
+        std::cerr << "Error creating event loop: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LISTEN_ID;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+    for (int i = 0; i < std::max(1, options.workers); i++) {
+        workers.emplace_back(&PlannerServer::workerLoop, this);
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+int PlannerServer::run()
+{
+    if (epoll_fd < 0)
+        return -1;
+
+    epoll_event events[64];
+    while (!stopping.load()) {
+        int ready = epoll_wait(epoll_fd, events, 64, -1);
+        if (ready < 0) {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Error waiting for events: " << std::strerror(errno) << std::endl;
+            return -1;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) {
+                acceptConnections();
+            }
+            else if (id == WAKE_ID) {
+                uint64_t count;
+                while (read(wake_fd, &count, sizeof(count)) > 0) {
+                }
+                drainCompletions();
+            }
+            else {
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                    readConnection(id);
+                if (events[i].events & EPOLLOUT)
+                    writeConnection(id);
+            }
+        }
+    }
+    return 0;
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::requestStop()
+{
+    stopping.store(true);
+    uint64_t one = 1;
+    if (wake_fd >= 0) {
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+}
+// --------------------------------------------------------------------------------
+
+uint64_t PlannerServer::requestsServed() const
+{
+    return requests_served.load(std::memory_order_relaxed);
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   private:
+
+void PlannerServer::workerLoop()
+{
+    std::string responses;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_ready.wait(lock, [this] { return workers_stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        refreshIfDue();
+        responses.clear();
+        handleRequests(job.requests, responses);
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex);
+            completions.push_back(Completion{job.connection, responses});
+        }
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd, &one, sizeof(one));
+        (void)written;
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::handleRequests(const std::string& requests, std::string& responses)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (start < requests.size()) {
+        size_t end = requests.find('\n', start);
+        split_line(std::string_view(requests).substr(start, end - start), fields);
+        handleRequest(fields, responses);
+        start = end + 1;
+    }
+}
+// --------------------------------------------------------------------------------
+
+template <typename Write>
+int PlannerServer::writeLocked(Write write)
+{
+    std::unique_lock<std::shared_mutex> lock(state_mutex);
+    return write();
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::refreshIfDue()
+{
+    if (options.refresh_ms <= 0)
+        return;
+
+    // One worker wins the slot; the others serve from the snapshot as it is
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t due = next_refresh.load(std::memory_order_relaxed);
+    if (now < due ||
+        !next_refresh.compare_exchange_strong(due, now + static_cast<int64_t>(options.refresh_ms) * 1000000))
+        return;
+    writeLocked([this] { return snapshot.catchUp(); });
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::handleRequest(const std::vector<std::string>& fields, std::string& out)
+{
+    requests_served.fetch_add(1, std::memory_order_relaxed);
+    const std::string& command = fields[0];
+    size_t arguments = fields.size() - 1;
+
+    if (command == "PING") {
+        append_header(out, 0);
+    }
+    else if (command == "NEXT" && arguments <= 1) {
+        int count = 1;
+        if (arguments == 1 && (!parse_id(fields[1], count) || count > options.max_next)) {
+            append_error(out, "bad count");
+            return;
+        }
+        std::shared_lock<std::shared_mutex> lock(state_mutex);
+        if (count == 1) {
+            SnapshotRow row;
+            if (snapshot.next(row)) {
+                append_header(out, 1);
+                append_row(out, row);
+            }
+            else {
+                append_header(out, 0);
+            }
+        }
+        else {
+            std::vector<SnapshotRow> rows;
+            snapshot.nextTasks(static_cast<size_t>(count), rows);
+            append_header(out, rows.size());
+            for (const SnapshotRow& row : rows) {
+                append_row(out, row);
+            }
+        }
+    }
+    else if (command == "FIND" && arguments == 1) {
+        int id;
+        if (!parse_id(fields[1], id)) {
+            append_error(out, "bad id");
+            return;
+        }
+        std::shared_lock<std::shared_mutex> lock(state_mutex);
+        SnapshotRow row;
+        if (snapshot.find(id, row)) {
+            append_header(out, 1);
+            append_row(out, row);
+        }
+        else {
+            append_header(out, 0);
+        }
+    }
+    else if (command == "RANGE" && arguments == 2) {
+        DueKey from, to;
+        if (!parse_due_key(fields[1].data(), fields[1].size(), from) ||
+            !parse_due_key(fields[2].data(), fields[2].size(), to)) {
+            append_error(out, "bad date");
+            return;
+        }
+        std::shared_lock<std::shared_mutex> lock(state_mutex);
+        std::vector<SnapshotRow> rows;
+        snapshot.tasksDueBetween(from, to, rows);
+        append_header(out, rows.size());
+        for (const SnapshotRow& row : rows) {
+            append_row(out, row);
+        }
+    }
+    else if (command == "COUNT" && arguments == 0) {
+        size_t count;
+        {
+            std::shared_lock<std::shared_mutex> lock(state_mutex);
+            count = snapshot.size();
+        }
+        append_header(out, 1);
+        out.append(std::to_string(count)).push_back('\n');
+    }
+    else if (command == "ADD" && (arguments == 2 || arguments == 3)) {
+        DueKey key;
+        if (!parse_due_key(fields[2].data(), fields[2].size(), key)) {
+            append_error(out, "bad date");
+            return;
+        }
+        int priority = MIN_PRIORITY;
+        if (arguments == 3 && !parse_priority(fields[3], priority)) {
+            append_error(out, "bad priority");
+            return;
+        }
+        std::string task = fields[1];
+        std::string due_date = fields[2];
+        long long id = 0;
+        int rc = writeLocked([&] {
+            if (priority == MIN_PRIORITY) {
+                int insert_rc = snapshot.insertTask(task, due_date);
+                id = sqlite3_last_insert_rowid(db.db);
+                return insert_rc;
+            }
+
+            // Insert and prioritize together so the task never shows unprioritized
+            int insert_rc = db.beginTransaction();
+            if (insert_rc == SQLITE_OK)
+                insert_rc = snapshot.insertTask(task, due_date);
+            if (insert_rc == SQLITE_OK) {
+                id = sqlite3_last_insert_rowid(db.db);
+                insert_rc = db.setPriority(static_cast<int>(id), priority);
+            }
+            if (insert_rc == SQLITE_OK)
+                insert_rc = db.commitTransaction();
+            if (insert_rc != SQLITE_OK)
+                db.rollbackTransaction();
+            return insert_rc;
+        });
+        if (rc != SQLITE_OK) {
+            append_error(out, sqlite3_errstr(rc));
+            return;
+        }
+        append_header(out, 1);
+        out.append(std::to_string(id)).push_back('\n');
+    }
+    else if (command == "COMPLETE" && arguments == 1) {
+        int id;
+        if (!parse_id(fields[1], id)) {
+            append_error(out, "bad id");
+            return;
+        }
+        bool found = false;
+        int rc = writeLocked([&] {
+            SnapshotRow row;
+            found = snapshot.find(id, row);
+            return found ? snapshot.completeTask(id) : SQLITE_OK;
+        });
+        if (rc != SQLITE_OK)
+            append_error(out, sqlite3_errstr(rc));
+        else if (!found)
+            append_error(out, "no such task");
+        else
+            append_header(out, 0);
+    }
+    else if (command == "UPDATE" && arguments == 3) {
+        int id;
+        if (!parse_id(fields[1], id)) {
+            append_error(out, "bad id");
+            return;
+        }
+        // Only these columns are exposed; the name goes into the SQL text
+        std::string column;
+        DueKey key;
+        int priority;
+        if (fields[2] == "task")
+            column = "TASK";
+        else if (fields[2] == "due_date" && parse_due_key(fields[3].data(), fields[3].size(), key))
+            column = "DUE_DATE";
+        else if (fields[2] == "priority" && parse_priority(fields[3], priority))
+            column = "PRIORITY";
+        else {
+            append_error(out, "bad column or value");
+            return;
+        }
+
+        UpdateRow update{column, fields[3], "ID", std::to_string(id)};
+        bool found = false;
+        int rc = writeLocked([&] {
+            SnapshotRow row;
+            found = snapshot.find(id, row);
+            return found ? snapshot.updatePlanner(update) : SQLITE_OK;
+        });
+        if (rc != SQLITE_OK)
+            append_error(out, sqlite3_errstr(rc));
+        else if (!found)
+            append_error(out, "no such task");
+        else
+            append_header(out, 0);
+    }
+    else {
+        append_error(out, "unknown request");
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::acceptConnections()
+{
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::cerr << "Error accepting connection: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        uint64_t id = next_connection++;
+        Connection& connection = connections[id];
+        connection.fd = fd;
+        connection.events = EPOLLIN;
+        epoll_event event{};
+        event.events = connection.events;
+        event.data.u64 = id;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::readConnection(uint64_t id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+    Connection& connection = it->second;
+
+    char buffer[READ_CHUNK];
+    while (!connection.eof && connection.input.size() < options.max_line_bytes + READ_CHUNK) {
+        ssize_t count = read(connection.fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            connection.input.append(buffer, static_cast<size_t>(count));
+        }
+        else if (count == 0) {
+            connection.eof = true;
+        }
+        else if (errno == EINTR) {
+            continue;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        else {
+            closeConnection(id);
+            return;
+        }
+    }
+
+    size_t line_end = connection.input.rfind('\n');
+    size_t pending = line_end == std::string::npos ? connection.input.size()
+                                                   : connection.input.size() - line_end - 1;
+    if (pending > options.max_line_bytes) {
+        closeConnection(id);
+        return;
+    }
+
+    dispatch(id);
+    finishIfDone(id);
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::writeConnection(uint64_t id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+    Connection& connection = it->second;
+
+    while (connection.output_sent < connection.output.size()) {
+        ssize_t count = send(connection.fd, connection.output.data() + connection.output_sent,
+                             connection.output.size() - connection.output_sent, MSG_NOSIGNAL);
+        if (count > 0) {
+            connection.output_sent += static_cast<size_t>(count);
+        }
+        else if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        else {
+            closeConnection(id);
+            return;
+        }
+    }
+    if (connection.output_sent == connection.output.size()) {
+        connection.output.clear();
+        connection.output_sent = 0;
+    }
+
+    // Draining the output may let a throttled connection continue
+    dispatch(id);
+    finishIfDone(id);
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::dispatch(uint64_t id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+    Connection& connection = it->second;
+
+    if (!connection.busy && connection.output.size() - connection.output_sent <= options.max_output_bytes) {
+        size_t line_end = connection.input.rfind('\n');
+        if (line_end != std::string::npos) {
+            Job job{id, connection.input.substr(0, line_end + 1)};
+            connection.input.erase(0, line_end + 1);
+            connection.busy = true;
+            {
+                std::lock_guard<std::mutex> lock(jobs_mutex);
+                jobs.push_back(std::move(job));
+            }
+            jobs_ready.notify_one();
+        }
+    }
+    updateEvents(id);
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::drainCompletions()
+{
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(completions_mutex);
+        done.swap(completions);
+    }
+
+    for (Completion& completion : done) {
+        auto it = connections.find(completion.connection);
+        if (it == connections.end())
+            continue;
+        it->second.busy = false;
+        it->second.output.append(completion.responses);
+        writeConnection(completion.connection);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::finishIfDone(uint64_t id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+    const Connection& connection = it->second;
+
+    // A half-closed client still gets the answers to what it sent
+    if (connection.eof && !connection.busy && connection.output.empty() &&
+        connection.input.find('\n') == std::string::npos) {
+        closeConnection(id);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::closeConnection(uint64_t id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    connections.erase(it);
+}
+// --------------------------------------------------------------------------------
+
+void PlannerServer::updateEvents(uint64_t id)
+{
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+    Connection& connection = it->second;
+
+    uint32_t events = 0;
+    bool output_pending = connection.output_sent < connection.output.size();
+    if (!connection.eof && connection.input.size() <= options.max_line_bytes &&
+        connection.output.size() - connection.output_sent <= options.max_output_bytes)
+        events |= EPOLLIN;
+    if (output_pending)
+        events |= EPOLLOUT;
+
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
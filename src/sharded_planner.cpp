@@ -0,0 +1,278 @@
+// ================================================================================
+// ================================================================================
+// - File:    sharded_planner.cpp
+// - Purpose: Planner sharded over several PlannerStores, with parallel
+//            fan-out queries and a k-way merge of their results.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/sharded_planner.hpp"
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+uint64_t shard_hash(std::string_view key)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// ================================================================================
+// ================================================================================
+//   ShardedPlanner
+// ================================================================================
+
+ //   private:
+
+void ShardedPlanner::workerLoop()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_ready.wait(lock, [this] { return workers_stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+// --------------------------------------------------------------------------------
+
+int ShardedPlanner::fanOut(const std::function<int(size_t, DB&)>& query)
+{
+    if (shards.empty())
+        return SQLITE_MISUSE;
+
+    std::vector<int> codes(shards.size(), SQLITE_OK);
+    auto run = [&](size_t shard) {
+        PlannerStore::ReadLease lease = shards[shard]->reader();
+        codes[shard] = query(shard, lease.db());
+    };
+
+    // The caller takes the first shard itself instead of idling
+    std::mutex done_mutex;
+    std::condition_variable done;
+    size_t remaining = shards.size() - 1;
+    if (remaining > 0) {
+        {
+            std::lock_guard<std::mutex> lock(jobs_mutex);
+            for (size_t shard = 1; shard < shards.size(); shard++) {
+                jobs.push_back([&, shard] {
+                    run(shard);
+                    // Notified under the lock: the caller may return (and
+                    // destroy both) as soon as it sees remaining reach 0
+                    std::lock_guard<std::mutex> done_lock(done_mutex);
+                    if (--remaining == 0)
+                        done.notify_one();
+                });
+            }
+        }
+        jobs_ready.notify_all();
+    }
+    run(0);
+    {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+
+    for (int code : codes) {
+        if (code != SQLITE_OK)
+            return code;
+    }
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+void ShardedPlanner::merge(std::vector<std::vector<TaskRow>>& per_shard, size_t limit,
+                           std::vector<ShardTaskRow>& rows)
+{
+    struct Head {
+        OrderKey key;
+        int id;
+        size_t shard;
+        size_t index;
+
+        bool operator>(const Head& other) const
+        {
+            if (key != other.key)
+                return key > other.key;
+            if (id != other.id)
+                return id > other.id;
+            return shard > other.shard;
+        }
+    };
+    auto head = [&](size_t shard, size_t index) {
+        const TaskRow& row = per_shard[shard][index];
+        return Head{make_order_key(row.due_key, row.priority), row.id, shard, index};
+    };
+
+    // One entry per shard: the smallest row it has not handed out yet
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t shard = 0; shard < per_shard.size(); shard++) {
+        if (!per_shard[shard].empty())
+            heads.push(head(shard, 0));
+    }
+    while (!heads.empty() && rows.size() < limit) {
+        Head top = heads.top();
+        heads.pop();
+        rows.push_back(ShardTaskRow{top.shard, std::move(per_shard[top.shard][top.index])});
+        if (top.index + 1 < per_shard[top.shard].size())
+            heads.push(head(top.shard, top.index + 1));
+    }
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+ShardedPlanner::ShardedPlanner(const std::vector<std::string>& filenames, const ShardedPlannerOptions& options) :
+    workers_stopping(false)
+{
+    for (const std::string& filename : filenames) {
+        shards.push_back(std::make_unique<PlannerStore>(filename, options.store));
+    }
+
+    size_t threads = options.fanout_threads > 0 ? options.fanout_threads
+                                                : (shards.empty() ? 0 : shards.size() - 1);
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back(&ShardedPlanner::workerLoop, this);
+    }
+}
+// --------------------------------------------------------------------------------
+
+ShardedPlanner::~ShardedPlanner()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        workers_stopping = true;
+    }
+    jobs_ready.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    shards.clear();
+}
+// --------------------------------------------------------------------------------
+
+size_t ShardedPlanner::shardCount() const
+{
+    return shards.size();
+}
+// --------------------------------------------------------------------------------
+
+int ShardedPlanner::status() const
+{
+    for (const std::unique_ptr<PlannerStore>& store : shards) {
+        if (store->status() != SQLITE_OK)
+            return store->status();
+    }
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+PlannerStore& ShardedPlanner::shard(size_t index)
+{
+    return *shards[index];
+}
+// --------------------------------------------------------------------------------
+
+size_t ShardedPlanner::shardFor(std::string_view key) const
+{
+    return static_cast<size_t>(shard_hash(key) % shards.size());
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> ShardedPlanner::insertTask(std::string task, std::string due_date, std::string_view project,
+                                            size_t* shard)
+{
+    size_t owner = shardFor(project.empty() ? std::string_view(task) : project);
+    if (shard)
+        *shard = owner;
+    return shards[owner]->insertTask(std::move(task), std::move(due_date));
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> ShardedPlanner::completeTask(size_t shard, int id)
+{
+    return shards[shard]->completeTask(id);
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> ShardedPlanner::updatePlanner(size_t shard, UpdateRow updated_row)
+{
+    return shards[shard]->updatePlanner(std::move(updated_row));
+}
+// --------------------------------------------------------------------------------
+
+int ShardedPlanner::nextTasks(int count, std::vector<ShardTaskRow>& rows)
+{
+    // The global first count are among each shard's first count
+    std::vector<std::vector<TaskRow>> per_shard(shards.size());
+    int rc = fanOut([&](size_t shard, DB& db) { return db.nextTasks(count, per_shard[shard]); });
+    if (rc != SQLITE_OK)
+        return rc;
+    merge(per_shard, count > 0 ? static_cast<size_t>(count) : 0, rows);
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int ShardedPlanner::tasksDueBetween(DueKey from, DueKey to, std::vector<ShardTaskRow>& rows)
+{
+    std::vector<std::vector<TaskRow>> per_shard(shards.size());
+    int rc = fanOut([&](size_t shard, DB& db) { return db.tasksDueBetween(from, to, per_shard[shard]); });
+    if (rc != SQLITE_OK)
+        return rc;
+    merge(per_shard, SIZE_MAX, rows);
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+int ShardedPlanner::overdueTasks(DueKey as_of, std::vector<ShardTaskRow>& rows)
+{
+    std::vector<std::vector<TaskRow>> per_shard(shards.size());
+    int rc = fanOut([&](size_t shard, DB& db) { return db.overdueTasks(as_of, per_shard[shard]); });
+    if (rc != SQLITE_OK)
+        return rc;
+    merge(per_shard, SIZE_MAX, rows);
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+long long ShardedPlanner::countTasks()
+{
+    std::vector<long long> counts(shards.size(), 0);
+    int rc = fanOut([&](size_t shard, DB& db) {
+        counts[shard] = db.countTasks();
+        return counts[shard] < 0 ? SQLITE_ERROR : SQLITE_OK;
+    });
+    if (rc != SQLITE_OK)
+        return -1;
+    long long total = 0;
+    for (long long count : counts) {
+        total += count;
+    }
+    return total;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
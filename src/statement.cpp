@@ -0,0 +1,157 @@
+// ================================================================================
+// ================================================================================
+// - File:    statement.cpp
+// - Purpose: RAII prepared statement handles and the statement cache.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/statement.hpp"
+#include "include/metrics.hpp"
+#include <string>
+#include <sqlite3.h>
+
+// ================================================================================
+// ================================================================================
+
+Statement::Statement() : stmt(nullptr), in_use(nullptr)
+{
+}
+// --------------------------------------------------------------------------------
+
+Statement::Statement(sqlite3_stmt* stmt, bool* in_use) : stmt(stmt), in_use(in_use)
+{
+}
+// --------------------------------------------------------------------------------
+
+Statement::Statement(Statement&& other) noexcept : stmt(other.stmt), in_use(other.in_use)
+{
+    other.stmt = nullptr;
+    other.in_use = nullptr;
+}
+// --------------------------------------------------------------------------------
+
+Statement& Statement::operator=(Statement&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        stmt = other.stmt;
+        in_use = other.in_use;
+        other.stmt = nullptr;
+        other.in_use = nullptr;
+    }
+    return *this;
+}
+// --------------------------------------------------------------------------------
+
+Statement::~Statement()
+{
+    release();
+}
+// --------------------------------------------------------------------------------
+
+sqlite3_stmt* Statement::get() const
+{
+    return stmt;
+}
+// --------------------------------------------------------------------------------
+
+Statement::operator bool() const
+{
+    return stmt != nullptr;
+}
+// --------------------------------------------------------------------------------
+
+void Statement::release()
+{
+    if (!stmt)
+        return;
+
+    PLANNER_TIMED(Finalize);
+    if (in_use) {
+        // Leave it clean for the next caller
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        *in_use = false;
+    }
+    else {
+        sqlite3_finalize(stmt);
+    }
+    stmt = nullptr;
+    in_use = nullptr;
+}
+// ================================================================================
+// ================================================================================
+
+StatementCache::StatementCache() : hits(0), misses(0)
+{
+}
+// --------------------------------------------------------------------------------
+
+StatementCache::~StatementCache()
+{
+    clear();
+}
+// --------------------------------------------------------------------------------
+
+int StatementCache::acquire(sqlite3* db, const std::string& sql, Statement& statement)
+{
+    auto it = entries.find(sql);
+    if (it != entries.end() && !it->second.in_use) {
+        hits++;
+        PLANNER_COUNT(StatementCacheHits, 1);
+        it->second.in_use = true;
+        statement = Statement(it->second.stmt, &it->second.in_use);
+        return SQLITE_OK;
+    }
+
+    misses++;
+    PLANNER_COUNT(StatementCacheMisses, 1);
+    bool cacheable = (it == entries.end() && entries.size() < MAX_ENTRIES);
+    sqlite3_stmt* stmt = nullptr;
+    int rc;
+    {
+        PLANNER_TIMED(Prepare);
+        rc = sqlite3_prepare_v3(db, sql.c_str(), static_cast<int>(sql.size()),
+                                cacheable ? SQLITE_PREPARE_PERSISTENT : 0, &stmt, NULL);
+    }
+    if (rc != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        statement = Statement();
+        return rc;
+    }
+
+    if (cacheable) {
+        Entry& entry = entries[sql];
+        entry.stmt = stmt;
+        entry.in_use = true;
+        statement = Statement(stmt, &entry.in_use);
+    }
+    else {
+        statement = Statement(stmt, nullptr);
+    }
+    return SQLITE_OK;
+}
+// --------------------------------------------------------------------------------
+
+void StatementCache::clear()
+{
+    for (auto& [sql, entry] : entries) {
+        sqlite3_finalize(entry.stmt);
+    }
+    entries.clear();
+}
+// --------------------------------------------------------------------------------
+
+StatementCacheStats StatementCache::stats() const
+{
+    return StatementCacheStats{hits, misses, entries.size()};
+}
+// ================================================================================
+// ================================================================================
+//eof
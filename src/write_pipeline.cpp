@@ -0,0 +1,225 @@
+// ================================================================================
+// ================================================================================
+// - File:    write_pipeline.cpp
+// - Purpose: Group-commit write pipeline.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "include/write_pipeline.hpp"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static int bucket_for(uint64_t value)
+{
+    int bucket = 0;
+    while (value > 1 && bucket < WritePipelineMetrics::BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+// --------------------------------------------------------------------------------
+
+void WritePipeline::writerLoop()
+{
+    while (true) {
+        std::deque<Mutation> group;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+
+            // Hold the first mutation back briefly so others can join its group
+            auto deadline = std::chrono::steady_clock::now() + options.max_delay;
+            while (options.max_delay.count() > 0 && queue.size() < options.max_batch_size && !stopping) {
+                if (queue_ready.wait_until(lock, deadline) == std::cv_status::timeout)
+                    break;
+            }
+
+            size_t count = std::min(queue.size(), options.max_batch_size);
+            for (size_t i = 0; i < count; i++) {
+                group.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        commitGroup(group);
+    }
+}
+// --------------------------------------------------------------------------------
+
+void WritePipeline::commitGroup(std::deque<Mutation>& group)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> results(group.size(), SQLITE_OK);
+    std::vector<std::exception_ptr> errors(group.size());
+    uint64_t failed = 0;
+
+    int rc = db.beginTransaction();
+    for (size_t i = 0; i < group.size(); i++) {
+        if (rc != SQLITE_OK) {
+            results[i] = rc;
+            continue;
+        }
+
+        // Each mutation gets its own savepoint so one failure does not sink
+        // the rest of the group
+        int mutation_rc = db.beginTransaction();
+        if (mutation_rc == SQLITE_OK) {
+            try {
+                mutation_rc = group[i].apply(db);
+            } catch (...) {
+                errors[i] = std::current_exception();
+                mutation_rc = SQLITE_ERROR;
+            }
+            if (mutation_rc == SQLITE_OK)
+                mutation_rc = db.commitTransaction();
+            else
+                db.rollbackTransaction();
+        }
+        results[i] = mutation_rc;
+    }
+
+    bool committed = false;
+    if (rc == SQLITE_OK) {
+        rc = db.commitTransaction();
+        if (rc == SQLITE_OK) {
+            committed = true;
+        }
+        else {
+            std::cerr << "Error committing write group: " << sqlite3_errmsg(db.db) << std::endl;
+            db.rollbackTransaction();
+        }
+    }
+
+    double commit_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < group.size(); i++) {
+        if (!committed && results[i] == SQLITE_OK) {
+            results[i] = rc;
+        }
+        if (results[i] != SQLITE_OK) {
+            failed++;
+        }
+    }
+
+    // Recorded before any future resolves, so a caller that has its result
+    // also sees its group in metrics()
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats.batches++;
+        stats.mutations += group.size();
+        stats.failed_mutations += failed;
+        stats.failed_commits += committed ? 0 : 1;
+        stats.batch_sizes[bucket_for(group.size())]++;
+        stats.commit_latency_us[bucket_for(static_cast<uint64_t>(commit_us))]++;
+        stats.total_commit_us += commit_us;
+        stats.max_commit_us = std::max(stats.max_commit_us, commit_us);
+    }
+
+    for (size_t i = 0; i < group.size(); i++) {
+        if (errors[i])
+            group[i].result.set_exception(errors[i]);
+        else
+            group[i].result.set_value(results[i]);
+    }
+}
+// --------------------------------------------------------------------------------
+// --------------------------------------------------------------------------------
+
+
+ //   public:
+
+WritePipeline::WritePipeline(DB& db, const WritePipelineOptions& options) :
+    db(db),
+    options(options),
+    stopping(false),
+    stats{}
+{
+    if (this->options.max_batch_size == 0) {
+        this->options.max_batch_size = 1;
+    }
+
+    const char* synchronous = "NORMAL";
+    if (options.durability == Durability::None)
+        synchronous = "OFF";
+    else if (options.durability == Durability::Full)
+        synchronous = "FULL";
+    std::string sql = std::string("PRAGMA synchronous=") + synchronous + ";";
+    if (db.db) {
+        sqlite3_exec(db.db, sql.c_str(), NULL, NULL, NULL);
+    }
+
+    writer_thread = std::thread(&WritePipeline::writerLoop, this);
+}
+// --------------------------------------------------------------------------------
+
+WritePipeline::~WritePipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_ready.notify_one();
+    writer_thread.join();
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> WritePipeline::submit(std::function<int(DB&)> mutation)
+{
+    Mutation item{std::move(mutation), std::promise<int>()};
+    std::future<int> result = item.result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue.push_back(std::move(item));
+    }
+    queue_ready.notify_one();
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> WritePipeline::insertTask(std::string task, std::string due_date)
+{
+    return submit([task = std::move(task), due_date = std::move(due_date)](DB& db) mutable {
+        return db.insertTask(task, due_date);
+    });
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> WritePipeline::completeTask(int id)
+{
+    return submit([id](DB& db) {
+        return db.completeTask(id);
+    });
+}
+// --------------------------------------------------------------------------------
+
+std::future<int> WritePipeline::updatePlanner(UpdateRow updated_row)
+{
+    return submit([updated_row = std::move(updated_row)](DB& db) mutable {
+        return db.updatePlanner(updated_row);
+    });
+}
+// --------------------------------------------------------------------------------
+
+WritePipelineMetrics WritePipeline::metrics() const
+{
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats;
+}
+// ================================================================================
+// ================================================================================
+//eof
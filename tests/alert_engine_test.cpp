@@ -0,0 +1,249 @@
+// ================================================================================
+// ================================================================================
+// - File:    alert_engine_test.cpp
+// - Purpose: The AlertEngine's hierarchical timing wheel: alerts fire on
+//            their exact minute across every level's cascade, and cancelled,
+//            rescheduled and past-due alerts behave.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/alert_engine.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// An arbitrary start that is not aligned to any level of the wheel.
+static const int64_t START = 29000000 + 12345;
+// --------------------------------------------------------------------------------
+
+// An AlertEngine on an empty planner that records what it fires.
+struct AlertFixture {
+    TempDir dir;
+    DB db;
+    std::vector<Alert> fired;
+    AlertEngine engine;
+
+    explicit AlertFixture(const AlertOptions& options = AlertOptions()) :
+        db(dir.file("planner.db"), test_db_options()),
+        engine(prepare(db), [this](const Alert& alert) { fired.push_back(alert); }, START, options)
+    {
+    }
+
+    static DB& prepare(DB& db)
+    {
+        db.createPlanner();
+        return db;
+    }
+};
+// --------------------------------------------------------------------------------
+
+static std::string due_at(int64_t minute)
+{
+    return format_due_key(due_key_from_minutes(minute));
+}
+// --------------------------------------------------------------------------------
+
+TEST(alert_engine, fires_on_the_exact_minute_at_every_level)
+{
+    AlertFixture fixture;
+
+    // Offsets on each side of every level boundary (64^1 .. 64^5 minutes)
+    // plus a few years out, so timers cascade through each level
+    std::vector<int64_t> offsets = {1, 2, 63, 64, 65};
+    for (int level = 2; level <= 5; level++) {
+        int64_t span = int64_t(1) << (6 * level);
+        for (int64_t delta : {-1, 0, 1, 77}) {
+            offsets.push_back(span + delta);
+        }
+    }
+    offsets.push_back(3LL * 365 * 1440 + 17);
+
+    std::map<int, int64_t> expected;
+    int id = 1;
+    for (int64_t offset : offsets) {
+        // Also offset from a wheel-aligned "now + offset" and its neighbour
+        for (int64_t shift : {int64_t(0), int64_t(1)}) {
+            int64_t minute = START + offset + shift;
+            fixture.engine.schedule(id, due_key_from_minutes(minute));
+            expected[id] = minute;
+            id++;
+        }
+    }
+    CHECK_EQ(fixture.engine.pending(), expected.size());
+
+    // Advance in uneven steps so cascades happen both mid-step and at the
+    // end of one
+    int64_t end = START + *std::max_element(offsets.begin(), offsets.end()) + 2;
+    int64_t step = 1;
+    while (fixture.engine.currentMinute() < end) {
+        fixture.engine.advance(std::min(end, fixture.engine.currentMinute() + step));
+        step = step * 3 + 1;
+        if (step > 5000000)
+            step = 7;
+    }
+
+    CHECK_EQ(fixture.engine.pending(), static_cast<size_t>(0));
+    REQUIRE(fixture.fired.size() == expected.size());
+    int64_t previous = 0;
+    for (const Alert& alert : fixture.fired) {
+        CHECK_EQ(alert.minute, expected[alert.id]);
+        CHECK_EQ(alert.due_key, due_key_from_minutes(expected[alert.id]));
+        CHECK(alert.minute >= previous);
+        previous = alert.minute;
+    }
+}
+// --------------------------------------------------------------------------------
+
+TEST(alert_engine, matches_a_reference_on_random_timers)
+{
+    AlertOptions options;
+    options.lead_minutes = {0, 15, 60, 15, -5};       // duplicates and negatives dropped
+    AlertFixture fixture(options);
+
+    std::multimap<int64_t, std::pair<int, int>> expected;     // minute -> ID, lead
+    uint64_t state = 4242;
+    for (int id = 1; id <= 3000; id++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t due = START + static_cast<int64_t>((state >> 30) % 400000);
+        fixture.engine.schedule(id, due_key_from_minutes(due));
+        for (int lead : {0, 15, 60}) {
+            if (due - lead > START)
+                expected.emplace(due - lead, std::make_pair(id, lead));
+        }
+    }
+    CHECK_EQ(fixture.engine.pending(), expected.size());
+
+    int64_t minute = START;
+    while (minute < START + 400001) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        minute += static_cast<int64_t>((state >> 40) % 9000) + 1;
+        fixture.engine.advance(minute);
+    }
+    REQUIRE(fixture.fired.size() == expected.size());
+
+    // Within one minute the order is unspecified; compare sorted per minute
+    std::vector<std::pair<int64_t, std::pair<int, int>>> want(expected.begin(), expected.end());
+    std::vector<std::pair<int64_t, std::pair<int, int>>> got;
+    for (const Alert& alert : fixture.fired) {
+        got.emplace_back(alert.minute, std::make_pair(alert.id, alert.lead_minutes));
+    }
+    CHECK(std::is_sorted(got.begin(), got.end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; }));
+    std::sort(want.begin(), want.end());
+    std::sort(got.begin(), got.end());
+    CHECK(got == want);
+}
+// --------------------------------------------------------------------------------
+
+TEST(alert_engine, cancel_and_reschedule_armed_alerts)
+{
+    AlertOptions options;
+    options.lead_minutes = {0, 30};
+    AlertFixture fixture(options);
+
+    // Far enough out to sit on an upper level of the wheel
+    int64_t far = START + 100000;
+    fixture.engine.schedule(1, due_key_from_minutes(far));
+    fixture.engine.schedule(2, due_key_from_minutes(far));
+    fixture.engine.schedule(3, due_key_from_minutes(far + 10));
+    CHECK_EQ(fixture.engine.pending(), static_cast<size_t>(6));
+
+    // Part way there, so the timers have already cascaded down a level
+    fixture.engine.advance(far - 5000);
+    fixture.engine.cancel(2);
+    fixture.engine.cancel(2);
+    fixture.engine.cancel(99);
+    CHECK_EQ(fixture.engine.pending(), static_cast<size_t>(4));
+
+    // Moved earlier, later, and to a time whose early alert has passed
+    fixture.engine.schedule(1, due_key_from_minutes(far - 4000));
+    fixture.engine.schedule(3, due_key_from_minutes(far + 70000));
+    CHECK_EQ(fixture.engine.pending(), static_cast<size_t>(4));
+
+    fixture.engine.advance(far + 100000);
+    std::vector<std::pair<int, int64_t>> fired;
+    for (const Alert& alert : fixture.fired) {
+        fired.emplace_back(alert.id, alert.minute);
+    }
+    std::vector<std::pair<int, int64_t>> expected = {
+        {1, far - 4030}, {1, far - 4000}, {3, far + 69970}, {3, far + 70000}};
+    CHECK(fired == expected);
+    CHECK_EQ(fixture.engine.pending(), static_cast<size_t>(0));
+}
+// --------------------------------------------------------------------------------
+
+TEST(alert_engine, past_due_alerts_are_skipped)
+{
+    AlertOptions options;
+    options.lead_minutes = {0, 60};
+    AlertFixture fixture(options);
+
+    fixture.engine.schedule(1, due_key_from_minutes(START - 1000));     // long overdue
+    fixture.engine.schedule(2, due_key_from_minutes(START));            // due right now
+    fixture.engine.schedule(3, due_key_from_minutes(START + 30));       // the early alert has passed
+    fixture.engine.schedule(4, INVALID_DUE_KEY);
+    CHECK_EQ(fixture.engine.pending(), static_cast<size_t>(1));
+
+    fixture.engine.advance(START + 10000);
+    REQUIRE(fixture.fired.size() == 1);
+    CHECK_EQ(fixture.fired[0].id, 3);
+    CHECK_EQ(fixture.fired[0].lead_minutes, 0);
+
+    // Moving the clock backwards is a no-op, and nothing fires twice
+    CHECK_EQ(fixture.engine.advance(START), static_cast<size_t>(0));
+    CHECK_EQ(fixture.engine.currentMinute(), START + 10000);
+}
+// --------------------------------------------------------------------------------
+
+TEST(alert_engine, fire_may_change_the_planner)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    REQUIRE(insert_task(db, "a", due_at(START + 10)) > 0);
+    REQUIRE(insert_task(db, "b", due_at(START + 10)) > 0);
+
+    // Completing the task from inside fire cancels its later alerts; the
+    // other task's alert in the same slot still fires
+    std::vector<Alert> fired;
+    AlertOptions options;
+    options.lead_minutes = {0, 5};
+    AlertEngine engine(db, [&](const Alert& alert) {
+        fired.push_back(alert);
+        db.completeTask(alert.id);
+    }, START, options);
+    CHECK_EQ(engine.pending(), static_cast<size_t>(4));
+
+    // Inserts and updates through the DB reach the engine
+    int c = insert_task(db, "c", due_at(START + 100));
+    REQUIRE(c > 0);
+    UpdateRow move{"DUE_DATE", format_due_key(due_key_from_minutes(START + 200)), "ID", std::to_string(c)};
+    REQUIRE(db.updatePlanner(move) == SQLITE_OK);
+    CHECK_EQ(engine.pending(), static_cast<size_t>(6));
+
+    engine.advance(START + 1000);
+    REQUIRE(fired.size() == 3);
+    CHECK_EQ(fired[0].minute, START + 5);
+    CHECK_EQ(fired[1].minute, START + 5);
+    CHECK(fired[0].id != fired[1].id);
+    CHECK_EQ(fired[2].id, c);
+    CHECK_EQ(fired[2].minute, START + 195);
+    CHECK_EQ(engine.pending(), static_cast<size_t>(0));
+    CHECK_EQ(db.countTasks(), 0LL);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
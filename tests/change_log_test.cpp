@@ -0,0 +1,168 @@
+// ================================================================================
+// ================================================================================
+// - File:    change_log_test.cpp
+// - Purpose: The trigger-maintained change log: how changesSince folds a
+//            span of changes, pruning, and PlannerSnapshot following writes
+//            made through another connection.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/planner_snapshot.hpp"
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static int update(DB& db, int id, const std::string& column, const std::string& value)
+{
+    UpdateRow row{column, value, "ID", std::to_string(id)};
+    return db.updatePlanner(row);
+}
+// --------------------------------------------------------------------------------
+
+TEST(change_log, folds_each_task_to_its_net_change)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    CHECK_EQ(db.changeSequence(), 0LL);
+
+    REQUIRE(insert_task(db, "untouched", "2026-10-18") > 0);
+    int edited = insert_task(db, "edited", "2026-10-18");
+    int done = insert_task(db, "done", "2026-10-18");
+    int edited_then_done = insert_task(db, "edited then done", "2026-10-18");
+    int64_t since = db.changeSequence();
+    CHECK_EQ(since, 4LL);
+
+    int added = insert_task(db, "added", "2026-10-19");
+    int added_then_edited = insert_task(db, "added then edited", "2026-10-19");
+    int added_then_done = insert_task(db, "added then done", "2026-10-19");
+    REQUIRE(update(db, edited, "TASK", "edited twice") == SQLITE_OK);
+    REQUIRE(update(db, edited, "DUE_DATE", "2026-10-20") == SQLITE_OK);
+    REQUIRE(db.setPriority(edited_then_done, 3) == SQLITE_OK);
+    REQUIRE(db.completeTask(edited_then_done) == SQLITE_OK);
+    REQUIRE(db.completeTask(done) == SQLITE_OK);
+    REQUIRE(update(db, added_then_edited, "DUE_DATE", "2026-10-21") == SQLITE_OK);
+    REQUIRE(db.completeTask(added_then_done) == SQLITE_OK);
+    // An update that matches no row logs nothing
+    REQUIRE(update(db, 9999, "TASK", "nobody") == SQLITE_OK);
+
+    ChangeSet changes;
+    REQUIRE(db.changesSince(since, changes) == SQLITE_OK);
+    CHECK(changes.complete);
+    CHECK_EQ(changes.sequence, db.changeSequence());
+    CHECK(changes.inserted == std::vector<int>({added, added_then_edited}));
+    CHECK(changes.updated == std::vector<int>({edited}));
+    CHECK(changes.completed == std::vector<int>({done, edited_then_done}));
+
+    // Nothing since the latest sequence
+    REQUIRE(db.changesSince(changes.sequence, changes) == SQLITE_OK);
+    CHECK(changes.complete);
+    CHECK(changes.inserted.empty() && changes.updated.empty() && changes.completed.empty());
+}
+// --------------------------------------------------------------------------------
+
+TEST(change_log, pruned_or_future_spans_are_incomplete)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(insert_task(db, "t", "2026-10-18") > 0);
+    }
+
+    int pruned = 0;
+    REQUIRE(db.pruneChanges(3, &pruned) == SQLITE_OK);
+    CHECK_EQ(pruned, 3);
+
+    ChangeSet changes;
+    REQUIRE(db.changesSince(1, changes) == SQLITE_OK);
+    CHECK(!changes.complete);
+    // Exactly at the pruned point still reaches back far enough
+    REQUIRE(db.changesSince(3, changes) == SQLITE_OK);
+    CHECK(changes.complete);
+    CHECK_EQ(changes.inserted.size(), static_cast<size_t>(2));
+    // A sequence from the future (a restored backup) cannot be followed
+    REQUIRE(db.changesSince(50, changes) == SQLITE_OK);
+    CHECK(!changes.complete);
+
+    // The sequence survives a prune of the whole log
+    REQUIRE(db.pruneChanges(5) == SQLITE_OK);
+    CHECK_EQ(db.changeSequence(), 5LL);
+    REQUIRE(db.changesSince(5, changes) == SQLITE_OK);
+    CHECK(changes.complete);
+}
+// --------------------------------------------------------------------------------
+
+TEST(change_log, snapshot_follows_another_connection)
+{
+    TempDir dir;
+    DB reader(dir.file("planner.db"), test_db_options());
+    REQUIRE(reader.createPlanner() == SQLITE_OK);
+    int first = insert_task(reader, "first", "2026-10-18");
+    int second = insert_task(reader, "second", "2026-10-19");
+
+    PlannerSnapshot snapshot(reader);
+    REQUIRE(snapshot.size() == 2);
+    CHECK_EQ(snapshot.catchUp(), SQLITE_OK);
+
+    DB writer(dir.file("planner.db"), test_db_options());
+    REQUIRE(writer.completeTask(first) == SQLITE_OK);
+    REQUIRE(update(writer, second, "DUE_DATE", "2026-10-17") == SQLITE_OK);
+    int third = insert_task(writer, "third", "2026-10-16");
+
+    REQUIRE(snapshot.catchUp() == SQLITE_OK);
+    CHECK_EQ(snapshot.size(), static_cast<size_t>(2));
+    SnapshotRow row;
+    CHECK(!snapshot.find(first, row));
+    REQUIRE(snapshot.next(row));
+    CHECK_EQ(row.id, third);
+    CHECK_EQ(snapshot.verify(reader), static_cast<size_t>(0));
+
+    // After the log is pruned past the snapshot, it reloads instead
+    insert_task(writer, "fourth", "2026-10-15");
+    REQUIRE(writer.pruneChanges(writer.changeSequence()) == SQLITE_OK);
+    REQUIRE(snapshot.catchUp() == SQLITE_OK);
+    CHECK_EQ(snapshot.size(), static_cast<size_t>(3));
+    CHECK_EQ(snapshot.verify(reader), static_cast<size_t>(0));
+}
+// --------------------------------------------------------------------------------
+
+TEST(change_log, snapshot_reads_one_row_for_an_unknown_id)
+{
+    TempDir dir;
+    DB reader(dir.file("planner.db"), test_db_options());
+    REQUIRE(reader.createPlanner() == SQLITE_OK);
+    PlannerSnapshot snapshot(reader);
+
+    DB writer(dir.file("planner.db"), test_db_options());
+    int updated = insert_task(writer, "updated here", "2026-10-18");
+    int untouched = insert_task(writer, "left for catchUp", "2026-10-19");
+
+    // Updating a row the snapshot has not seen yet brings in that row
+    // alone; a reload would have brought both
+    REQUIRE(update(reader, updated, "TASK", "renamed") == SQLITE_OK);
+    SnapshotRow row;
+    REQUIRE(snapshot.find(updated, row));
+    CHECK_EQ(std::string(row.task), std::string("renamed"));
+    CHECK(!snapshot.find(untouched, row));
+
+    // An ID that is nowhere changes nothing
+    REQUIRE(update(reader, 999, "TASK", "ghost") == SQLITE_OK);
+    CHECK_EQ(snapshot.size(), static_cast<size_t>(1));
+
+    REQUIRE(snapshot.catchUp() == SQLITE_OK);
+    CHECK_EQ(snapshot.size(), static_cast<size_t>(2));
+    CHECK_EQ(snapshot.verify(reader), static_cast<size_t>(0));
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
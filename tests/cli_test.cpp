@@ -0,0 +1,175 @@
+// ================================================================================
+// ================================================================================
+// - File:    cli_test.cpp
+// - Purpose: Batch line splitting, single subcommands through run_command and
+//            the all-or-nothing batch mode, output included.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/cli.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Runs one command line against db and returns its exit code, leaving the
+// TSV output in output.
+static int run(DB& db, const std::string& line, std::string& output)
+{
+    std::ostringstream stream;
+    int result;
+    {
+        RowWriter out(stream, OutputFormat::Tsv);
+        result = run_command(db, split_command_line(line), out);
+    }
+    output = stream.str();
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+static int run_lines(DB& db, const std::string& lines, std::string& output)
+{
+    std::ostringstream stream;
+    std::istringstream in(lines);
+    int result;
+    {
+        RowWriter out(stream, OutputFormat::Tsv);
+        result = run_batch(db, in, out);
+    }
+    output = stream.str();
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+TEST(cli, split_command_line_quotes_and_comments)
+{
+    std::vector<std::string> plain = {"add", "Buy milk", "2026-10-18"};
+    CHECK(split_command_line("add \"Buy milk\"\t2026-10-18\r") == plain);
+
+    // Escapes only inside quotes; quotes may join a word's parts
+    std::vector<std::string> escaped = {"add", "say \"hi\" \\ bye", "a\\b"};
+    CHECK(split_command_line("add \"say \\\"hi\\\" \\\\ bye\" a\\b") == escaped);
+    std::vector<std::string> joined = {"pre fix", ""};
+    CHECK(split_command_line("pre\" fix\" \"\"") == joined);
+
+    // # starts a comment only at the start of a word
+    std::vector<std::string> commented = {"add", "task#1", "#2"};
+    CHECK(split_command_line("add task#1 \"#2\" # the rest") == commented);
+    CHECK(split_command_line("   # only a comment").empty());
+    CHECK(split_command_line("").empty());
+
+    // An unclosed quote runs to the end of the line
+    std::vector<std::string> unclosed = {"add", "open ended"};
+    CHECK(split_command_line("add \"open ended") == unclosed);
+}
+// --------------------------------------------------------------------------------
+
+TEST(cli, run_command_adds_updates_and_reads)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    std::string output;
+    CHECK_EQ(run(db, "add \"Pay rent\" 2026-10-20", output), 0);
+    CHECK_EQ(output, std::string("1\n"));
+    CHECK_EQ(run(db, "add \"Call\tMom\" 2026-10-20 7", output), 0);
+    CHECK_EQ(output, std::string("2\n"));
+
+    // Priority first on the same day, then the TSV row shows it
+    CHECK_EQ(run(db, "next 2", output), 0);
+    CHECK_EQ(output, std::string("2\tCall\\tMom\t2026-10-20\t7\n1\tPay rent\t2026-10-20\t0\n"));
+
+    CHECK_EQ(run(db, "update 1 priority 9", output), 0);
+    CHECK_EQ(output, std::string("1\n"));
+    CHECK_EQ(run(db, "update 1 due_date 2026-10-19", output), 0);
+    CHECK_EQ(run(db, "range 2026-10-19 2026-10-20", output), 0);
+    CHECK_EQ(output, std::string("1\tPay rent\t2026-10-19\t9\n"));
+
+    CHECK_EQ(run(db, "complete 1 2 3", output), 0);
+    CHECK_EQ(output, std::string("2\n"));
+    CHECK_EQ(db.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(cli, run_command_rejects_bad_input)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    // 2 for usage, 1 for a value or database problem
+    std::string output;
+    CHECK_EQ(run(db, "frobnicate", output), 2);
+    CHECK_EQ(run(db, "add only-a-task", output), 2);
+    CHECK_EQ(run(db, "update 1 colour red", output), 2);
+    CHECK_EQ(run(db, "add task 2026-13-01", output), 1);
+    CHECK_EQ(run(db, "add task 2026-10-18 256", output), 1);
+    CHECK_EQ(run(db, "complete one", output), 1);
+    CHECK_EQ(run(db, "next many", output), 2);
+    CHECK(output.empty());
+    CHECK_EQ(db.countTasks(), 0LL);
+
+    // Blank and comment-only lines do nothing
+    CHECK_EQ(run(db, "# nothing", output), 0);
+}
+// --------------------------------------------------------------------------------
+
+TEST(cli, run_batch_commits_and_shows_everything)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    std::string output;
+    CHECK_EQ(run_lines(db,
+                       "# weekly chores\n"
+                       "add laundry 2026-10-18\n"
+                       "\n"
+                       "add dishes 2026-10-17 3\n"
+                       "complete 1\n"
+                       "list\n",
+                       output), 0);
+    CHECK_EQ(output, std::string("1\n2\n1\n2\tdishes\t2026-10-17\t3\n"));
+    CHECK_EQ(db.countTasks(), 1LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(cli, a_failed_batch_changes_and_shows_nothing)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    std::vector<Task> tasks;
+    for (int i = 0; i < 2000; i++) {
+        tasks.push_back(Task{"a task with a long enough description " + std::to_string(i), "2026-10-18"});
+    }
+    REQUIRE(db.bulkInsertTasks(tasks) == SQLITE_OK);
+
+    // Far more output than the writer buffers before flushing, then a bad line
+    std::string output;
+    CHECK_EQ(run_lines(db, "add kept? 2026-10-19\nlist\nlist\nadd broken 2026-02-30\n", output), 1);
+    CHECK(output.empty());
+    CHECK_EQ(db.countTasks(), 2000LL);
+
+    CHECK_EQ(run_lines(db, "add first 2026-10-19\nbatch nested.txt\n", output), 2);
+    CHECK(output.empty());
+    CHECK_EQ(db.countTasks(), 2000LL);
+
+    // The connection is usable afterwards, outside any transaction
+    CHECK_EQ(run(db, "add after 2026-10-20", output), 0);
+    CHECK_EQ(db.countTasks(), 2001LL);
+    CHECK(sqlite3_get_autocommit(db.db) != 0);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
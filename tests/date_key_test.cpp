@@ -0,0 +1,154 @@
+// ================================================================================
+// ================================================================================
+// - File:    date_key_test.cpp
+// - Purpose: Parsing, formatting and minute arithmetic of DueKey.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/date_key.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+TEST(date_key, parses_dates_and_times)
+{
+    CHECK_EQ(parse_due_key("2026-10-18"), 202610180000LL);
+    CHECK_EQ(parse_due_key("2026-10-18T09:30"), 202610180930LL);
+    CHECK_EQ(parse_due_key("2026-10-18 23:59"), 202610182359LL);
+    CHECK_EQ(parse_due_key("2024-02-29"), 202402290000LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(date_key, rejects_invalid_dates)
+{
+    CHECK_EQ(parse_due_key(""), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-1-18"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-13-01"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-00-10"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2025-02-29"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2100-02-29"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-04-31"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-10-18T24:00"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-10-18T09:60"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("2026-10-18X09:30"), INVALID_DUE_KEY);
+    CHECK_EQ(parse_due_key("not a date"), INVALID_DUE_KEY);
+}
+// --------------------------------------------------------------------------------
+
+TEST(date_key, keys_sort_like_dates)
+{
+    CHECK(parse_due_key("2026-10-18") < parse_due_key("2026-10-18T00:01"));
+    CHECK(parse_due_key("2026-10-18T23:59") < parse_due_key("2026-10-19"));
+    CHECK(parse_due_key("2026-12-31") < parse_due_key("2027-01-01"));
+    CHECK(parse_due_key("9999-12-31") < INVALID_DUE_KEY);
+}
+// --------------------------------------------------------------------------------
+
+TEST(date_key, formats_round_trip)
+{
+    CHECK_EQ(format_due_key(parse_due_key("2026-10-18")), std::string("2026-10-18"));
+    CHECK_EQ(format_due_key(parse_due_key("2026-10-18T09:05")), std::string("2026-10-18T09:05"));
+    CHECK_EQ(format_due_key(INVALID_DUE_KEY), std::string("invalid"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(date_key, minutes_round_trip)
+{
+    CHECK_EQ(due_key_to_minutes(parse_due_key("1970-01-01")), 0LL);
+    CHECK_EQ(due_key_to_minutes(parse_due_key("1970-01-02T01:01")), 1440LL + 61);
+    CHECK_EQ(days_from_civil(2000, 3, 1), 11017LL);
+    for (const char* text : {"2024-02-29T12:34", "1999-12-31T23:59", "2026-10-18"}) {
+        DueKey key = parse_due_key(text);
+        CHECK_EQ(due_key_from_minutes(due_key_to_minutes(key)), key);
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Byte-at-a-time check of "YYYY-MM-DD" for comparison with the word-at-a-time
+// parser.
+static bool reference_date(const std::string& text)
+{
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-')
+        return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (text[i] < '0' || text[i] > '9')
+            return false;
+    }
+    int year = std::stoi(text.substr(0, 4)), month = std::stoi(text.substr(5, 2)), day = std::stoi(text.substr(8, 2));
+    static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    return month >= 1 && month <= 12 && day >= 1 && day <= (month == 2 && leap ? 29 : days[month - 1]);
+}
+// --------------------------------------------------------------------------------
+
+TEST(date_key, every_byte_in_every_lane)
+{
+    // Each position of a valid date replaced by each of the 256 byte
+    // values: a carry out of one lane of the word must never let a bad
+    // byte through or reject a good one
+    const std::string base = "2028-02-29";
+    for (size_t position = 0; position < base.size(); position++) {
+        for (int byte = 0; byte < 256; byte++) {
+            std::string text = base;
+            text[position] = static_cast<char>(byte);
+            bool expected = reference_date(text);
+            bool parsed = parse_due_key(text) != INVALID_DUE_KEY;
+            if (parsed != expected) {
+                test_failure(__FILE__, __LINE__, "position " + std::to_string(position) +
+                             " byte " + std::to_string(byte) + (parsed ? " accepted" : " rejected"));
+            }
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+TEST(date_key, batch_matches_single_parses)
+{
+    // More than one chunk, so the batch is split across threads
+    std::vector<std::string> storage;
+    for (int i = 0; i < 200000; i++) {
+        if (i % 997 == 0)
+            storage.push_back("bad " + std::to_string(i));
+        else if (i % 1009 == 0)
+            storage.push_back("2026-02-3" + std::to_string(i % 10));
+        else
+            storage.push_back(format_due_key(due_key_from_minutes(29000000 + i * 7)));
+    }
+    std::vector<std::string_view> texts(storage.begin(), storage.end());
+
+    for (unsigned threads : {1u, 4u}) {
+        std::vector<DueKey> keys(texts.size());
+        std::vector<DateError> errors;
+        parse_due_keys(texts.data(), texts.size(), keys.data(), errors, threads);
+
+        size_t expected_errors = 0, mismatches = 0;
+        for (size_t i = 0; i < texts.size(); i++) {
+            DueKey expected = parse_due_key(texts[i]);
+            if (keys[i] != expected)
+                mismatches++;
+            if (expected == INVALID_DUE_KEY) {
+                // Errors arrive in input order with their text
+                if (expected_errors < errors.size()) {
+                    CHECK_EQ(errors[expected_errors].index, i);
+                    CHECK_EQ(errors[expected_errors].text, storage[i]);
+                }
+                expected_errors++;
+            }
+        }
+        CHECK_EQ(mismatches, static_cast<size_t>(0));
+        CHECK_EQ(errors.size(), expected_errors);
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,269 @@
+// ================================================================================
+// ================================================================================
+// - File:    db_test.cpp
+// - Purpose: Insert, update, complete and read-back round trips through DB
+//            on a fresh planner in a temporary directory.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/date_key.hpp"
+#include "../src/include/schema.hpp"
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Records what it hears, so a test can check what was delivered and when.
+class Recorder : public PlannerObserver
+{
+    public:
+
+        std::vector<int> inserted;
+        std::vector<int> completed;
+        int updated = 0;
+// --------------------------------------------------------------------------------
+
+        void taskInserted(int id, const std::string&, const std::string&, int) override { inserted.push_back(id); }
+        void taskCompleted(int id) override { completed.push_back(id); }
+        void plannerUpdated(const UpdateRow&) override { updated++; }
+};
+// --------------------------------------------------------------------------------
+
+TEST(db, creates_the_latest_schema)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+    CHECK_EQ(db.countTasks(), 0LL);
+
+    // A second call on an up-to-date planner is a no-op
+    CHECK_EQ(db.createPlanner(), SQLITE_OK);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, insert_and_read_back)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    int later = insert_task(db, "File taxes", "2026-10-20");
+    int sooner = insert_task(db, "Pay rent", "2026-10-18T09:00");
+    int broken = insert_task(db, "Someday", "whenever");
+    REQUIRE(later > 0 && sooner > 0 && broken > 0);
+    CHECK(later != sooner && sooner != broken);
+    CHECK_EQ(db.countTasks(), 3LL);
+
+    std::vector<TaskRow> rows;
+    REQUIRE(db.nextTasks(10, rows) == SQLITE_OK);
+    // A date that does not parse has no order key and is never "next"
+    REQUIRE(rows.size() == 2);
+    CHECK_EQ(rows[0].id, sooner);
+    CHECK_EQ(rows[0].task, std::string("Pay rent"));
+    CHECK_EQ(rows[0].due_key, parse_due_key("2026-10-18T09:00"));
+    CHECK_EQ(rows[1].id, later);
+
+    rows.clear();
+    REQUIRE(db.tasksById({broken}, rows) == SQLITE_OK);
+    REQUIRE(rows.size() == 1);
+    CHECK_EQ(rows[0].task, std::string("Someday"));
+    CHECK_EQ(rows[0].due_key, INVALID_DUE_KEY);
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, update_refreshes_the_due_key)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    int first = insert_task(db, "Dentist", "2026-11-02");
+    int second = insert_task(db, "Groceries", "2026-10-19");
+    REQUIRE(first > 0 && second > 0);
+
+    UpdateRow move{"DUE_DATE", "2026-10-18T08:00", "ID", std::to_string(first)};
+    REQUIRE(db.updatePlanner(move) == SQLITE_OK);
+    UpdateRow rename{"TASK", "Dentist (cleaning)", "ID", std::to_string(first)};
+    REQUIRE(db.updatePlanner(rename) == SQLITE_OK);
+
+    std::vector<TaskRow> rows;
+    REQUIRE(db.tasksById({first}, rows) == SQLITE_OK);
+    REQUIRE(rows.size() == 1);
+    CHECK_EQ(rows[0].task, std::string("Dentist (cleaning)"));
+    CHECK_EQ(rows[0].due_key, parse_due_key("2026-10-18T08:00"));
+
+    rows.clear();
+    REQUIRE(db.nextTasks(1, rows) == SQLITE_OK);
+    REQUIRE(rows.size() == 1);
+    CHECK_EQ(rows[0].id, first);
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, complete_keeps_the_other_ids)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    int a = insert_task(db, "A", "2026-10-18");
+    int b = insert_task(db, "B", "2026-10-19");
+    int c = insert_task(db, "C", "2026-10-20");
+    REQUIRE(a > 0 && b > 0 && c > 0);
+
+    REQUIRE(db.completeTask(b) == SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 2LL);
+
+    std::vector<TaskRow> rows;
+    REQUIRE(db.nextTasks(10, rows) == SQLITE_OK);
+    REQUIRE(rows.size() == 2);
+    CHECK_EQ(rows[0].id, a);
+    CHECK_EQ(rows[1].id, c);
+
+    int completed = -1;
+    REQUIRE(db.completeTasks({a, c, 9999}, &completed) == SQLITE_OK);
+    CHECK_EQ(completed, 2);
+    CHECK_EQ(db.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, completed_ids_are_never_reused)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    int a = insert_task(db, "A", "2026-10-18");
+    int b = insert_task(db, "B", "2026-10-19");
+    REQUIRE(db.completeTask(b) == SQLITE_OK);
+    int c = insert_task(db, "C", "2026-10-20");
+    CHECK(c > b);
+
+    REQUIRE(db.completeTasks({a, c}) == SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 0LL);
+    CHECK(insert_task(db, "D", "2026-10-21") > c);
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, missing_ids_are_not_announced)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    int a = insert_task(db, "A", "2026-10-18");
+    Recorder recorder;
+    db.addObserver(&recorder);
+
+    CHECK_EQ(db.completeTask(9999), SQLITE_OK);
+    CHECK(recorder.completed.empty());
+
+    int completed = -1;
+    REQUIRE(db.completeTasks({9998, a, 9999}, &completed) == SQLITE_OK);
+    CHECK_EQ(completed, 1);
+    CHECK(recorder.completed == std::vector<int>({a}));
+    db.removeObserver(&recorder);
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, bulk_insert_round_trip)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    std::vector<Task> tasks;
+    for (int i = 0; i < 250; i++) {
+        tasks.push_back(Task{"task " + std::to_string(i), format_due_key(due_key_from_minutes(29000000 + i * 90))});
+    }
+    REQUIRE(db.bulkInsertTasks(tasks, 64) == SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 250LL);
+
+    std::vector<TaskRow> rows;
+    REQUIRE(db.tasksDueBetween(parse_due_key(tasks[10].due_date), parse_due_key(tasks[20].due_date), rows) == SQLITE_OK);
+    REQUIRE(rows.size() == 10);
+    for (size_t i = 0; i < rows.size(); i++) {
+        CHECK_EQ(rows[i].task, tasks[10 + i].task);
+    }
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, observers_wait_for_the_outermost_commit)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    Recorder recorder;
+    db.addObserver(&recorder);
+
+    REQUIRE(db.beginTransaction() == SQLITE_OK);
+    int a = insert_task(db, "A", "2026-10-18");
+
+    // A released savepoint hands its changes to the enclosing one
+    REQUIRE(db.beginTransaction() == SQLITE_OK);
+    int b = insert_task(db, "B", "2026-10-19");
+    REQUIRE(db.commitTransaction() == SQLITE_OK);
+
+    // A rolled-back one takes its changes with it
+    REQUIRE(db.beginTransaction() == SQLITE_OK);
+    int c = insert_task(db, "C", "2026-10-20");
+    REQUIRE(db.completeTask(a) == SQLITE_OK);
+    REQUIRE(db.rollbackTransaction() == SQLITE_OK);
+
+    UpdateRow rename{"TASK", "B2", "ID", std::to_string(b)};
+    REQUIRE(db.updatePlanner(rename) == SQLITE_OK);
+    CHECK(recorder.inserted.empty());
+    CHECK_EQ(recorder.updated, 0);
+
+    REQUIRE(db.commitTransaction() == SQLITE_OK);
+    CHECK(recorder.inserted == std::vector<int>({a, b}));
+    CHECK(recorder.completed.empty());
+    CHECK_EQ(recorder.updated, 1);
+    CHECK(c > 0);
+    CHECK_EQ(db.countTasks(), 2LL);
+
+    // Outside a transaction each change is its own commit
+    REQUIRE(db.completeTask(a) == SQLITE_OK);
+    CHECK(recorder.completed == std::vector<int>({a}));
+    db.removeObserver(&recorder);
+}
+// --------------------------------------------------------------------------------
+
+TEST(db, observers_hear_nothing_of_a_rollback)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    int kept = insert_task(db, "Kept", "2026-10-18");
+    Recorder recorder;
+    db.addObserver(&recorder);
+
+    REQUIRE(db.beginTransaction() == SQLITE_OK);
+    REQUIRE(db.beginTransaction() == SQLITE_OK);
+    insert_task(db, "Gone", "2026-10-19");
+    REQUIRE(db.commitTransaction() == SQLITE_OK);
+    REQUIRE(db.completeTasks({kept}) == SQLITE_OK);
+    std::vector<Task> bulk = {Task{"Bulk", "2026-10-20"}};
+    REQUIRE(db.bulkInsertTasks(bulk) == SQLITE_OK);
+    REQUIRE(db.rollbackTransaction() == SQLITE_OK);
+
+    CHECK(recorder.inserted.empty());
+    CHECK(recorder.completed.empty());
+    CHECK_EQ(db.countTasks(), 1LL);
+
+    // Nothing left over from the rolled-back work reaches the next commit
+    int next = insert_task(db, "Next", "2026-10-21");
+    CHECK(recorder.inserted == std::vector<int>({next}));
+    db.removeObserver(&recorder);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,257 @@
+// ================================================================================
+// ================================================================================
+// - File:    import_export_test.cpp
+// - Purpose: The TSV, CSV and NDJSON importers (quoting, escapes, headers,
+//            rejected records) and export/import round trips.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/import_export.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static void write_file(const std::string& path, const std::string& contents)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+}
+// --------------------------------------------------------------------------------
+
+static std::string read_file(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+// --------------------------------------------------------------------------------
+
+// Every task as "task|due_date", in ID order.
+static std::vector<std::string> stored_tasks(DB& db)
+{
+    std::vector<std::string> tasks;
+    for (const RowView& row : db.scanTasks()) {
+        tasks.push_back(std::string(row.task) + "|" + std::string(row.due_date));
+    }
+    return tasks;
+}
+// --------------------------------------------------------------------------------
+
+// Every task's priority, in ID order.
+static std::vector<int> stored_priorities(DB& db)
+{
+    std::vector<int> priorities;
+    for (const RowView& row : db.scanTasks()) {
+        priorities.push_back(row.priority);
+    }
+    return priorities;
+}
+// --------------------------------------------------------------------------------
+
+// Imports contents in format into a fresh planner and returns its rc.
+static int import_text(const TempDir& dir, DB& db, DataFormat format, const std::string& contents,
+                       ImportResult& result, bool atomic = true)
+{
+    std::string path = dir.file("input");
+    write_file(path, contents);
+    ImportOptions options;
+    options.format = format;
+    options.atomic = atomic;
+    options.batch_size = 2;
+    return import_tasks(db, path, options, result);
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, csv_quoting)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    ImportResult result;
+    std::string csv =
+        "\"Call \"\"Mom\"\"\",2026-10-18\r\n"
+        "\"Buy milk, eggs\",2026-10-19T08:00\r\n"
+        "\"Two\nlines\",2026-10-20\n"
+        "plain,2026-10-21";
+    REQUIRE(import_text(dir, db, DataFormat::Csv, csv, result) == SQLITE_OK);
+    CHECK_EQ(result.rows, 4ULL);
+    CHECK(stored_tasks(db) == std::vector<std::string>({
+        "Call \"Mom\"|2026-10-18", "Buy milk, eggs|2026-10-19T08:00", "Two\nlines|2026-10-20", "plain|2026-10-21"}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, csv_header_picks_columns)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    // Header in any case and order; the id column is ignored
+    ImportResult result;
+    REQUIRE(import_text(dir, db, DataFormat::Csv, "Due_Date,ID,Task\n2026-10-18,7,first\n2026-10-19,3,second\n",
+                        result) == SQLITE_OK);
+    CHECK_EQ(result.rows, 2ULL);
+    CHECK(stored_tasks(db) == std::vector<std::string>({"first|2026-10-18", "second|2026-10-19"}));
+
+    // Without a header, three columns are id,task,due_date
+    DB other(dir.file("other.db"), test_db_options());
+    REQUIRE(other.createPlanner() == SQLITE_OK);
+    REQUIRE(import_text(dir, other, DataFormat::Csv, "12,third,2026-10-20\n13,fourth,2026-10-21\n", result) == SQLITE_OK);
+    CHECK(stored_tasks(other) == std::vector<std::string>({"third|2026-10-20", "fourth|2026-10-21"}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, tsv_header_and_escapes)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    ImportResult result;
+    REQUIRE(import_text(dir, db, DataFormat::Tsv,
+                        "task\tdue_date\n"
+                        "tab\\there\t2026-10-18\n"
+                        "5\twith id\t2026-10-19\r\n"
+                        "\n"
+                        "task\t2026-10-20\n",
+                        result) == SQLITE_OK);
+    // Only the first line can be a header; later "task" is a task
+    CHECK(stored_tasks(db) == std::vector<std::string>({
+        "tab\there|2026-10-18", "with id|2026-10-19", "task|2026-10-20"}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, ndjson_escapes_and_surrogates)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    ImportResult result;
+    REQUIRE(import_text(dir, db, DataFormat::Ndjson,
+                        "{\"task\": \"caf\\u00e9 \\ud83c\\udf82\", \"due_date\": \"2026-10-18\"}\n"
+                        "{\"id\": 4, \"extra\": {\"a\": [1, \"}\"]}, \"due_date\": \"2026-10-19\", \"task\": \"q\\\"t\\\\\"}\n",
+                        result) == SQLITE_OK);
+    CHECK(stored_tasks(db) == std::vector<std::string>({
+        "caf\xc3\xa9 \xf0\x9f\x8e\x82|2026-10-18", "q\"t\\|2026-10-19"}));
+
+    // A high surrogate without its low half is rejected
+    DB other(dir.file("other.db"), test_db_options());
+    REQUIRE(other.createPlanner() == SQLITE_OK);
+    CHECK(import_text(dir, other, DataFormat::Ndjson,
+                      "{\"task\": \"ok\", \"due_date\": \"2026-10-18\"}\n"
+                      "{\"task\": \"\\ud83c!\", \"due_date\": \"2026-10-18\"}\n",
+                      result) != SQLITE_OK);
+    CHECK_EQ(result.error_line, static_cast<size_t>(2));
+    CHECK_EQ(other.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, priority_columns)
+{
+    TempDir dir;
+    ImportResult result;
+    std::vector<int> expected = {5, MIN_PRIORITY, MAX_PRIORITY};
+
+    DB csv(dir.file("csv.db"), test_db_options());
+    REQUIRE(csv.createPlanner() == SQLITE_OK);
+    REQUIRE(import_text(dir, csv, DataFormat::Csv,
+                        "priority,task,due_date\n5,a,2026-10-18\n,b,2026-10-19\n255,c,2026-10-20\n",
+                        result) == SQLITE_OK);
+    CHECK(stored_priorities(csv) == expected);
+
+    // Four TSV fields are id, task, due date and priority
+    DB tsv(dir.file("tsv.db"), test_db_options());
+    REQUIRE(tsv.createPlanner() == SQLITE_OK);
+    REQUIRE(import_text(dir, tsv, DataFormat::Tsv,
+                        "1\ta\t2026-10-18\t5\nb\t2026-10-19\n3\tc\t2026-10-20\t255\n", result) == SQLITE_OK);
+    CHECK(stored_priorities(tsv) == expected);
+
+    DB ndjson(dir.file("ndjson.db"), test_db_options());
+    REQUIRE(ndjson.createPlanner() == SQLITE_OK);
+    REQUIRE(import_text(dir, ndjson, DataFormat::Ndjson,
+                        "{\"task\": \"a\", \"priority\": 5, \"due_date\": \"2026-10-18\"}\n"
+                        "{\"task\": \"b\", \"due_date\": \"2026-10-19\"}\n"
+                        "{\"task\": \"c\", \"due_date\": \"2026-10-20\", \"priority\": 255}\n",
+                        result) == SQLITE_OK);
+    CHECK(stored_priorities(ndjson) == expected);
+
+    // Out of range or not a number is a bad record
+    DB bad(dir.file("bad.db"), test_db_options());
+    REQUIRE(bad.createPlanner() == SQLITE_OK);
+    CHECK(import_text(dir, bad, DataFormat::Csv, "1,a,2026-10-18,256\n", result) != SQLITE_OK);
+    CHECK(result.error.find("256") != std::string::npos);
+    CHECK(import_text(dir, bad, DataFormat::Tsv, "1\ta\t2026-10-18\thigh\n", result) != SQLITE_OK);
+    CHECK(import_text(dir, bad, DataFormat::Ndjson,
+                      "{\"task\": \"a\", \"due_date\": \"2026-10-18\", \"priority\": \"5\"}\n", result) != SQLITE_OK);
+    CHECK_EQ(bad.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, bad_record_reports_its_line)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    // The quoted newline counts toward the line number
+    ImportResult result;
+    CHECK(import_text(dir, db, DataFormat::Csv,
+                      "a,2026-10-18\n\"b\nc\",2026-10-19\nd,2026-10-20\ne,2026-13-01\nf,2026-10-22\n", result) != SQLITE_OK);
+    CHECK_EQ(result.error_line, static_cast<size_t>(5));
+    CHECK(result.error.find("2026-13-01") != std::string::npos);
+    // Atomic: the rows before it are rolled back too
+    CHECK_EQ(db.countTasks(), 0LL);
+
+    CHECK(import_text(dir, db, DataFormat::Csv, "a,2026-10-18\n\"open,2026-10-19\n", result) != SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(import_export, export_round_trips)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    std::vector<Task> tasks = {
+        {"comma, \"quote\"", "2026-10-18", 7},
+        {"tab\tand\nnewline", "2026-10-19T07:45"},
+        {"back\\slash \xe2\x9c\x93 \x01", "2026-10-20", MAX_PRIORITY},
+    };
+    REQUIRE(db.bulkInsertTasks(tasks) == SQLITE_OK);
+    std::vector<std::string> expected = stored_tasks(db);
+    std::vector<int> expected_priorities = {7, MIN_PRIORITY, MAX_PRIORITY};
+
+    for (DataFormat format : {DataFormat::Tsv, DataFormat::Csv, DataFormat::Ndjson}) {
+        std::string path = dir.file("export");
+        uint64_t rows = 0;
+        REQUIRE(export_tasks(db, path, format, &rows) == SQLITE_OK);
+        CHECK_EQ(rows, 3ULL);
+
+        DB copy(dir.file("copy.db"), test_db_options());
+        REQUIRE(copy.createPlanner() == SQLITE_OK);
+        ImportResult result;
+        REQUIRE(import_text(dir, copy, format, read_file(path), result) == SQLITE_OK);
+        CHECK(stored_tasks(copy) == expected);
+        CHECK(stored_priorities(copy) == expected_priorities);
+        copy.closeDB();
+        std::remove(dir.file("copy.db").c_str());
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
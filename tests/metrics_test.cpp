@@ -0,0 +1,136 @@
+// ================================================================================
+// ================================================================================
+// - File:    metrics_test.cpp
+// - Purpose: The JSON and Prometheus metrics dumps after a few recorded
+//            samples: well-formed, with buckets that add up.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/metrics.hpp"
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Samples of 1 ns, 3 ns, 1 us and 1 ms on the prepare timer.
+static void record_samples()
+{
+    metrics_reset();
+    metrics_count(MetricCounter::RowsWritten, 5);
+    metrics_count(MetricCounter::RowsWritten);
+    for (uint64_t ns : {1ULL, 3ULL, 1000ULL, 1000000ULL}) {
+        metrics_record(MetricTimer::Prepare, ns);
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Brackets and braces balance outside strings, and nothing follows the
+// top-level object.
+static bool balanced_json(const std::string& text)
+{
+    std::vector<char> open;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (in_string) {
+            if (c == '\\')
+                i++;
+            else if (c == '"')
+                in_string = false;
+            continue;
+        }
+        if (c == '"')
+            in_string = true;
+        else if (c == '{' || c == '[')
+            open.push_back(c == '{' ? '}' : ']');
+        else if (c == '}' || c == ']') {
+            if (open.empty() || open.back() != c)
+                return false;
+            open.pop_back();
+            if (open.empty())
+                return text.find_first_not_of(" \n", i + 1) == std::string::npos;
+        }
+    }
+    return false;
+}
+// --------------------------------------------------------------------------------
+
+TEST(metrics, json_dump_is_well_formed)
+{
+    record_samples();
+    std::ostringstream out;
+    write_metrics_json(out);
+    std::string json = out.str();
+    CHECK(balanced_json(json));
+    CHECK(json.find("\"rows_written\": 6") != std::string::npos);
+
+    // The prepare timer's buckets hold every sample once
+    size_t prepare = json.find("\"prepare\": {\"count\": 4,");
+    REQUIRE(prepare != std::string::npos);
+    size_t begin = json.find('[', prepare), end = json.find(']', prepare);
+    REQUIRE(begin != std::string::npos && end != std::string::npos && begin < end);
+    std::istringstream buckets(json.substr(begin + 1, end - begin - 1));
+    long long total = 0, value;
+    while (buckets >> value) {
+        total += value;
+        buckets.ignore(1);
+    }
+    CHECK_EQ(total, 4LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(metrics, prometheus_buckets_are_cumulative)
+{
+    record_samples();
+    std::ostringstream out;
+    write_metrics_prometheus(out);
+    std::istringstream lines(out.str());
+
+    const std::string prefix = "planner_operation_duration_seconds_bucket{op=\"prepare\",le=\"";
+    std::string line;
+    double last_bound = 0.0;
+    long long last_count = 0, inf_count = -1, buckets = 0, count = -1;
+    bool counter_seen = false;
+    while (std::getline(lines, line)) {
+        if (line == "planner_rows_written_total 6")
+            counter_seen = true;
+        if (line.rfind("planner_operation_duration_seconds_count{op=\"prepare\"} ", 0) == 0)
+            count = std::atoll(line.c_str() + line.rfind(' ') + 1);
+        if (line.rfind(prefix, 0) != 0)
+            continue;
+
+        std::string bound = line.substr(prefix.size(), line.find('"', prefix.size()) - prefix.size());
+        long long value = std::atoll(line.c_str() + line.rfind(' ') + 1);
+        CHECK(value >= last_count);
+        last_count = value;
+        if (bound == "+Inf") {
+            inf_count = value;
+            continue;
+        }
+        double upper = std::atof(bound.c_str());
+        CHECK(upper > last_bound);
+        last_bound = upper;
+        buckets++;
+    }
+    CHECK(counter_seen);
+    CHECK_EQ(buckets, static_cast<long long>(METRIC_BUCKETS - 1));
+    CHECK_EQ(inf_count, 4LL);
+    CHECK_EQ(count, 4LL);
+
+    // 1 ms lands below 2^20 ns but not below 2^19 ns
+    CHECK(out.str().find(prefix + "0.000524288\"} 3") != std::string::npos);
+    CHECK(out.str().find(prefix + "0.001048576\"} 4") != std::string::npos);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
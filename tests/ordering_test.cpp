@@ -0,0 +1,176 @@
+// ================================================================================
+// ================================================================================
+// - File:    ordering_test.cpp
+// - Purpose: The packed due-date/priority order key and the same task order
+//            on every read path (SQL, Scheduler, PlannerSnapshot, scans).
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/min_heap.hpp"
+#include "../src/include/planner_snapshot.hpp"
+#include "../src/include/scheduler.hpp"
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+TEST(ordering, packs_due_key_and_priority)
+{
+    DueKey due = parse_due_key("2026-10-18T09:30");
+    for (int priority : {MIN_PRIORITY, 1, 128, MAX_PRIORITY}) {
+        OrderKey key = make_order_key(due, priority);
+        CHECK_EQ(order_key_due(key), due);
+        CHECK_EQ(order_key_priority(key), priority);
+    }
+
+    // Out-of-range priorities are clamped
+    CHECK_EQ(make_order_key(due, -5), make_order_key(due, MIN_PRIORITY));
+    CHECK_EQ(make_order_key(due, 1000), make_order_key(due, MAX_PRIORITY));
+
+    // Earlier first, then more urgent first; no priority moves a task past
+    // one due a minute earlier
+    CHECK(make_order_key(due, MAX_PRIORITY) < make_order_key(due, MIN_PRIORITY));
+    CHECK(make_order_key(due, MIN_PRIORITY) < make_order_key(parse_due_key("2026-10-18T09:31"), MAX_PRIORITY));
+
+    CHECK_EQ(make_order_key(INVALID_DUE_KEY, 7), INVALID_ORDER_KEY);
+    CHECK_EQ(order_key_due(INVALID_ORDER_KEY), INVALID_DUE_KEY);
+    CHECK(make_order_key(parse_due_key("9999-12-31T23:59"), MIN_PRIORITY) < INVALID_ORDER_KEY);
+}
+// --------------------------------------------------------------------------------
+
+TEST(ordering, every_read_path_agrees)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    // Three due times and three priorities, so every tie-break is used
+    const char* dates[] = {"2026-10-18T09:00", "2026-10-18", "2026-10-19"};
+    const int priorities[] = {MIN_PRIORITY, 5, MAX_PRIORITY};
+    for (int i = 0; i < 27; i++) {
+        std::string task = "task " + std::to_string(i);
+        std::string due_date = dates[(i * 7) % 3];
+        REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+        int id = static_cast<int>(sqlite3_last_insert_rowid(db.db));
+        REQUIRE(db.setPriority(id, priorities[(i / 3) % 3]) == SQLITE_OK);
+    }
+
+    std::vector<TaskRow> sql_rows;
+    REQUIRE(db.nextTasks(100, sql_rows) == SQLITE_OK);
+    REQUIRE(sql_rows.size() == 27);
+    std::vector<int> expected;
+    for (size_t i = 0; i < sql_rows.size(); i++) {
+        expected.push_back(sql_rows[i].id);
+        if (i > 0) {
+            OrderKey previous = make_order_key(sql_rows[i - 1].due_key, sql_rows[i - 1].priority);
+            OrderKey current = make_order_key(sql_rows[i].due_key, sql_rows[i].priority);
+            CHECK(previous < current || (previous == current && sql_rows[i - 1].id < sql_rows[i].id));
+        }
+    }
+
+    Scheduler scheduler(db);
+    std::vector<int> heap_order;
+    while (!scheduler.empty()) {
+        heap_order.push_back(scheduler.pop().id);
+    }
+    CHECK(heap_order == expected);
+
+    PlannerSnapshot snapshot(db);
+    std::vector<SnapshotRow> snapshot_rows;
+    snapshot.nextTasks(100, snapshot_rows);
+    std::vector<int> snapshot_order;
+    for (const SnapshotRow& row : snapshot_rows) {
+        snapshot_order.push_back(row.id);
+    }
+    CHECK(snapshot_order == expected);
+
+    // The one-shot scans pick the same first task
+    CHECK_EQ(next_task(db_to_vector(db)).id, expected.front());
+    TaskRow first;
+    REQUIRE(next_task(db, first));
+    CHECK_EQ(first.id, expected.front());
+
+    // And a range keeps the order
+    std::vector<TaskRow> range;
+    REQUIRE(db.tasksDueBetween(parse_due_key("2026-10-18"), parse_due_key("2026-10-19"), range) == SQLITE_OK);
+    REQUIRE(range.size() == 18);
+    for (size_t i = 0; i < range.size(); i++) {
+        CHECK_EQ(range[i].id, expected[i]);
+    }
+}
+// --------------------------------------------------------------------------------
+
+TEST(ordering, snapshot_index_follows_every_change)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    PlannerSnapshot snapshot(db);
+
+    // A fixed-seed mix of inserts, completions, moves (some to invalid
+    // dates and back) and priority changes, compared with SQL after each
+    uint32_t seed = 12345;
+    auto random = [&seed](uint32_t bound) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % bound;
+    };
+    const char* dates[] = {"2026-10-18", "2026-10-18T09:00", "2026-10-19", "2026-10-20T17:30", "someday"};
+    std::vector<int> ids;
+    for (int step = 0; step < 400; step++) {
+        uint32_t action = ids.empty() ? 0 : random(4);
+        if (action == 0) {
+            ids.push_back(insert_task(db, "task " + std::to_string(step), dates[random(5)]));
+        }
+        else if (action == 1) {
+            size_t index = random(static_cast<uint32_t>(ids.size()));
+            REQUIRE(db.completeTask(ids[index]) == SQLITE_OK);
+            ids.erase(ids.begin() + static_cast<long>(index));
+        }
+        else if (action == 2) {
+            UpdateRow move{"DUE_DATE", dates[random(5)], "ID", std::to_string(ids[random(static_cast<uint32_t>(ids.size()))])};
+            REQUIRE(db.updatePlanner(move) == SQLITE_OK);
+        }
+        else {
+            int priority = static_cast<int>(random(3)) * 100;
+            REQUIRE(db.setPriority(ids[random(static_cast<uint32_t>(ids.size()))], priority) == SQLITE_OK);
+        }
+
+        if (step % 20 != 19)
+            continue;
+        std::vector<TaskRow> sql_rows;
+        REQUIRE(db.nextTasks(1000, sql_rows) == SQLITE_OK);
+        std::vector<SnapshotRow> snapshot_rows;
+        snapshot.nextTasks(1000, snapshot_rows);
+        REQUIRE(snapshot_rows.size() == sql_rows.size());
+        for (size_t i = 0; i < sql_rows.size(); i++) {
+            CHECK_EQ(snapshot_rows[i].id, sql_rows[i].id);
+        }
+
+        SnapshotRow first;
+        CHECK_EQ(snapshot.next(first), !sql_rows.empty());
+        if (!sql_rows.empty()) {
+            CHECK_EQ(first.id, sql_rows.front().id);
+        }
+
+        std::vector<TaskRow> sql_range;
+        std::vector<SnapshotRow> snapshot_range;
+        REQUIRE(db.tasksDueBetween(parse_due_key("2026-10-18T09:00"), parse_due_key("2026-10-20"), sql_range) == SQLITE_OK);
+        snapshot.tasksDueBetween(parse_due_key("2026-10-18T09:00"), parse_due_key("2026-10-20"), snapshot_range);
+        REQUIRE(snapshot_range.size() == sql_range.size());
+        for (size_t i = 0; i < sql_range.size(); i++) {
+            CHECK_EQ(snapshot_range[i].id, sql_range[i].id);
+        }
+        CHECK_EQ(snapshot.verify(db), static_cast<size_t>(0));
+    }
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
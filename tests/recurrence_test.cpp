@@ -0,0 +1,196 @@
+// ================================================================================
+// ================================================================================
+// - File:    recurrence_test.cpp
+// - Purpose: Expansion of recurrence rules and the next occurrence that
+//            completing a recurring task inserts.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/recurrence.hpp"
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+static RecurrenceRule rule(const char* start, Frequency frequency, int interval, const char* until = nullptr)
+{
+    RecurrenceRule result;
+    result.task = "repeat";
+    result.start = parse_due_key(start);
+    result.frequency = frequency;
+    result.interval = interval;
+    if (until)
+        result.until = parse_due_key(until);
+    return result;
+}
+// --------------------------------------------------------------------------------
+
+// The first count occurrences, each the one after the previous.
+static std::vector<std::string> expand(const RecurrenceRule& rule, int count)
+{
+    std::vector<std::string> dates;
+    DueKey key = rule.start;
+    for (int i = 0; i < count && key != INVALID_DUE_KEY; i++) {
+        dates.push_back(format_due_key(key));
+        key = next_occurrence(rule, key);
+    }
+    return dates;
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, daily_and_weekly_steps)
+{
+    CHECK(expand(rule("2026-10-30T08:15", Frequency::Daily, 1), 4) ==
+          std::vector<std::string>({"2026-10-30T08:15", "2026-10-31T08:15", "2026-11-01T08:15", "2026-11-02T08:15"}));
+    CHECK(expand(rule("2026-12-20", Frequency::Daily, 7), 3) ==
+          std::vector<std::string>({"2026-12-20", "2026-12-27", "2027-01-03"}));
+    CHECK(expand(rule("2028-02-15", Frequency::Weekly, 2), 3) ==
+          std::vector<std::string>({"2028-02-15", "2028-02-29", "2028-03-14"}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, monthly_keeps_the_day_of_month)
+{
+    // Clamped to short months, then back to the 31st
+    CHECK(expand(rule("2026-01-31", Frequency::Monthly, 1), 5) ==
+          std::vector<std::string>({"2026-01-31", "2026-02-28", "2026-03-31", "2026-04-30", "2026-05-31"}));
+    CHECK(expand(rule("2027-11-29T18:00", Frequency::Monthly, 3), 3) ==
+          std::vector<std::string>({"2027-11-29T18:00", "2028-02-29T18:00", "2028-05-29T18:00"}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, counts_from_the_start)
+{
+    // A late completion (or a rescheduled occurrence) does not shift the
+    // series: the next occurrence is the first one after the given key
+    RecurrenceRule weekly = rule("2026-10-05T09:00", Frequency::Weekly, 1);
+    CHECK_EQ(format_due_key(next_occurrence(weekly, parse_due_key("2026-10-15T17:30"))), std::string("2026-10-19T09:00"));
+    CHECK_EQ(format_due_key(next_occurrence(weekly, parse_due_key("2026-10-19T09:00"))), std::string("2026-10-26T09:00"));
+    CHECK_EQ(next_occurrence(weekly, parse_due_key("2026-01-01")), weekly.start);
+
+    RecurrenceRule monthly = rule("2026-01-31", Frequency::Monthly, 2);
+    CHECK_EQ(format_due_key(next_occurrence(monthly, parse_due_key("2026-06-15"))), std::string("2026-07-31"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, ends_at_until)
+{
+    RecurrenceRule limited = rule("2026-10-18", Frequency::Daily, 2, "2026-10-22");
+    CHECK(expand(limited, 10) == std::vector<std::string>({"2026-10-18", "2026-10-20", "2026-10-22"}));
+    CHECK_EQ(next_occurrence(rule("2026-10-18", Frequency::Daily, 0), parse_due_key("2026-10-18")), INVALID_DUE_KEY);
+    CHECK_EQ(describe_recurrence(limited), std::string("every 2 days until 2026-10-22"));
+    CHECK_EQ(describe_recurrence(rule("2026-10-18", Frequency::Monthly, 1)), std::string("monthly"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, date_only_until_covers_the_whole_day)
+{
+    RecurrenceRule morning = rule("2026-01-29T09:00", Frequency::Daily, 1, "2026-01-31");
+    CHECK(expand(morning, 10) == std::vector<std::string>({"2026-01-29T09:00", "2026-01-30T09:00", "2026-01-31T09:00"}));
+    CHECK_EQ(format_due_key(recurrence_end(morning)), std::string("2026-01-31T23:59"));
+
+    // An until with a time of day is exact
+    RecurrenceRule evening = rule("2026-01-29T18:00", Frequency::Daily, 1, "2026-01-31T12:00");
+    CHECK(expand(evening, 10) == std::vector<std::string>({"2026-01-29T18:00", "2026-01-30T18:00"}));
+
+    // Ending on the start date is allowed, and gives one occurrence
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    RecurrenceRule once = rule("2026-01-31T09:00", Frequency::Daily, 1, "2026-01-31");
+    REQUIRE(db.addRecurrence(once) == SQLITE_OK);
+    REQUIRE(db.completeTask(once.pending_id) == SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, completing_inserts_the_next_occurrence)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    RecurrenceRule weekly = rule("2026-10-19T07:00", Frequency::Weekly, 1, "2026-11-02T07:00");
+    weekly.task = "Take out the bins";
+    REQUIRE(db.addRecurrence(weekly) == SQLITE_OK);
+    CHECK(weekly.id > 0);
+    CHECK_EQ(weekly.pending_key, weekly.start);
+    CHECK_EQ(db.countTasks(), 1LL);
+
+    std::vector<std::string> seen;
+    for (int i = 0; i < 4 && db.countTasks() > 0; i++) {
+        std::vector<TaskRow> rows;
+        REQUIRE(db.nextTasks(1, rows) == SQLITE_OK);
+        REQUIRE(rows.size() == 1);
+        CHECK_EQ(rows[0].task, weekly.task);
+        seen.push_back(format_due_key(rows[0].due_key));
+        REQUIRE(db.completeTask(rows[0].id) == SQLITE_OK);
+    }
+    CHECK(seen == std::vector<std::string>({"2026-10-19T07:00", "2026-10-26T07:00", "2026-11-02T07:00"}));
+
+    // The last occurrence ends the rule
+    std::vector<RecurrenceRule> rules;
+    REQUIRE(db.listRecurrences(rules) == SQLITE_OK);
+    CHECK(rules.empty());
+    CHECK_EQ(db.countTasks(), 0LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, remove_drops_the_pending_occurrence)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    RecurrenceRule daily = rule("2026-10-18", Frequency::Daily, 1);
+    REQUIRE(db.addRecurrence(daily) == SQLITE_OK);
+    std::string task = "One-off", due_date = "2026-10-20";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+
+    std::vector<RecurrenceRule> rules;
+    REQUIRE(db.listRecurrences(rules) == SQLITE_OK);
+    REQUIRE(rules.size() == 1);
+    CHECK_EQ(rules[0].pending_id, daily.pending_id);
+
+    REQUIRE(db.removeRecurrence(daily.id) == SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 1LL);
+    CHECK(db.removeRecurrence(daily.id) != SQLITE_OK);
+}
+// --------------------------------------------------------------------------------
+
+TEST(recurrence, a_vanished_occurrence_is_not_advanced)
+{
+    // The losing side of two connections completing the same occurrence:
+    // the rule still names it, but the row is already gone
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    RecurrenceRule daily = rule("2026-10-18", Frequency::Daily, 1);
+    REQUIRE(db.addRecurrence(daily) == SQLITE_OK);
+
+    std::string gone = "DELETE FROM PLANNER WHERE ID = " + std::to_string(daily.pending_id) + ";";
+    REQUIRE(sqlite3_exec(db.db, gone.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK);
+    REQUIRE(db.completeTask(daily.pending_id) == SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 0LL);
+
+    int completed = -1;
+    REQUIRE(db.completeTasks({daily.pending_id}, &completed) == SQLITE_OK);
+    CHECK_EQ(completed, 0);
+    CHECK_EQ(db.countTasks(), 0LL);
+
+    std::vector<RecurrenceRule> rules;
+    REQUIRE(db.listRecurrences(rules) == SQLITE_OK);
+    REQUIRE(rules.size() == 1);
+    CHECK_EQ(rules[0].pending_id, daily.pending_id);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
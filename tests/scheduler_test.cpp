@@ -0,0 +1,358 @@
+// ================================================================================
+// ================================================================================
+// - File:    scheduler_test.cpp
+// - Purpose: Ordering of the Scheduler's 4-ary indexed heap and the tasks it
+//            sets aside for invalid due dates.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/scheduler.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Pops everything and returns the IDs in the order they came out.
+static std::vector<int> drain(Scheduler& scheduler)
+{
+    std::vector<int> ids;
+    while (!scheduler.empty()) {
+        ids.push_back(scheduler.pop().id);
+    }
+    return ids;
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, pops_in_due_order)
+{
+    Scheduler scheduler;
+    scheduler.push(PriorityQueue(1, "c", "2026-10-20"));
+    scheduler.push(PriorityQueue(2, "a", "2026-10-18T07:00"));
+    scheduler.push(PriorityQueue(3, "d", "2026-12-01"));
+    scheduler.push(PriorityQueue(4, "b", "2026-10-18T09:00"));
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(4));
+    CHECK_EQ(scheduler.peek().id, 2);
+    CHECK(drain(scheduler) == std::vector<int>({2, 4, 1, 3}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, priority_then_id_break_ties)
+{
+    Scheduler scheduler;
+    scheduler.push(PriorityQueue(7, "low", "2026-10-18", MIN_PRIORITY));
+    scheduler.push(PriorityQueue(5, "low too", "2026-10-18", MIN_PRIORITY));
+    scheduler.push(PriorityQueue(9, "high", "2026-10-18", MAX_PRIORITY));
+    scheduler.push(PriorityQueue(1, "earlier", "2026-10-17T23:59", MIN_PRIORITY));
+    CHECK(drain(scheduler) == std::vector<int>({1, 9, 5, 7}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, matches_a_sort_on_many_tasks)
+{
+    // Deterministic pseudo-random dates with plenty of duplicates, so every
+    // level of the heap and the ID tie-break get exercised
+    Scheduler scheduler;
+    std::vector<PriorityQueue> expected;
+    uint64_t state = 12345;
+    for (int id = 1; id <= 2000; id++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t minutes = 29000000 + static_cast<int64_t>((state >> 33) % 500) * 60;
+        int priority = static_cast<int>((state >> 20) % (MAX_PRIORITY - MIN_PRIORITY + 1)) + MIN_PRIORITY;
+        PriorityQueue item(id, "t", due_key_from_minutes(minutes), priority);
+        expected.push_back(item);
+        scheduler.push(item);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<int> expected_ids;
+    for (const PriorityQueue& item : expected) {
+        expected_ids.push_back(item.id);
+    }
+    CHECK(drain(scheduler) == expected_ids);
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, load_heapifies_the_rows)
+{
+    Scheduler scheduler;
+    std::vector<PriorityQueue> rows;
+    for (int id = 1; id <= 100; id++) {
+        rows.push_back(PriorityQueue(id, "t", due_key_from_minutes(29000000 + (100 - id) * 15)));
+    }
+    scheduler.load(std::move(rows));
+    std::vector<int> ids = drain(scheduler);
+    REQUIRE(ids.size() == 100);
+    for (int i = 0; i < 100; i++) {
+        CHECK_EQ(ids[i], 100 - i);
+    }
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, reschedule_reprioritize_and_erase)
+{
+    Scheduler scheduler;
+    for (int id = 1; id <= 5; id++) {
+        scheduler.push(PriorityQueue(id, "t", "2026-10-1" + std::to_string(id)));
+    }
+
+    CHECK(scheduler.reschedule(5, "2026-10-01"));
+    CHECK_EQ(scheduler.peek().id, 5);
+    CHECK(scheduler.reschedule(5, "2026-10-30"));
+    CHECK_EQ(scheduler.peek().id, 1);
+
+    CHECK(scheduler.reprioritize(3, MAX_PRIORITY));
+    CHECK(scheduler.reschedule(3, "2026-10-11"));
+    CHECK_EQ(scheduler.peek().id, 3);
+
+    CHECK(scheduler.erase(3));
+    CHECK(!scheduler.erase(3));
+    CHECK(!scheduler.contains(3));
+    CHECK(!scheduler.reschedule(42, "2026-10-01"));
+
+    // Pushing an existing ID replaces the entry
+    scheduler.push(PriorityQueue(4, "moved", "2026-09-01"));
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(4));
+    CHECK_EQ(scheduler.peek().task, std::string("moved"));
+    CHECK(drain(scheduler) == std::vector<int>({4, 1, 2, 5}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, invalid_dates_stay_out_of_the_heap)
+{
+    Scheduler scheduler;
+    scheduler.push(PriorityQueue(1, "ok", "2026-10-18"));
+    scheduler.push(PriorityQueue(2, "bad", "someday"));
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(1));
+    CHECK(scheduler.invalidTasks().count(2) == 1);
+
+    // A valid date brings it back
+    CHECK(scheduler.reschedule(2, "2026-10-17"));
+    CHECK(scheduler.invalidTasks().empty());
+    CHECK_EQ(scheduler.peek().id, 2);
+
+    // And an invalid one sets a scheduled task aside, keeping the text
+    CHECK(scheduler.reschedule(1, "2026-02-30"));
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(1));
+    REQUIRE(scheduler.invalidTasks().count(1) == 1);
+    CHECK_EQ(scheduler.invalidTasks().at(1).due_date, std::string("2026-02-30"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, invalid_dates_keep_their_priority)
+{
+    Scheduler scheduler;
+    scheduler.push(PriorityQueue(1, "urgent", "2026-10-20", MAX_PRIORITY));
+    scheduler.push(PriorityQueue(2, "plain", "2026-10-19"));
+    REQUIRE(scheduler.reschedule(1, "someday"));
+    REQUIRE(scheduler.invalidTasks().count(1) == 1);
+    CHECK_EQ(scheduler.invalidTasks().at(1).priority, MAX_PRIORITY);
+
+    // Back on the plain task's day it still outranks it
+    REQUIRE(scheduler.reschedule(1, "2026-10-19"));
+    CHECK_EQ(scheduler.peek().id, 1);
+    CHECK_EQ(scheduler.peek().priority(), MAX_PRIORITY);
+
+    // The same through the DB, with the priority set while the date is bad
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    std::vector<Task> tasks = {Task{"plain", "2026-10-19"}, Task{"urgent", "next week", 3}};
+    REQUIRE(db.bulkInsertTasks(tasks) == SQLITE_OK);
+    Scheduler follower(db);
+    REQUIRE(follower.invalidTasks().count(2) == 1);
+    CHECK_EQ(follower.invalidTasks().at(2).priority, 3);
+
+    REQUIRE(db.setPriority(2, MAX_PRIORITY) == SQLITE_OK);
+    CHECK_EQ(follower.invalidTasks().at(2).priority, MAX_PRIORITY);
+    UpdateRow fixed{"DUE_DATE", "2026-10-19", "ID", "2"};
+    REQUIRE(db.updatePlanner(fixed) == SQLITE_OK);
+    CHECK_EQ(follower.peek().id, 2);
+    CHECK_EQ(follower.peek().priority(), MAX_PRIORITY);
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, invalid_rows_keep_their_text)
+{
+    Scheduler scheduler;
+    std::vector<PriorityQueue> rows;
+    rows.push_back(PriorityQueue(1, "ok", "2026-10-18"));
+    rows.push_back(PriorityQueue(2, "loaded", "next week"));
+    scheduler.load(std::move(rows));
+    scheduler.push(PriorityQueue(3, "pushed", "2026-13-01"));
+
+    const auto& invalid = scheduler.invalidTasks();
+    REQUIRE(invalid.size() == 2);
+    CHECK_EQ(invalid.at(2).due_date, std::string("next week"));
+    CHECK_EQ(invalid.at(2).task, std::string("loaded"));
+    CHECK_EQ(invalid.at(3).due_date, std::string("2026-13-01"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, reload_keeps_invalid_text)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    std::string task = "Someday", due_date = "after the move";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+
+    Scheduler scheduler(db);
+    CHECK(scheduler.empty());
+    REQUIRE(scheduler.invalidTasks().size() == 1);
+    CHECK_EQ(scheduler.invalidTasks().begin()->second.due_date, due_date);
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, random_operations_match_a_sorted_set)
+{
+    // Interleaved push, reschedule, reprioritize, erase and pop checked
+    // against a std::set after every step, so a slot index that falls out
+    // of step with the heap shows up at once
+    Scheduler scheduler;
+    std::set<std::pair<OrderKey, int>> expected;
+    std::map<int, OrderKey> keys;
+    uint64_t state = 99;
+    auto next = [&state](uint64_t bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 33) % bound;
+    };
+
+    for (int step = 0; step < 20000; step++) {
+        int id = static_cast<int>(next(400)) + 1;
+        DueKey due = due_key_from_minutes(29000000 + static_cast<int64_t>(next(300)) * 30);
+        int priority = static_cast<int>(next(4)) * 80;
+        auto known = keys.find(id);
+        switch (next(5)) {
+            case 0:
+            case 1: {
+                PriorityQueue item(id, "t", due, priority);
+                if (known != keys.end())
+                    expected.erase({known->second, id});
+                expected.insert({item.order_key, id});
+                keys[id] = item.order_key;
+                scheduler.push(item);
+                break;
+            }
+            case 2: {
+                bool found = scheduler.reschedule(id, format_due_key(due));
+                CHECK_EQ(found, known != keys.end());
+                if (known != keys.end()) {
+                    OrderKey key = make_order_key(due, order_key_priority(known->second));
+                    expected.erase({known->second, id});
+                    expected.insert({key, id});
+                    known->second = key;
+                }
+                break;
+            }
+            case 3: {
+                bool found = scheduler.reprioritize(id, priority);
+                CHECK_EQ(found, known != keys.end());
+                if (known != keys.end()) {
+                    OrderKey key = make_order_key(order_key_due(known->second), priority);
+                    expected.erase({known->second, id});
+                    expected.insert({key, id});
+                    known->second = key;
+                }
+                break;
+            }
+            default: {
+                if (next(2) == 0) {
+                    CHECK_EQ(scheduler.erase(id), known != keys.end());
+                    if (known != keys.end()) {
+                        expected.erase({known->second, id});
+                        keys.erase(known);
+                    }
+                }
+                else if (!scheduler.empty()) {
+                    PriorityQueue top = scheduler.pop();
+                    REQUIRE(!expected.empty());
+                    CHECK_EQ(top.id, expected.begin()->second);
+                    keys.erase(expected.begin()->second);
+                    expected.erase(expected.begin());
+                }
+                break;
+            }
+        }
+
+        REQUIRE(scheduler.size() == expected.size());
+        if (!expected.empty()) {
+            REQUIRE(scheduler.peek().id == expected.begin()->second);
+            REQUIRE(scheduler.peek().order_key == expected.begin()->first);
+        }
+    }
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, follows_db_changes)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    std::string task = "Later", due_date = "2026-10-25";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+    int later = static_cast<int>(sqlite3_last_insert_rowid(db.db));
+
+    Scheduler scheduler(db);
+    REQUIRE(scheduler.size() == 1);
+
+    task = "Sooner";
+    due_date = "2026-10-19";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+    int sooner = static_cast<int>(sqlite3_last_insert_rowid(db.db));
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(2));
+    CHECK_EQ(scheduler.peek().id, sooner);
+
+    UpdateRow move{"DUE_DATE", "2026-10-18", "ID", std::to_string(later)};
+    REQUIRE(db.updatePlanner(move) == SQLITE_OK);
+    CHECK_EQ(scheduler.peek().id, later);
+
+    REQUIRE(db.setPriority(sooner, MAX_PRIORITY) == SQLITE_OK);
+    UpdateRow same_day{"DUE_DATE", "2026-10-18", "ID", std::to_string(sooner)};
+    REQUIRE(db.updatePlanner(same_day) == SQLITE_OK);
+    CHECK_EQ(scheduler.peek().id, sooner);
+
+    REQUIRE(db.completeTask(sooner) == SQLITE_OK);
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(1));
+    CHECK_EQ(scheduler.peek().id, later);
+    CHECK(!scheduler.contains(sooner));
+}
+// --------------------------------------------------------------------------------
+
+TEST(scheduler, ignores_rolled_back_changes)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    std::string task = "Kept", due_date = "2026-10-25";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+    int kept = static_cast<int>(sqlite3_last_insert_rowid(db.db));
+    Scheduler scheduler(db);
+
+    REQUIRE(db.beginTransaction() == SQLITE_OK);
+    task = "Gone";
+    due_date = "2026-10-18";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+    REQUIRE(db.completeTask(kept) == SQLITE_OK);
+    CHECK_EQ(scheduler.peek().id, kept);
+    REQUIRE(db.rollbackTransaction() == SQLITE_OK);
+
+    // The heap still mirrors the table after the rollback
+    CHECK_EQ(scheduler.size(), static_cast<size_t>(1));
+    CHECK_EQ(scheduler.peek().id, kept);
+    CHECK_EQ(db.countTasks(), 1LL);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
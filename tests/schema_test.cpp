@@ -0,0 +1,290 @@
+// ================================================================================
+// ================================================================================
+// - File:    schema_test.cpp
+// - Purpose: Migrating the original planner ("data/old planner/planner.db",
+//            copied to a temporary directory) to the current schema, a
+//            second run being a no-op, and a failed chunk rolling back
+//            cleanly so the migration can be resumed.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/schema.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+struct StoredRow {
+    long long id;
+    std::string task;
+    std::string due_date;
+
+    bool operator==(const StoredRow& other) const
+    {
+        return id == other.id && task == other.task && due_date == other.due_date;
+    }
+};
+// --------------------------------------------------------------------------------
+
+// A copy of the old planner fixture; the original is never opened for writing.
+static std::string copy_fixture(const TempDir& dir)
+{
+    std::string copy = dir.file("planner.db");
+    std::filesystem::copy_file(source_path("data/old planner/planner.db"), copy);
+    return copy;
+}
+// --------------------------------------------------------------------------------
+
+static std::vector<StoredRow> stored_rows(DB& db)
+{
+    std::vector<StoredRow> rows;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db.db, "SELECT ID, TASK, DUE_DATE FROM PLANNER ORDER BY ID;", -1, &stmt, nullptr) != SQLITE_OK)
+        return rows;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        rows.push_back(StoredRow{sqlite3_column_int64(stmt, 0),
+                                 reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                                 reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2))});
+    }
+    sqlite3_finalize(stmt);
+    return rows;
+}
+// --------------------------------------------------------------------------------
+
+// Every row has the DUE_KEY and ORDER_KEY its DUE_DATE calls for.
+static void check_keys(DB& db)
+{
+    sqlite3_stmt* stmt = nullptr;
+    REQUIRE(sqlite3_prepare_v2(db.db, "SELECT ID, DUE_DATE, DUE_KEY, ORDER_KEY, PRIORITY FROM PLANNER;", -1, &stmt,
+                               nullptr) == SQLITE_OK);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        DueKey expected = parse_due_key(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+        CHECK_EQ(sqlite3_column_int64(stmt, 2), expected);
+        CHECK_EQ(sqlite3_column_int64(stmt, 3), make_order_key(expected, MIN_PRIORITY));
+        CHECK_EQ(sqlite3_column_int(stmt, 4), MIN_PRIORITY);
+    }
+    sqlite3_finalize(stmt);
+}
+// --------------------------------------------------------------------------------
+
+static int exec(DB& db, const std::string& sql)
+{
+    return sqlite3_exec(db.db, sql.c_str(), nullptr, nullptr, nullptr);
+}
+// --------------------------------------------------------------------------------
+
+static MigrationOptions small_chunks(std::vector<MigrationProgress>* progress)
+{
+    MigrationOptions options;
+    options.chunk_rows = 3;
+    options.progress = [progress](const MigrationProgress& step) { progress->push_back(step); };
+    return options;
+}
+// --------------------------------------------------------------------------------
+
+TEST(schema, migrates_the_old_planner)
+{
+    TempDir dir;
+    std::string path = copy_fixture(dir);
+    DB db(path, test_db_options());
+    REQUIRE(db.db != nullptr);
+
+    std::vector<StoredRow> before = stored_rows(db);
+    REQUIRE(before.size() == 10);
+    CHECK_EQ(SchemaMigrator(db).currentVersion(), 0);
+
+    std::vector<MigrationProgress> progress;
+    REQUIRE(db.migrate(small_chunks(&progress)) == SQLITE_OK);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+    CHECK_EQ(db.countTasks(), 10LL);
+    CHECK(stored_rows(db) == before);
+    check_keys(db);
+
+    // Every step ran, the chunked ones in more than one chunk
+    int rebuild_chunks = 0;
+    for (const MigrationProgress& step : progress) {
+        if (step.version == 1 && step.done > 0)
+            rebuild_chunks++;
+    }
+    CHECK(rebuild_chunks >= 3);
+    REQUIRE(!progress.empty());
+    CHECK_EQ(progress.back().version, SCHEMA_VERSION);
+
+    // The rebuilt table has rowid IDs and the later tables exist
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'PLANNER_REBUILD';"), 0LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE name IN ('RECURRENCE', 'PLANNER_CHANGES');"), 2LL);
+    CHECK_EQ(query_int(db, "SELECT MAX(rowid) FROM PLANNER;"), 10LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'PLANNER' "
+                           "AND sql LIKE '%AUTOINCREMENT%';"), 1LL);
+    CHECK_EQ(query_int(db, "SELECT seq FROM sqlite_sequence WHERE name = 'PLANNER';"), 10LL);
+
+    // New tasks follow the old IDs
+    std::string task = "After the migration", due_date = "2026-10-18";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+    CHECK_EQ(static_cast<long long>(sqlite3_last_insert_rowid(db.db)), 11LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(schema, rebuilds_for_autoincrement)
+{
+    // A version 1 planner goes through every later step before the
+    // AUTOINCREMENT rebuild, so that rebuild sees the index, the search and
+    // change-log triggers and a log that remembers a completed ID 40
+    TempDir dir;
+    std::vector<StoredRow> before;
+    {
+        DB db(dir.file("planner.db"), test_db_options());
+        REQUIRE(exec(db, "CREATE TABLE PLANNER(ID INTEGER PRIMARY KEY, TASK TEXT NOT NULL, "
+                           "DUE_DATE VARCHAR(10));") == SQLITE_OK);
+        for (int i = 1; i <= 8; i++) {
+            REQUIRE(exec(db, "INSERT INTO PLANNER VALUES (" + std::to_string(i * 3) + ", 'task " +
+                               std::to_string(i) + "', '2026-11-0" + std::to_string(i) + "');") == SQLITE_OK);
+        }
+        REQUIRE(exec(db, "CREATE TABLE PLANNER_CHANGES(SEQ INTEGER PRIMARY KEY AUTOINCREMENT, "
+                           "TASK_ID INTEGER NOT NULL, KIND INTEGER NOT NULL);") == SQLITE_OK);
+        REQUIRE(exec(db, "INSERT INTO PLANNER_CHANGES(TASK_ID, KIND) VALUES (40, " +
+                           std::to_string(CHANGE_COMPLETED) + ");") == SQLITE_OK);
+        REQUIRE(exec(db, "PRAGMA user_version = 1;") == SQLITE_OK);
+        before = stored_rows(db);
+    }
+
+    DB db(dir.file("planner.db"), test_db_options());
+    std::vector<MigrationProgress> progress;
+    REQUIRE(db.migrate(small_chunks(&progress)) == SQLITE_OK);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+    CHECK(stored_rows(db) == before);
+    check_keys(db);
+
+    int rebuild_chunks = 0;
+    for (const MigrationProgress& step : progress) {
+        if (step.version == 7 && step.done > 0)
+            rebuild_chunks++;
+    }
+    CHECK(rebuild_chunks >= 2);
+
+    // What the old table carried was made again on the new one
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'PLANNER' "
+                           "AND sql LIKE '%AUTOINCREMENT%';"), 1LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'PLANNER_ORDER_KEY_IDX';"), 1LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' "
+                           "AND name LIKE 'PLANNER_CHANGES_%';"), 4LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' "
+                           "AND name LIKE 'PLANNER_REBUILD_%';"), 0LL);
+    if (sqlite3_compileoption_used("ENABLE_FTS5")) {
+        CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'trigger' "
+                               "AND name LIKE 'PLANNER_FTS_%';"), 3LL);
+        CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM PLANNER_FTS WHERE PLANNER_FTS MATCH 'task';"), 8LL);
+    }
+
+    // New IDs start past the logged one, and the change log still follows
+    std::string task = "After the rebuild", due_date = "2026-12-01";
+    REQUIRE(db.insertTask(task, due_date) == SQLITE_OK);
+    CHECK_EQ(static_cast<long long>(sqlite3_last_insert_rowid(db.db)), 41LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM PLANNER_CHANGES WHERE TASK_ID = 41;"), 1LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM sqlite_sequence WHERE name = 'PLANNER';"), 1LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(schema, second_run_is_a_no_op)
+{
+    TempDir dir;
+    std::string path = copy_fixture(dir);
+    std::vector<StoredRow> migrated;
+    {
+        DB db(path, test_db_options());
+        REQUIRE(db.createPlanner() == SQLITE_OK);
+        migrated = stored_rows(db);
+    }
+
+    DB db(path, test_db_options());
+    long long schema_cookie = query_int(db, "PRAGMA schema_version;");
+    std::vector<MigrationProgress> progress;
+    REQUIRE(db.migrate(small_chunks(&progress)) == SQLITE_OK);
+    CHECK(progress.empty());
+    CHECK_EQ(query_int(db, "PRAGMA schema_version;"), schema_cookie);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+    CHECK(stored_rows(db) == migrated);
+    check_keys(db);
+}
+// --------------------------------------------------------------------------------
+
+TEST(schema, failed_rebuild_chunk_rolls_back)
+{
+    TempDir dir;
+    std::string path = copy_fixture(dir);
+    DB db(path, test_db_options());
+    std::vector<StoredRow> before = stored_rows(db);
+
+    // A copy of ID 7 fails, in the third chunk of three rows
+    REQUIRE(sqlite3_exec(db.db,
+                         "CREATE TABLE PLANNER_REBUILD(ID INTEGER PRIMARY KEY, TASK TEXT NOT NULL, DUE_DATE VARCHAR(10));"
+                         "CREATE TRIGGER FAIL_CHUNK BEFORE INSERT ON PLANNER_REBUILD WHEN new.ID = 7 "
+                         "BEGIN SELECT RAISE(ABORT, 'chunk failed'); END;",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    std::vector<MigrationProgress> progress;
+    CHECK(db.migrate(small_chunks(&progress)) != SQLITE_OK);
+
+    // The first two chunks are kept, the failed one left nothing behind,
+    // and the original table and version are untouched
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM PLANNER_REBUILD;"), 6LL);
+    CHECK_EQ(query_int(db, "SELECT MAX(ID) FROM PLANNER_REBUILD;"), 6LL);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), 0LL);
+    CHECK_EQ(SchemaMigrator(db).currentVersion(), 0);
+    CHECK(stored_rows(db) == before);
+    CHECK(sqlite3_get_autocommit(db.db) != 0);
+
+    // Once the fault is gone the migration picks up where it stopped
+    REQUIRE(sqlite3_exec(db.db, "DROP TRIGGER FAIL_CHUNK;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    progress.clear();
+    REQUIRE(db.migrate(small_chunks(&progress)) == SQLITE_OK);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+    CHECK(stored_rows(db) == before);
+    check_keys(db);
+}
+// --------------------------------------------------------------------------------
+
+TEST(schema, failed_due_key_chunk_rolls_back)
+{
+    TempDir dir;
+    std::string path = copy_fixture(dir);
+    DB db(path, test_db_options());
+    std::vector<StoredRow> before = stored_rows(db);
+
+    // Run only the first step, then make filling DUE_KEY fail at ID 5
+    REQUIRE(sqlite3_exec(db.db,
+                         "CREATE TABLE PLANNER_REBUILD(ID INTEGER PRIMARY KEY, TASK TEXT NOT NULL, DUE_DATE VARCHAR(10), "
+                         "DUE_KEY INTEGER);"
+                         "CREATE TRIGGER FAIL_CHUNK BEFORE UPDATE OF DUE_KEY ON PLANNER_REBUILD WHEN new.ID = 5 "
+                         "BEGIN SELECT RAISE(ABORT, 'chunk failed'); END;",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    std::vector<MigrationProgress> progress;
+    CHECK(db.migrate(small_chunks(&progress)) != SQLITE_OK);
+
+    // Version 1 is in place; the chunk holding ID 5 (IDs 4-6) was undone
+    // as a whole, the one before it is kept
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), 1LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM PLANNER WHERE DUE_KEY IS NOT NULL;"), 3LL);
+    CHECK_EQ(query_int(db, "SELECT MAX(ID) FROM PLANNER WHERE DUE_KEY IS NOT NULL;"), 3LL);
+    CHECK(stored_rows(db) == before);
+    CHECK(sqlite3_get_autocommit(db.db) != 0);
+
+    REQUIRE(sqlite3_exec(db.db, "DROP TRIGGER FAIL_CHUNK;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    REQUIRE(db.migrate(small_chunks(&progress)) == SQLITE_OK);
+    CHECK_EQ(query_int(db, "PRAGMA user_version;"), static_cast<long long>(SCHEMA_VERSION));
+    CHECK(stored_rows(db) == before);
+    check_keys(db);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,190 @@
+// ================================================================================
+// ================================================================================
+// - File:    search_test.cpp
+// - Purpose: Full-text search through DB::searchTasks: how the query text
+//            becomes an FTS5 MATCH expression, bm25 ranking with the due
+//            order tiebreak, the due-date range and the triggers that keep
+//            the index in step with the table.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/date_key.hpp"
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// A SQLite built without FTS5 has no search to test.
+static bool searchable()
+{
+    return sqlite3_compileoption_used("ENABLE_FTS5") != 0;
+}
+// --------------------------------------------------------------------------------
+
+// The IDs query finds, in the order they come back.
+static std::vector<int> search(DB& db, const std::string& query, int limit = 100)
+{
+    std::vector<TaskRow> rows;
+    CHECK_EQ(db.searchTasks(query, limit, rows), SQLITE_OK);
+    std::vector<int> ids;
+    for (const TaskRow& row : rows) {
+        ids.push_back(row.id);
+    }
+    return ids;
+}
+// --------------------------------------------------------------------------------
+
+// A fresh planner holding tasks, which take IDs 1, 2, ... in order.
+static void load(DB& db, std::vector<Task> tasks)
+{
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    REQUIRE(db.bulkInsertTasks(tasks) == SQLITE_OK);
+}
+// --------------------------------------------------------------------------------
+
+TEST(search, prefixes_and_phrases)
+{
+    if (!searchable())
+        return;
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    load(db, {Task{"password reset", "2026-10-18"}, Task{"pass the salt", "2026-10-19"},
+              Task{"passport renewal", "2026-10-20"}, Task{"tax return due", "2026-10-21"},
+              Task{"return tax forms", "2026-10-22"}});
+
+    // A whole word matches only that token; a trailing * any word it starts
+    CHECK(search(db, "pass") == std::vector<int>({2}));
+    CHECK_EQ(search(db, "pass*").size(), static_cast<size_t>(3));
+    // A star standing alone is no prefix
+    CHECK(search(db, "pass *") == std::vector<int>({2}));
+
+    // Quoted words must be adjacent and in order; loose words need not be
+    CHECK(search(db, "\"tax return\"") == std::vector<int>({4}));
+    CHECK_EQ(search(db, "tax return").size(), static_cast<size_t>(2));
+    CHECK(search(db, "\"return t\"*") == std::vector<int>({5}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(search, keywords_and_punctuation_match_literally)
+{
+    if (!searchable())
+        return;
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    load(db, {Task{"Call Bob AND Alice", "2026-10-18"}, Task{"NEAR the dock", "2026-10-19"},
+              Task{"task: fix the sink", "2026-10-20"}, Task{"C++ homework", "2026-10-21"},
+              Task{"bob's alice", "2026-10-22"}});
+
+    CHECK(search(db, "AND") == std::vector<int>({1}));
+    CHECK(search(db, "near") == std::vector<int>({2}));
+    // OR and NOT are words to find, not operators
+    CHECK(search(db, "bob OR alice").empty());
+    CHECK(search(db, "NOT dock").empty());
+    // A column filter is just two words in a row
+    CHECK(search(db, "TASK:fix") == std::vector<int>({3}));
+    CHECK(search(db, "c++") == std::vector<int>({4}));
+    CHECK(search(db, "(sink)") == std::vector<int>({3}));
+    // Unbalanced and doubled quotes are taken apart, not passed through
+    CHECK(search(db, "\"bob's") == std::vector<int>({5}));
+    CHECK(search(db, "homework\"\"") == std::vector<int>({4}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(search, nothing_searchable_is_misuse)
+{
+    if (!searchable())
+        return;
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    load(db, {Task{"anything", "2026-10-18"}});
+
+    std::vector<TaskRow> rows;
+    for (std::string query : {"", "   ", "?! --", "* *", "\"\"", "\"...\"*"}) {
+        CHECK_EQ(db.searchTasks(query, 10, rows), SQLITE_MISUSE);
+    }
+    CHECK(rows.empty());
+}
+// --------------------------------------------------------------------------------
+
+TEST(search, best_match_first_then_due_order)
+{
+    if (!searchable())
+        return;
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    load(db, {Task{"water the plants on the balcony and in the hall", "2026-10-01"},
+              Task{"water plants", "2026-10-20"},
+              Task{"water plants", "someday"},
+              Task{"water plants", "2026-10-18"},
+              Task{"water plants", "2026-10-20", MAX_PRIORITY},
+              Task{"plants", "2026-10-19"}});
+
+    // The long description ranks below the short ones though it is due
+    // first; equal matches go by due date, then priority, then ID, with
+    // the unparsable date last
+    CHECK(search(db, "water plants") == std::vector<int>({4, 5, 2, 3, 1}));
+    CHECK(search(db, "water plants", 2) == std::vector<int>({4, 5}));
+    CHECK_EQ(search(db, "plants").front(), 6);
+}
+// --------------------------------------------------------------------------------
+
+TEST(search, range_limits_the_due_dates)
+{
+    if (!searchable())
+        return;
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    load(db, {Task{"report", "2026-10-18T23:59"}, Task{"report", "2026-10-19"},
+              Task{"report", "2026-10-20T23:59", MAX_PRIORITY}, Task{"report", "2026-10-21"},
+              Task{"report", "whenever"}, Task{"other", "2026-10-19"}});
+
+    // from <= due date < to, whatever the priority; invalid dates never
+    // fall in a range
+    std::vector<TaskRow> rows;
+    REQUIRE(db.searchTasks("report", 10, parse_due_key("2026-10-19"), parse_due_key("2026-10-21"), rows) == SQLITE_OK);
+    std::vector<int> ids;
+    for (const TaskRow& row : rows) {
+        ids.push_back(row.id);
+    }
+    CHECK(ids == std::vector<int>({2, 3}));
+}
+// --------------------------------------------------------------------------------
+
+TEST(search, index_follows_updates_and_completions)
+{
+    if (!searchable())
+        return;
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    load(db, {Task{"renew passport", "2026-10-18"}, Task{"renew library card", "2026-10-19"}});
+    int inserted = insert_task(db, "renew lease", "2026-10-20");
+    CHECK_EQ(search(db, "renew").size(), static_cast<size_t>(3));
+
+    UpdateRow rename{"TASK", "collect passport", "ID", "1"};
+    REQUIRE(db.updatePlanner(rename) == SQLITE_OK);
+    // The shorter description is the better match
+    CHECK(search(db, "renew") == std::vector<int>({inserted, 2}));
+    CHECK(search(db, "collect") == std::vector<int>({1}));
+
+    // A date change leaves the text alone
+    UpdateRow move{"DUE_DATE", "2026-11-01", "ID", "1"};
+    REQUIRE(db.updatePlanner(move) == SQLITE_OK);
+    CHECK(search(db, "passport") == std::vector<int>({1}));
+
+    REQUIRE(db.completeTask(2) == SQLITE_OK);
+    CHECK(search(db, "renew") == std::vector<int>({inserted}));
+    CHECK(search(db, "library").empty());
+    REQUIRE(db.completeTask(1) == SQLITE_OK);
+    CHECK(search(db, "passport").empty());
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,291 @@
+// ================================================================================
+// ================================================================================
+// - File:    server_test.cpp
+// - Purpose: The planner server over a Unix socket in a temporary directory:
+//            pipelined requests, requests split across writes, ERR replies
+//            and writes seen by the reads that follow them.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/client.hpp"
+#include "../src/include/server.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ================================================================================
+// ================================================================================
+
+// A server on its own thread for the lifetime of the fixture.
+class ServerFixture
+{
+    private:
+
+        std::thread loop;
+// ================================================================================
+
+    public:
+
+        TempDir dir;
+        DB db;
+        PlannerServer* server;
+        std::string socket_path;
+// --------------------------------------------------------------------------------
+
+        ServerFixture() : db(dir.file("planner.db"), test_db_options()), server(nullptr)
+        {
+            REQUIRE(db.createPlanner() == SQLITE_OK);
+            ServerOptions options;
+            options.workers = 2;
+            options.refresh_ms = 0;
+            options.max_next = 100;
+            server = new PlannerServer(db, options);
+            socket_path = dir.file("planner.sock");
+            REQUIRE(server->listen(socket_path) == 0);
+            loop = std::thread([this] { server->run(); });
+        }
+// --------------------------------------------------------------------------------
+
+        ~ServerFixture()
+        {
+            server->requestStop();
+            loop.join();
+            delete server;
+        }
+};
+// --------------------------------------------------------------------------------
+
+static int connect_raw(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+// --------------------------------------------------------------------------------
+
+static void write_raw(int fd, const std::string& text)
+{
+    size_t sent = 0;
+    while (sent < text.size()) {
+        ssize_t count = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        REQUIRE(count > 0);
+        sent += static_cast<size_t>(count);
+    }
+}
+// --------------------------------------------------------------------------------
+
+// Everything the server sends until it closes the connection.
+static std::string read_to_end(int fd)
+{
+    std::string text;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        text.append(buffer, static_cast<size_t>(count));
+    }
+    return text;
+}
+// --------------------------------------------------------------------------------
+
+// The rows of a successful response; fails the test on ERR.
+static std::vector<std::vector<std::string>> rows_of(PlannerClient& client, const std::vector<std::string>& request)
+{
+    ServerResponse response;
+    REQUIRE(client.call(request, response));
+    CHECK(response.ok);
+    return response.rows;
+}
+// --------------------------------------------------------------------------------
+
+TEST(server, pipelined_requests_answer_in_order)
+{
+    ServerFixture fixture;
+    PlannerClient client;
+    REQUIRE(client.connectTo(fixture.socket_path) == 0);
+
+    // Every request goes out before any answer is read
+    client.send({"ADD", "water\tplants", "2026-10-20"});
+    client.send({"ADD", "pay rent", "2026-10-19"});
+    client.send({"ADD", "call back", "2026-10-20T09:00", "200"});
+    client.send({"ADD", "ship it", "2026-10-20", "200"});
+    client.send({"COUNT"});
+    client.send({"NEXT", "3"});
+    client.send({"RANGE", "2026-10-20", "2026-10-21"});
+    client.send({"FIND", "1"});
+    client.send({"PING"});
+    REQUIRE(client.flush());
+
+    ServerResponse response;
+    for (const char* id : {"1", "2", "3", "4"}) {
+        REQUIRE(client.receive(response));
+        REQUIRE(response.ok && response.rows.size() == 1);
+        CHECK_EQ(response.rows[0][0], std::string(id));
+    }
+    REQUIRE(client.receive(response));
+    REQUIRE(response.rows.size() == 1);
+    CHECK_EQ(response.rows[0][0], std::string("4"));
+
+    // Earliest first, then the higher priority; every row carries it
+    REQUIRE(client.receive(response));
+    std::vector<std::vector<std::string>> next = {
+        {"2", "pay rent", "2026-10-19", "0"},
+        {"4", "ship it", "2026-10-20", "200"},
+        {"1", "water\tplants", "2026-10-20", "0"}};
+    CHECK(response.rows == next);
+
+    REQUIRE(client.receive(response));
+    std::vector<std::string> range_ids;
+    for (const auto& row : response.rows) {
+        range_ids.push_back(row[0]);
+    }
+    std::vector<std::string> expected_range = {"4", "1", "3"};
+    CHECK(range_ids == expected_range);
+
+    REQUIRE(client.receive(response));
+    REQUIRE(response.rows.size() == 1);
+    CHECK_EQ(response.rows[0][1], std::string("water\tplants"));
+    REQUIRE(client.receive(response));
+    CHECK(response.ok && response.rows.empty());
+}
+// --------------------------------------------------------------------------------
+
+TEST(server, requests_split_across_writes)
+{
+    ServerFixture fixture;
+    int fd = connect_raw(fixture.socket_path);
+    REQUIRE(fd >= 0);
+
+    // Pieces of lines wait for the rest; the answers keep request order
+    write_raw(fd, "PI");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write_raw(fd, "NG\nADD\tsplit");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write_raw(fd, "\\ttask\t2026-10-18\nCOU");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write_raw(fd, "NT\nNEXT\n");
+
+    // A client that closes its side still gets every answer
+    shutdown(fd, SHUT_WR);
+    CHECK_EQ(read_to_end(fd), std::string("OK 0\nOK 1\n1\nOK 1\n1\nOK 1\n1\tsplit\\ttask\t2026-10-18\t0\n"));
+    close(fd);
+}
+// --------------------------------------------------------------------------------
+
+TEST(server, bad_requests_get_err)
+{
+    ServerFixture fixture;
+    PlannerClient client;
+    REQUIRE(client.connectTo(fixture.socket_path) == 0);
+    rows_of(client, {"ADD", "only task", "2026-10-18"});
+
+    std::vector<std::vector<std::string>> requests = {
+        {"FROB"},
+        {"NEXT", "many"},
+        {"NEXT", "101"},
+        {"NEXT", "1", "2"},
+        {"FIND", "-1"},
+        {"RANGE", "2026-10-18", "someday"},
+        {"ADD", "task", "2026-13-01"},
+        {"ADD", "task", "2026-10-18", "256"},
+        {"COMPLETE", "99"},
+        {"UPDATE", "1", "colour", "red"},
+        {"UPDATE", "1", "priority", "high"},
+        {"UPDATE", "99", "task", "ghost"},
+        {""}};
+    for (const auto& request : requests) {
+        client.send(request);
+    }
+    REQUIRE(client.flush());
+    ServerResponse response;
+    for (size_t i = 0; i < requests.size(); i++) {
+        REQUIRE(client.receive(response));
+        CHECK(!response.ok);
+        CHECK(!response.error.empty());
+    }
+
+    // Nothing changed, and the connection still works
+    auto count = rows_of(client, {"COUNT"});
+    REQUIRE(count.size() == 1);
+    CHECK_EQ(count[0][0], std::string("1"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(server, reads_see_the_writes_before_them)
+{
+    ServerFixture fixture;
+    PlannerClient client;
+    REQUIRE(client.connectTo(fixture.socket_path) == 0);
+    rows_of(client, {"ADD", "later", "2026-10-25"});
+    rows_of(client, {"ADD", "sooner", "2026-10-19"});
+
+    // Each write is followed at once by a read in the same batch
+    client.send({"UPDATE", "1", "due_date", "2026-10-19"});
+    client.send({"NEXT"});
+    client.send({"UPDATE", "2", "priority", "9"});
+    client.send({"NEXT"});
+    client.send({"UPDATE", "2", "task", "renamed"});
+    client.send({"FIND", "2"});
+    client.send({"COMPLETE", "2"});
+    client.send({"NEXT", "5"});
+    client.send({"COUNT"});
+    REQUIRE(client.flush());
+
+    ServerResponse response;
+    auto next_ids = [&] {
+        std::vector<std::string> ids;
+        for (const auto& row : response.rows) {
+            ids.push_back(row[0]);
+        }
+        return ids;
+    };
+    std::vector<std::string> first = {"1"}, second = {"2"};
+
+    // Same day and priority: the lower ID; then the raised priority wins
+    REQUIRE(client.receive(response));
+    CHECK(response.ok);
+    REQUIRE(client.receive(response));
+    CHECK(next_ids() == first);
+    REQUIRE(client.receive(response));
+    CHECK(response.ok);
+    REQUIRE(client.receive(response));
+    CHECK(next_ids() == second);
+
+    REQUIRE(client.receive(response));
+    REQUIRE(client.receive(response));
+    REQUIRE(response.rows.size() == 1);
+    CHECK_EQ(response.rows[0][1], std::string("renamed"));
+    CHECK_EQ(response.rows[0][3], std::string("9"));
+
+    REQUIRE(client.receive(response));
+    CHECK(response.ok);
+    REQUIRE(client.receive(response));
+    CHECK(next_ids() == first);
+    REQUIRE(client.receive(response));
+    REQUIRE(response.rows.size() == 1);
+    CHECK_EQ(response.rows[0][0], std::string("1"));
+
+    // What the server wrote is on disk
+    CHECK_EQ(fixture.db.countTasks(), 1LL);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,206 @@
+// ================================================================================
+// ================================================================================
+// - File:    sharded_planner_test.cpp
+// - Purpose: Shard placement and the k-way merge behind ShardedPlanner's
+//            fan-out queries, checked against a sort of every shard's rows.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/sharded_planner.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+typedef std::tuple<OrderKey, int, size_t> MergeKey;     // order key, ID, shard
+// --------------------------------------------------------------------------------
+
+static std::vector<std::string> shard_files(const TempDir& dir, size_t count)
+{
+    std::vector<std::string> files;
+    for (size_t i = 0; i < count; i++) {
+        files.push_back(dir.file("shard" + std::to_string(i) + ".db"));
+    }
+    return files;
+}
+// --------------------------------------------------------------------------------
+
+// Every row of every shard, sorted the way the merge promises.
+static std::vector<MergeKey> sorted_rows(ShardedPlanner& planner)
+{
+    std::vector<MergeKey> rows;
+    for (size_t shard = 0; shard < planner.shardCount(); shard++) {
+        PlannerStore::ReadLease lease = planner.shard(shard).reader();
+        for (const RowView& row : lease->scanTasks()) {
+            if (row.due_key != INVALID_DUE_KEY)
+                rows.emplace_back(make_order_key(row.due_key, row.priority), row.id, shard);
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+// --------------------------------------------------------------------------------
+
+static std::vector<MergeKey> merge_keys(const std::vector<ShardTaskRow>& rows)
+{
+    std::vector<MergeKey> keys;
+    for (const ShardTaskRow& row : rows) {
+        keys.emplace_back(make_order_key(row.task.due_key, row.task.priority), row.task.id, row.shard);
+    }
+    return keys;
+}
+// --------------------------------------------------------------------------------
+
+TEST(sharded_planner, placement_is_stable)
+{
+    // FNV-1a reference values: the hash must not change between builds
+    CHECK_EQ(shard_hash(""), 0xcbf29ce484222325ULL);
+    CHECK_EQ(shard_hash("a"), 0xaf63dc4c8601ec8cULL);
+
+    TempDir dir;
+    ShardedPlanner planner(shard_files(dir, 3));
+    REQUIRE(planner.shardCount() == 3);
+    for (const char* project : {"home", "work", "garden", "taxes"}) {
+        size_t first = planner.shardFor(project);
+        CHECK_EQ(first, static_cast<size_t>(shard_hash(project) % 3));
+
+        // Every task of a project lands on its shard
+        for (int i = 0; i < 3; i++) {
+            size_t shard = SIZE_MAX;
+            std::string task = project;
+            task += std::to_string(i);
+            std::future<int> done = planner.insertTask(task, "2026-10-18", project, &shard);
+            CHECK_EQ(done.get(), SQLITE_OK);
+            CHECK_EQ(shard, first);
+        }
+    }
+    CHECK_EQ(planner.countTasks(), 12LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(sharded_planner, merge_matches_a_global_sort)
+{
+    TempDir dir;
+    ShardedPlanner planner(shard_files(dir, 3));
+
+    // Each shard gets the same due dates, so IDs and order keys collide
+    // across shards and the shard index has to break the tie; shard 2
+    // holds far more rows than the others
+    uint64_t state = 7;
+    for (size_t shard = 0; shard < planner.shardCount(); shard++) {
+        std::vector<Task> tasks;
+        size_t count = shard == 2 ? 600 : 150;
+        for (size_t i = 0; i < count; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int64_t minutes = 29000000 + static_cast<int64_t>((state >> 33) % 40) * 60;
+            tasks.push_back(Task{"t", format_due_key(due_key_from_minutes(minutes))});
+        }
+        int priority = static_cast<int>(shard % 2) * 9;
+        std::future<int> done = planner.shard(shard).write([&tasks, priority](DB& db) {
+            int rc = db.bulkInsertTasks(tasks);
+            for (int id = 1; rc == SQLITE_OK && id <= 50; id += 7) {
+                rc = db.setPriority(id, priority);
+            }
+            return rc;
+        });
+        REQUIRE(done.get() == SQLITE_OK);
+    }
+    std::vector<MergeKey> expected = sorted_rows(planner);
+    REQUIRE(expected.size() == 900);
+
+    for (int count : {0, 1, 5, 149, 151, 900, 2000}) {
+        std::vector<ShardTaskRow> rows;
+        REQUIRE(planner.nextTasks(count, rows) == SQLITE_OK);
+        size_t want = std::min(static_cast<size_t>(count), expected.size());
+        REQUIRE(rows.size() == want);
+        CHECK(merge_keys(rows) == std::vector<MergeKey>(expected.begin(), expected.begin() + want));
+    }
+
+    DueKey from = due_key_from_minutes(29000000 + 10 * 60);
+    DueKey to = due_key_from_minutes(29000000 + 20 * 60);
+    std::vector<MergeKey> in_range, overdue;
+    for (const MergeKey& key : expected) {
+        DueKey due = order_key_due(std::get<0>(key));
+        if (due >= from && due < to)
+            in_range.push_back(key);
+        if (due < from)
+            overdue.push_back(key);
+    }
+
+    std::vector<ShardTaskRow> rows;
+    REQUIRE(planner.tasksDueBetween(from, to, rows) == SQLITE_OK);
+    CHECK(merge_keys(rows) == in_range);
+    rows.clear();
+    REQUIRE(planner.overdueTasks(from, rows) == SQLITE_OK);
+    CHECK(merge_keys(rows) == overdue);
+}
+// --------------------------------------------------------------------------------
+
+TEST(sharded_planner, empty_shards_merge_cleanly)
+{
+    TempDir dir;
+    ShardedPlanner planner(shard_files(dir, 4));
+    std::vector<ShardTaskRow> rows;
+    REQUIRE(planner.nextTasks(10, rows) == SQLITE_OK);
+    CHECK(rows.empty());
+
+    REQUIRE(planner.shard(3).insertTask("only", "2026-10-18").get() == SQLITE_OK);
+    REQUIRE(planner.nextTasks(10, rows) == SQLITE_OK);
+    REQUIRE(rows.size() == 1);
+    CHECK_EQ(rows[0].shard, static_cast<size_t>(3));
+    CHECK_EQ(rows[0].task.task, std::string("only"));
+}
+// --------------------------------------------------------------------------------
+
+TEST(sharded_planner, reports_a_shard_that_cannot_open)
+{
+    TempDir dir;
+    std::ostringstream out;
+    std::streambuf* cout_buf = std::cout.rdbuf(out.rdbuf());
+    {
+        ShardedPlanner planner(shard_files(dir, 2));
+        CHECK_EQ(planner.status(), SQLITE_OK);
+        CHECK_EQ(planner.shard(1).status(), SQLITE_OK);
+    }
+    // Closing is silent
+    std::string closing = out.str();
+    std::cout.rdbuf(cout_buf);
+    CHECK(closing.empty());
+
+    std::vector<std::string> files = shard_files(dir, 2);
+    files.push_back(dir.file("missing/shard2.db"));
+    cout_buf = std::cout.rdbuf(out.rdbuf());
+    {
+        ShardedPlanner planner(files);
+        CHECK(planner.status() != SQLITE_OK);
+        CHECK_EQ(planner.shard(0).status(), SQLITE_OK);
+        CHECK(planner.shard(2).status() != SQLITE_OK);
+    }
+    std::cout.rdbuf(cout_buf);
+}
+// --------------------------------------------------------------------------------
+
+TEST(sharded_planner, a_store_without_readers_is_refused)
+{
+    TempDir dir;
+    PlannerStoreOptions options;
+    options.readers = 0;
+    PlannerStore store(dir.file("planner.db"), options);
+    CHECK_EQ(store.status(), SQLITE_MISUSE);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,129 @@
+// ================================================================================
+// ================================================================================
+// - File:    statement_test.cpp
+// - Purpose: StatementCache hits and misses, statements held by two callers
+//            at once and the cap on cached statements.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/statement.hpp"
+#include <string>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// An in-memory connection with a cache of its own; the cache is cleared
+// before the connection closes, as DB::closeDB does.
+struct CacheFixture {
+    sqlite3* db = nullptr;
+    StatementCache cache;
+
+    CacheFixture() { sqlite3_open(":memory:", &db); }
+    ~CacheFixture()
+    {
+        cache.clear();
+        sqlite3_close(db);
+    }
+};
+// --------------------------------------------------------------------------------
+
+static std::string select_n(int n)
+{
+    return "SELECT " + std::to_string(n) + ";";
+}
+// --------------------------------------------------------------------------------
+
+// Steps statement and returns its one integer column.
+static int step_int(Statement& statement)
+{
+    if (sqlite3_step(statement.get()) != SQLITE_ROW)
+        return -1;
+    int value = sqlite3_column_int(statement.get(), 0);
+    statement.release();
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+TEST(statement, repeated_query_misses_once_then_hits)
+{
+    CacheFixture fixture;
+    for (int i = 0; i < 5; i++) {
+        Statement statement;
+        REQUIRE(fixture.cache.acquire(fixture.db, "SELECT ?1 + 1;", statement) == SQLITE_OK);
+        sqlite3_bind_int(statement.get(), 1, i);
+        CHECK_EQ(step_int(statement), i + 1);
+    }
+    StatementCacheStats stats = fixture.cache.stats();
+    CHECK_EQ(stats.misses, 1ULL);
+    CHECK_EQ(stats.hits, 4ULL);
+    CHECK_EQ(stats.cached, static_cast<size_t>(1));
+
+    // Released statements come back reset and unbound
+    Statement statement;
+    REQUIRE(fixture.cache.acquire(fixture.db, "SELECT ?1 + 1;", statement) == SQLITE_OK);
+    REQUIRE(sqlite3_step(statement.get()) == SQLITE_ROW);
+    CHECK_EQ(sqlite3_column_type(statement.get(), 0), SQLITE_NULL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(statement, a_held_statement_is_not_shared)
+{
+    CacheFixture fixture;
+    Statement outer, inner;
+    REQUIRE(fixture.cache.acquire(fixture.db, select_n(7), outer) == SQLITE_OK);
+    REQUIRE(fixture.cache.acquire(fixture.db, select_n(7), inner) == SQLITE_OK);
+    CHECK(outer.get() != inner.get());
+    CHECK_EQ(fixture.cache.stats().misses, 2ULL);
+    CHECK_EQ(fixture.cache.stats().cached, static_cast<size_t>(1));
+
+    // The private copy is finalized; the cached one is handed out again
+    sqlite3_stmt* cached = outer.get();
+    inner.release();
+    outer.release();
+    Statement again;
+    REQUIRE(fixture.cache.acquire(fixture.db, select_n(7), again) == SQLITE_OK);
+    CHECK(again.get() == cached);
+    CHECK_EQ(fixture.cache.stats().hits, 1ULL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(statement, full_cache_prepares_uncached)
+{
+    CacheFixture fixture;
+    const int distinct = 200;
+    for (int n = 0; n < distinct; n++) {
+        Statement statement;
+        REQUIRE(fixture.cache.acquire(fixture.db, select_n(n), statement) == SQLITE_OK);
+        CHECK_EQ(step_int(statement), n);
+    }
+    StatementCacheStats full = fixture.cache.stats();
+    CHECK_EQ(full.misses, static_cast<uint64_t>(distinct));
+    REQUIRE(full.cached > 0 && full.cached < static_cast<size_t>(distinct));
+
+    // Past the cap nothing is evicted: the early statements still hit and
+    // the late ones are prepared afresh every time, and still work
+    Statement statement;
+    REQUIRE(fixture.cache.acquire(fixture.db, select_n(0), statement) == SQLITE_OK);
+    CHECK_EQ(step_int(statement), 0);
+    REQUIRE(fixture.cache.acquire(fixture.db, select_n(distinct - 1), statement) == SQLITE_OK);
+    CHECK_EQ(step_int(statement), distinct - 1);
+
+    StatementCacheStats after = fixture.cache.stats();
+    CHECK_EQ(after.hits, full.hits + 1);
+    CHECK_EQ(after.misses, full.misses + 1);
+    CHECK_EQ(after.cached, full.cached);
+
+    fixture.cache.clear();
+    CHECK_EQ(fixture.cache.stats().cached, static_cast<size_t>(0));
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
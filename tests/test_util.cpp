@@ -0,0 +1,146 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_util.cpp
+// - Purpose: Test registry, temporary directories and the test runner.
+//
+//            planner_tests [SUITE]   runs every case, or only SUITE's
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// ================================================================================
+// ================================================================================
+
+static int failures_in_case = 0;
+// --------------------------------------------------------------------------------
+
+std::vector<TestCase>& test_registry()
+{
+    static std::vector<TestCase> registry;
+    return registry;
+}
+// --------------------------------------------------------------------------------
+
+TestRegistrar::TestRegistrar(const char* suite, const char* name, void (*run)())
+{
+    test_registry().push_back(TestCase{suite, name, run});
+}
+// --------------------------------------------------------------------------------
+
+void test_failure(const char* file, int line, const std::string& message)
+{
+    failures_in_case++;
+    std::cerr << file << ":" << line << ": " << message << std::endl;
+}
+// --------------------------------------------------------------------------------
+
+TempDir::TempDir()
+{
+    std::string pattern = (std::filesystem::temp_directory_path() / "planner_test_XXXXXX").string();
+    std::vector<char> buffer(pattern.begin(), pattern.end());
+    buffer.push_back('\0');
+    if (mkdtemp(buffer.data()) == nullptr) {
+        std::cerr << "Error creating a temporary directory: " << std::strerror(errno) << std::endl;
+        std::abort();
+    }
+    path = buffer.data();
+}
+// --------------------------------------------------------------------------------
+
+TempDir::~TempDir()
+{
+    std::error_code ignored;
+    std::filesystem::remove_all(path, ignored);
+}
+// --------------------------------------------------------------------------------
+
+std::string TempDir::file(const std::string& name) const
+{
+    return path + "/" + name;
+}
+// --------------------------------------------------------------------------------
+
+DBOptions test_db_options()
+{
+    DBOptions options;
+    options.quiet = true;
+    return options;
+}
+// --------------------------------------------------------------------------------
+
+std::string source_path(const std::string& relative)
+{
+    return std::string(PLANNER_SOURCE_DIR) + "/" + relative;
+}
+// --------------------------------------------------------------------------------
+
+long long query_int(DB& db, const std::string& sql, long long fallback)
+{
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db.db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Error preparing \"" << sql << "\": " << sqlite3_errmsg(db.db) << std::endl;
+        return fallback;
+    }
+    long long value = fallback;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+        value = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return value;
+}
+// --------------------------------------------------------------------------------
+
+int insert_task(DB& db, std::string task, std::string due_date)
+{
+    if (db.insertTask(task, due_date) != SQLITE_OK)
+        return -1;
+    return static_cast<int>(sqlite3_last_insert_rowid(db.db));
+}
+// --------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const char* only = argc > 1 ? argv[1] : nullptr;
+    int run = 0, failed = 0;
+    for (const TestCase& test : test_registry()) {
+        if (only && std::strcmp(only, test.suite) != 0)
+            continue;
+
+        failures_in_case = 0;
+        try {
+            test.run();
+        } catch (const TestAbort&) {
+        } catch (const std::exception& error) {
+            test_failure(__FILE__, __LINE__, std::string("uncaught exception: ") + error.what());
+        }
+        run++;
+        if (failures_in_case > 0)
+            failed++;
+        std::cout << (failures_in_case > 0 ? "[ FAIL ] " : "[  OK  ] ") << test.suite << "." << test.name << "\n";
+    }
+
+    std::cout << run - failed << " of " << run << " tests passed" << std::endl;
+    if (run == 0) {
+        std::cerr << "Error: no tests" << (only ? std::string(" in suite ") + only : std::string()) << std::endl;
+        return 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
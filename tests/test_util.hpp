@@ -0,0 +1,115 @@
+// ================================================================================
+// ================================================================================
+// - File:    test_util.hpp
+// - Purpose: A small self-contained test harness.  TEST(suite, name)
+//            registers a case; CHECK and CHECK_EQ record a failure and carry
+//            on, REQUIRE stops the case.  Each *_test.cpp file is one suite,
+//            registered with CTest under the suite's name.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#ifndef TEST_UTIL_HPP
+#define TEST_UTIL_HPP
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/include/db.hpp"
+// --------------------------------------------------------------------------------
+
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+// --------------------------------------------------------------------------------
+
+std::vector<TestCase>& test_registry();
+// --------------------------------------------------------------------------------
+
+struct TestRegistrar {
+    TestRegistrar(const char* suite, const char* name, void (*run)());
+};
+// --------------------------------------------------------------------------------
+
+// Thrown by REQUIRE to end the running case.
+struct TestAbort {};
+// --------------------------------------------------------------------------------
+
+void test_failure(const char* file, int line, const std::string& message);
+// --------------------------------------------------------------------------------
+
+template <typename A, typename B>
+void check_equal(const A& actual, const B& expected, const char* text, const char* file, int line)
+{
+    if (!(actual == expected)) {
+        std::ostringstream message;
+        message << "CHECK_EQ(" << text << "): got " << actual << ", expected " << expected;
+        test_failure(file, line, message.str());
+    }
+}
+// --------------------------------------------------------------------------------
+
+#define TEST(suite, name) \
+    static void suite##_##name(); \
+    static TestRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(condition) \
+    do { if (!(condition)) test_failure(__FILE__, __LINE__, "CHECK(" #condition ")"); } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    check_equal((actual), (expected), #actual ", " #expected, __FILE__, __LINE__)
+
+#define REQUIRE(condition) \
+    do { if (!(condition)) { test_failure(__FILE__, __LINE__, "REQUIRE(" #condition ")"); throw TestAbort(); } } while (0)
+// --------------------------------------------------------------------------------
+
+// A fresh directory under the system temp directory, removed with
+// everything in it when the object goes.
+class TempDir
+{
+    private:
+
+        std::string path;
+// ================================================================================
+
+    public:
+
+        TempDir();
+        ~TempDir();
+        TempDir(const TempDir&) = delete;
+        TempDir& operator=(const TempDir&) = delete;
+// --------------------------------------------------------------------------------
+
+        // path/name
+        std::string file(const std::string& name) const;
+};
+// --------------------------------------------------------------------------------
+
+// Options for test databases: quiet, so nothing lands on stdout.
+DBOptions test_db_options();
+// --------------------------------------------------------------------------------
+
+// A file in the source tree (e.g. "data/old planner/planner.db").
+std::string source_path(const std::string& relative);
+// --------------------------------------------------------------------------------
+
+// Runs sql and returns the first column of the first row as an integer,
+// or fallback if there is none.
+long long query_int(DB& db, const std::string& sql, long long fallback = -1);
+// --------------------------------------------------------------------------------
+
+// Inserts a task through DB::insertTask and returns its new ID, or -1.
+int insert_task(DB& db, std::string task, std::string due_date);
+// --------------------------------------------------------------------------------
+#endif
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file
@@ -0,0 +1,293 @@
+// ================================================================================
+// ================================================================================
+// - File:    write_pipeline_test.cpp
+// - Purpose: Group commits through the WritePipeline: every future resolving,
+//            per-mutation savepoints, a failed group commit, the batch size
+//            and delay limits and the metrics it keeps.
+//
+// Source Metadata
+// - Author:  Jillian Webb
+// - Date:    October 18, 2026
+// - Version: 1.0
+// - Copyright: Copyright 2024, Jilly Webb Inc.
+// ================================================================================
+// ================================================================================
+
+#include "test_util.hpp"
+#include "../src/include/write_pipeline.hpp"
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ================================================================================
+// ================================================================================
+
+// Holds the writer inside a one-mutation group until released, so whatever
+// is submitted meanwhile queues up and forms the next groups.
+class WriterGate
+{
+    private:
+
+        std::promise<void> entered;
+        std::promise<void> opened;
+        std::shared_future<void> open_signal;
+        std::future<int> result;
+// ================================================================================
+
+    public:
+
+        explicit WriterGate(WritePipeline& pipeline) : open_signal(opened.get_future().share())
+        {
+            std::shared_future<void> wait_for = open_signal;
+            std::promise<void>* started = &entered;
+            result = pipeline.submit([wait_for, started](DB&) {
+                started->set_value();
+                wait_for.wait();
+                return SQLITE_OK;
+            });
+            entered.get_future().wait();
+        }
+// --------------------------------------------------------------------------------
+
+        // Lets the writer go on and waits for the gate's own group.
+        int open()
+        {
+            opened.set_value();
+            return result.get();
+        }
+};
+// --------------------------------------------------------------------------------
+
+static uint64_t bucket_total(const uint64_t (&buckets)[WritePipelineMetrics::BUCKETS])
+{
+    uint64_t total = 0;
+    for (uint64_t count : buckets) {
+        total += count;
+    }
+    return total;
+}
+// --------------------------------------------------------------------------------
+
+TEST(write_pipeline, every_future_resolves)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    const int THREADS = 4, PER_THREAD = 100;
+    std::vector<std::future<int>> results[THREADS];
+    {
+        WritePipeline pipeline(db);
+        std::vector<std::thread> writers;
+        for (int t = 0; t < THREADS; t++) {
+            writers.emplace_back([&pipeline, &results, t] {
+                for (int i = 0; i < PER_THREAD; i++) {
+                    results[t].push_back(pipeline.insertTask("task " + std::to_string(i), "2026-10-18"));
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+
+        // The destructor commits what is still queued; these resolve first
+        for (int i = 0; i < 10; i++) {
+            results[0].push_back(pipeline.insertTask("late", "2026-10-19"));
+        }
+    }
+
+    size_t resolved = 0;
+    for (auto& thread_results : results) {
+        for (std::future<int>& result : thread_results) {
+            REQUIRE(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+            CHECK_EQ(result.get(), SQLITE_OK);
+            resolved++;
+        }
+    }
+    CHECK_EQ(resolved, static_cast<size_t>(THREADS * PER_THREAD + 10));
+    CHECK_EQ(db.countTasks(), static_cast<long long>(resolved));
+}
+// --------------------------------------------------------------------------------
+
+TEST(write_pipeline, a_failing_mutation_rolls_back_alone)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    WritePipeline pipeline(db);
+
+    WriterGate gate(pipeline);
+    std::future<int> before = pipeline.insertTask("before", "2026-10-18");
+    std::future<int> failing = pipeline.submit([](DB& db) {
+        std::string task = "undone", due_date = "2026-10-18";
+        db.insertTask(task, due_date);
+        return SQLITE_CONSTRAINT;
+    });
+    std::future<int> throwing = pipeline.submit([](DB& db) -> int {
+        std::string task = "thrown", due_date = "2026-10-18";
+        db.insertTask(task, due_date);
+        throw std::runtime_error("mutation failed");
+    });
+    std::future<int> after = pipeline.insertTask("after", "2026-10-19");
+    REQUIRE(gate.open() == SQLITE_OK);
+
+    CHECK_EQ(before.get(), SQLITE_OK);
+    CHECK_EQ(failing.get(), SQLITE_CONSTRAINT);
+    bool threw = false;
+    try {
+        throwing.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQ(after.get(), SQLITE_OK);
+
+    // The four were one group; only the two that failed are gone
+    CHECK_EQ(db.countTasks(), 2LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM PLANNER WHERE TASK IN ('undone', 'thrown');"), 0LL);
+    WritePipelineMetrics metrics = pipeline.metrics();
+    CHECK_EQ(metrics.batches, 2ULL);
+    CHECK_EQ(metrics.failed_mutations, 2ULL);
+    CHECK_EQ(metrics.failed_commits, 0ULL);
+    CHECK_EQ(metrics.batch_sizes[2], 1ULL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(write_pipeline, a_failed_commit_fails_the_whole_group)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    // A deferred foreign key is only checked when the group commits, after
+    // every savepoint in it has been released
+    REQUIRE(sqlite3_exec(db.db, "PRAGMA foreign_keys = ON;"
+                                "CREATE TABLE PARENT (ID INTEGER PRIMARY KEY);"
+                                "CREATE TABLE CHILD (PARENT_ID INTEGER REFERENCES PARENT(ID) "
+                                "DEFERRABLE INITIALLY DEFERRED);",
+                         NULL, NULL, NULL) == SQLITE_OK);
+    WritePipeline pipeline(db);
+
+    WriterGate gate(pipeline);
+    std::future<int> first = pipeline.insertTask("first", "2026-10-18");
+    std::future<int> orphan = pipeline.submit([](DB& db) {
+        return sqlite3_exec(db.db, "INSERT INTO CHILD VALUES (99);", NULL, NULL, NULL);
+    });
+    std::future<int> last = pipeline.insertTask("last", "2026-10-19");
+    REQUIRE(gate.open() == SQLITE_OK);
+
+    CHECK_EQ(first.get() & 0xff, SQLITE_CONSTRAINT);
+    CHECK_EQ(orphan.get() & 0xff, SQLITE_CONSTRAINT);
+    CHECK_EQ(last.get() & 0xff, SQLITE_CONSTRAINT);
+    CHECK_EQ(db.countTasks(), 0LL);
+    CHECK_EQ(query_int(db, "SELECT COUNT(*) FROM CHILD;"), 0LL);
+
+    WritePipelineMetrics metrics = pipeline.metrics();
+    CHECK_EQ(metrics.failed_commits, 1ULL);
+    CHECK_EQ(metrics.failed_mutations, 3ULL);
+
+    // The writer carries on with the next group
+    CHECK_EQ(pipeline.insertTask("again", "2026-10-20").get(), SQLITE_OK);
+    CHECK_EQ(db.countTasks(), 1LL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(write_pipeline, groups_stop_at_the_batch_size)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    WritePipelineOptions options;
+    options.max_batch_size = 4;
+    WritePipeline pipeline(db, options);
+
+    WriterGate gate(pipeline);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 10; i++) {
+        results.push_back(pipeline.insertTask("task", "2026-10-18"));
+    }
+    REQUIRE(gate.open() == SQLITE_OK);
+    for (std::future<int>& result : results) {
+        CHECK_EQ(result.get(), SQLITE_OK);
+    }
+
+    // The gate alone, then 4, 4 and 2
+    WritePipelineMetrics metrics = pipeline.metrics();
+    CHECK_EQ(metrics.batches, 4ULL);
+    CHECK_EQ(metrics.mutations, 11ULL);
+    CHECK_EQ(metrics.batch_sizes[0], 1ULL);
+    CHECK_EQ(metrics.batch_sizes[1], 1ULL);
+    CHECK_EQ(metrics.batch_sizes[2], 2ULL);
+}
+// --------------------------------------------------------------------------------
+
+TEST(write_pipeline, max_delay_holds_a_lone_mutation)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+
+    // A lone mutation waits out the delay ...
+    {
+        WritePipelineOptions options;
+        options.max_delay = std::chrono::milliseconds(50);
+        WritePipeline pipeline(db, options);
+        auto start = std::chrono::steady_clock::now();
+        CHECK_EQ(pipeline.insertTask("alone", "2026-10-18").get(), SQLITE_OK);
+        CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(50));
+
+        // ... and one arriving within it joins the same group
+        std::future<int> first = pipeline.insertTask("first", "2026-10-18");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::future<int> second = pipeline.insertTask("second", "2026-10-18");
+        CHECK_EQ(first.get(), SQLITE_OK);
+        CHECK_EQ(second.get(), SQLITE_OK);
+        CHECK_EQ(pipeline.metrics().batches, 2ULL);
+    }
+
+    // A full group does not wait for the delay to run out
+    WritePipelineOptions options;
+    options.max_delay = std::chrono::seconds(30);
+    options.max_batch_size = 2;
+    WritePipeline pipeline(db, options);
+    std::future<int> first = pipeline.insertTask("first", "2026-10-18");
+    std::future<int> second = pipeline.insertTask("second", "2026-10-18");
+    REQUIRE(second.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    CHECK_EQ(first.get(), SQLITE_OK);
+    CHECK_EQ(second.get(), SQLITE_OK);
+}
+// --------------------------------------------------------------------------------
+
+TEST(write_pipeline, metrics_add_up)
+{
+    TempDir dir;
+    DB db(dir.file("planner.db"), test_db_options());
+    REQUIRE(db.createPlanner() == SQLITE_OK);
+    WritePipeline pipeline(db);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 50; i++) {
+        results.push_back(pipeline.insertTask("task", "2026-10-18"));
+    }
+    results.push_back(pipeline.completeTask(1));
+    results.push_back(pipeline.updatePlanner(UpdateRow{"TASK", "renamed", "ID", "2"}));
+    for (std::future<int>& result : results) {
+        CHECK_EQ(result.get(), SQLITE_OK);
+    }
+
+    WritePipelineMetrics metrics = pipeline.metrics();
+    CHECK_EQ(metrics.mutations, 52ULL);
+    CHECK_EQ(metrics.failed_mutations, 0ULL);
+    CHECK(metrics.batches >= 1 && metrics.batches <= 52);
+    CHECK_EQ(bucket_total(metrics.batch_sizes), metrics.batches);
+    CHECK_EQ(bucket_total(metrics.commit_latency_us), metrics.batches);
+    CHECK(metrics.max_commit_us > 0);
+    CHECK(metrics.max_commit_us <= metrics.total_commit_us);
+    CHECK_EQ(db.countTasks(), 49LL);
+}
+// ================================================================================
+// ================================================================================
+//eof
\ No newline at end of file